@@ -0,0 +1,506 @@
+/**
+ * N-API overhead benchmarks for dsa-native
+ *
+ * Separates what a call costs at the JS/native boundary from what the C
+ * code costs. Each binding is timed at several input sizes, and a
+ * least-squares line through the medians gives its fixed cost per call
+ * and its cost per element. Raw addon calls are timed next to the promise
+ * wrappers in wrapper.ts, and per-item loops (getWindowResult,
+ * querySegmentTree) next to the bulk APIs that replace them.
+ *
+ * Usage (after `npm run build`):
+ *   npm run bench -- [--quick] [--filter TEXT] [--min-time MS] [--out FILE]
+ *
+ *   --quick        Smaller sizes and 100 ms per measurement
+ *   --filter TEXT  Only cases whose name contains TEXT
+ *   --min-time MS  Timed milliseconds per measurement (default 300)
+ *   --out FILE     JSON results (default bench-results.json)
+ *
+ * Prices are a seeded random walk generated in memory. Calls are timed in
+ * batches long enough for the clock to resolve them; p50/p99 are over
+ * batches, per call. Async variants are awaited one at a time, so they
+ * include the threadpool round trip a request handler would see.
+ */
+
+import fs from 'fs';
+import * as dsa from '../src/wrapper';
+import type { RangeStats, SegmentTreeHandle, WindowResultHandle, WindowStats } from '../src/wrapper';
+
+/**
+ * The addon entry points timed without the wrapper's promise layer
+ */
+interface RawBindings {
+  getThreadPoolSize(): number;
+  validatePrices(prices: Float64Array): number;
+  calculateStockSpan(prices: Float64Array): Int32Array;
+  calculateStockSpanAsync(prices: Float64Array): Promise<Int32Array>;
+  buildSegmentTree(prices: Float64Array): SegmentTreeHandle;
+  buildSegmentTreeAsync(prices: Float64Array): Promise<SegmentTreeHandle>;
+  querySegmentTree(handle: SegmentTreeHandle, ql: number, qr: number): RangeStats;
+  analyzeSlidingWindow(prices: Float64Array, windowSize: number): WindowResultHandle;
+  analyzeSlidingWindowAsync(prices: Float64Array, windowSize: number): Promise<WindowResultHandle>;
+  getWindowResult(handle: WindowResultHandle, idx: number): WindowStats;
+}
+
+const WINDOW_SIZE = 10;
+const QUERY_SERIES_LENGTH = 65536;
+const MIN_BATCH_NS = 500_000;  // Clock reads are ~50 ns; keep them under 0.01%
+const MIN_SAMPLES = 10;
+const MAX_SAMPLES = 2000;
+
+interface Options {
+  quick: boolean;
+  filter?: string;
+  minTimeMs: number;
+  out: string;
+}
+
+interface Timing {
+  calls: number;
+  p50Ns: number;
+  p99Ns: number;
+}
+
+interface CaseResult extends Timing {
+  case: string;
+  variant: string;
+  n: number;
+}
+
+/**
+ * One way of doing a case's work; `setup` runs untimed per size and
+ * returns the operation to time (and optionally a cleanup)
+ */
+interface Variant {
+  name: string;
+  setup(n: number): { op: () => unknown; cleanup?: () => void };
+}
+
+interface BenchCase {
+  name: string;
+  /** What n counts: prices, windows or queries */
+  unit: string;
+  sizes: number[];
+  variants: Variant[];
+}
+
+function parseOptions(argv: string[]): Options {
+  const opts: Options = { quick: false, minTimeMs: 300, out: 'bench-results.json' };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    if (arg === '--quick') {
+      opts.quick = true;
+      opts.minTimeMs = 100;
+    } else if (arg === '--filter' && i + 1 < argv.length) {
+      opts.filter = argv[++i];
+    } else if (arg === '--min-time' && i + 1 < argv.length) {
+      opts.minTimeMs = Number(argv[++i]);
+      if (!(opts.minTimeMs > 0)) throw new Error(`Invalid --min-time: ${argv[i]}`);
+    } else if (arg === '--out' && i + 1 < argv.length) {
+      opts.out = argv[++i];
+    } else {
+      throw new Error(`Unknown option or missing value: ${arg}`);
+    }
+  }
+  return opts;
+}
+
+/**
+ * Random walk from 100 with +-1% daily moves (mulberry32, fixed seed)
+ */
+function generatePrices(n: number): Float64Array {
+  let state = 0x9e3779b9;
+  const next = () => {
+    state = (state + 0x6d2b79f5) | 0;
+    let t = Math.imul(state ^ (state >>> 15), 1 | state);
+    t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+
+  const prices = new Float64Array(n);
+  let price = 100;
+  for (let i = 0; i < n; i++) {
+    price = Math.max(1, price * (1 + (next() - 0.5) * 0.02));
+    prices[i] = price;
+  }
+  return prices;
+}
+
+function percentile(sorted: number[], pct: number): number {
+  const rank = Math.ceil((pct / 100) * sorted.length);
+  return sorted[Math.min(sorted.length, Math.max(1, rank)) - 1];
+}
+
+// Keeps results reachable so no call is optimized away
+let sink: unknown;
+
+/**
+ * Time `op` per call; awaits it when it returns a promise
+ */
+async function measure(op: () => unknown, minTimeMs: number): Promise<Timing> {
+  const runBatch = async (calls: number): Promise<number> => {
+    const start = process.hrtime.bigint();
+    for (let i = 0; i < calls; i++) {
+      const result = op();
+      sink = result instanceof Promise ? await result : result;
+    }
+    return Number(process.hrtime.bigint() - start);
+  };
+
+  // Warm up, then grow the batch until it is long enough to time
+  await runBatch(MIN_SAMPLES);
+  let batch = 1;
+  for (let ns = await runBatch(batch); ns < MIN_BATCH_NS && batch < 1 << 24; ) {
+    batch *= ns > 0 ? Math.min(16, Math.ceil(MIN_BATCH_NS / ns)) : 16;
+    ns = await runBatch(batch);
+  }
+
+  const samples: number[] = [];
+  let total = 0;
+  while (samples.length < MAX_SAMPLES && (samples.length < MIN_SAMPLES || total < minTimeMs * 1e6)) {
+    const ns = await runBatch(batch);
+    samples.push(ns / batch);
+    total += ns;
+  }
+
+  samples.sort((a, b) => a - b);
+  return { calls: samples.length * batch, p50Ns: percentile(samples, 50), p99Ns: percentile(samples, 99) };
+}
+
+/**
+ * Least-squares fit of p50 = fixed + perElement * n
+ */
+function fitLine(points: CaseResult[]): { fixedNs: number; perElementNs: number } {
+  const count = points.length;
+  const meanN = points.reduce((sum, p) => sum + p.n, 0) / count;
+  const meanT = points.reduce((sum, p) => sum + p.p50Ns, 0) / count;
+  let covariance = 0;
+  let variance = 0;
+  for (const p of points) {
+    covariance += (p.n - meanN) * (p.p50Ns - meanT);
+    variance += (p.n - meanN) ** 2;
+  }
+  const perElementNs = variance > 0 ? covariance / variance : 0;
+  return { fixedNs: meanT - perElementNs * meanN, perElementNs };
+}
+
+function buildCases(native: RawBindings, quick: boolean): BenchCase[] {
+  const priceSizes = quick ? [16, 1024, 16384] : [16, 1024, 16384, 262144];
+  const querySizes = quick ? [16, 256, 4096] : [16, 256, 4096, 65536];
+
+  // Prices with exactly n windows of WINDOW_SIZE
+  const windowPrices = (n: number) => generatePrices(n + WINDOW_SIZE - 1);
+
+  const ranges = (q: number) => {
+    const flat = new Uint32Array(q * 2);
+    for (let i = 0; i < q; i++) {
+      const ql = (i * 7919) % (QUERY_SERIES_LENGTH - 250);
+      flat[2 * i] = ql;
+      flat[2 * i + 1] = ql + 249;
+    }
+    return flat;
+  };
+
+  return [
+    {
+      name: 'napi_floor',
+      unit: 'call',
+      sizes: [0],
+      variants: [{ name: 'raw_sync', setup: () => ({ op: () => native.getThreadPoolSize() }) }],
+    },
+    {
+      name: 'validate',
+      unit: 'price',
+      sizes: priceSizes,
+      variants: [
+        {
+          name: 'raw_sync',
+          setup: n => {
+            const prices = generatePrices(n);
+            return { op: () => native.validatePrices(prices) };
+          },
+        },
+      ],
+    },
+    {
+      name: 'span',
+      unit: 'price',
+      sizes: priceSizes,
+      variants: [
+        {
+          name: 'raw_sync',
+          setup: n => {
+            const prices = generatePrices(n);
+            return { op: () => native.calculateStockSpan(prices) };
+          },
+        },
+        {
+          name: 'raw_async',
+          setup: n => {
+            const prices = generatePrices(n);
+            return { op: () => native.calculateStockSpanAsync(prices) };
+          },
+        },
+        {
+          name: 'wrapper',
+          setup: n => {
+            const prices = generatePrices(n);
+            return { op: () => dsa.calculateStockSpan(prices) };
+          },
+        },
+      ],
+    },
+    {
+      name: 'tree_build',
+      unit: 'price',
+      sizes: priceSizes,
+      variants: [
+        {
+          name: 'raw_sync',
+          setup: n => {
+            const prices = generatePrices(n);
+            return { op: () => native.buildSegmentTree(prices).free() };
+          },
+        },
+        {
+          name: 'raw_async',
+          setup: n => {
+            const prices = generatePrices(n);
+            return { op: () => native.buildSegmentTreeAsync(prices).then(tree => tree.free()) };
+          },
+        },
+        {
+          name: 'wrapper',
+          setup: n => {
+            const prices = generatePrices(n);
+            return {
+              op: () => dsa.buildSegmentTree(prices).then(tree => dsa.freeSegmentTree(tree)),
+            };
+          },
+        },
+      ],
+    },
+    {
+      name: 'window',
+      unit: 'window',
+      sizes: priceSizes,
+      variants: [
+        {
+          name: 'raw_sync',
+          setup: n => {
+            const prices = windowPrices(n);
+            return { op: () => native.analyzeSlidingWindow(prices, WINDOW_SIZE).free() };
+          },
+        },
+        {
+          name: 'raw_async',
+          setup: n => {
+            const prices = windowPrices(n);
+            return {
+              op: () => native.analyzeSlidingWindowAsync(prices, WINDOW_SIZE).then(h => h.free()),
+            };
+          },
+        },
+        {
+          name: 'wrapper',
+          setup: n => {
+            const prices = windowPrices(n);
+            return {
+              op: () =>
+                dsa.analyzeSlidingWindow(prices, WINDOW_SIZE).then(h => dsa.freeWindowResult(h)),
+            };
+          },
+        },
+      ],
+    },
+    {
+      // Prices in, every window readable from JS out
+      name: 'window_all',
+      unit: 'window',
+      sizes: priceSizes,
+      variants: [
+        {
+          name: 'wrapper_get_loop',
+          setup: n => {
+            const prices = windowPrices(n);
+            return {
+              op: async () => {
+                const handle = await dsa.analyzeSlidingWindow(prices, WINDOW_SIZE);
+                let last: WindowStats | undefined;
+                for (let i = 0; i < handle.count; i++) last = await dsa.getWindowResult(handle, i);
+                await dsa.freeWindowResult(handle);
+                return last;
+              },
+            };
+          },
+        },
+        {
+          name: 'raw_get_loop',
+          setup: n => {
+            const prices = windowPrices(n);
+            return {
+              op: async () => {
+                const handle = await native.analyzeSlidingWindowAsync(prices, WINDOW_SIZE);
+                let last: WindowStats | undefined;
+                for (let i = 0; i < handle.count; i++) last = native.getWindowResult(handle, i);
+                handle.free();
+                return last;
+              },
+            };
+          },
+        },
+        {
+          name: 'serialize_json',
+          setup: n => {
+            const prices = windowPrices(n);
+            return {
+              op: () =>
+                dsa.withSlidingWindow(prices, WINDOW_SIZE, handle =>
+                  dsa.serializeWindowResult(handle, 'json')
+                ),
+            };
+          },
+        },
+        {
+          name: 'batch_columnar',
+          setup: n => {
+            const prices = windowPrices(n);
+            return { op: () => dsa.analyzeBatch([{ prices, windowSize: WINDOW_SIZE }]) };
+          },
+        },
+      ],
+    },
+    {
+      // n range queries over one prebuilt series
+      name: 'range_queries',
+      unit: 'query',
+      sizes: querySizes,
+      variants: [
+        {
+          name: 'wrapper_query_loop',
+          setup: q => {
+            const tree = native.buildSegmentTree(generatePrices(QUERY_SERIES_LENGTH));
+            const flat = ranges(q);
+            return {
+              op: async () => {
+                let last: RangeStats | undefined;
+                for (let i = 0; i < q; i++) {
+                  last = await dsa.querySegmentTree(tree, flat[2 * i], flat[2 * i + 1]);
+                }
+                return last;
+              },
+              cleanup: () => tree.free(),
+            };
+          },
+        },
+        {
+          name: 'raw_query_loop',
+          setup: q => {
+            const tree = native.buildSegmentTree(generatePrices(QUERY_SERIES_LENGTH));
+            const flat = ranges(q);
+            return {
+              op: () => {
+                let last: RangeStats | undefined;
+                for (let i = 0; i < q; i++) {
+                  last = native.querySegmentTree(tree, flat[2 * i], flat[2 * i + 1]);
+                }
+                return last;
+              },
+              cleanup: () => tree.free(),
+            };
+          },
+        },
+        {
+          // Builds its own tree per call, so its fixed cost includes the build
+          name: 'batch_ranges',
+          setup: q => {
+            const prices = generatePrices(QUERY_SERIES_LENGTH);
+            const flat = ranges(q);
+            return { op: () => dsa.analyzeBatch([{ prices, ranges: flat }]) };
+          },
+        },
+      ],
+    },
+  ];
+}
+
+const format = (ns: number) =>
+  ns >= 1e6 ? `${(ns / 1e6).toFixed(2)}ms` : ns >= 1e3 ? `${(ns / 1e3).toFixed(2)}us` : `${ns.toFixed(0)}ns`;
+
+async function main(): Promise<void> {
+  const opts = parseOptions(process.argv.slice(2));
+
+  // The same module instance wrapper.ts loads
+  // eslint-disable-next-line @typescript-eslint/no-var-requires
+  const native = require('../../build/Release/dsa_native.node') as RawBindings;
+  const gc = (globalThis as { gc?: () => void }).gc;
+
+  const cases = buildCases(native, opts.quick).filter(
+    c => !opts.filter || c.name.includes(opts.filter)
+  );
+  const { isa } = dsa.getNativeDiagnostics();
+  console.log(`dsa-native overhead benchmarks (node ${process.version}, N-API ${process.versions.napi}, ${isa})`);
+  console.log(`${'case'.padEnd(14)} ${'variant'.padEnd(20)} ${'n'.padStart(8)} ${'p50'.padStart(10)} ${'p99'.padStart(10)} ${'per item'.padStart(10)} ${'vs first'.padStart(9)}`);
+
+  const results: CaseResult[] = [];
+  const fits: Array<{ case: string; variant: string; unit: string; fixedNs: number; perElementNs: number }> = [];
+
+  for (const benchCase of cases) {
+    const firstAt = new Map<number, number>();
+
+    for (const variant of benchCase.variants) {
+      const points: CaseResult[] = [];
+      for (const n of benchCase.sizes) {
+        gc?.();
+        const { op, cleanup } = variant.setup(n);
+        let timing: Timing;
+        try {
+          timing = await measure(op, opts.minTimeMs);
+        } finally {
+          cleanup?.();
+        }
+
+        const result = { case: benchCase.name, variant: variant.name, n, ...timing };
+        points.push(result);
+        results.push(result);
+
+        if (!firstAt.has(n)) firstAt.set(n, timing.p50Ns);
+        const relative = timing.p50Ns / (firstAt.get(n) ?? timing.p50Ns);
+        console.log(
+          `${benchCase.name.padEnd(14)} ${variant.name.padEnd(20)} ${String(n).padStart(8)} ` +
+            `${format(timing.p50Ns).padStart(10)} ${format(timing.p99Ns).padStart(10)} ` +
+            `${format(n > 0 ? timing.p50Ns / n : timing.p50Ns).padStart(10)} ${relative.toFixed(2).padStart(8)}x`
+        );
+      }
+
+      if (points.length > 1) {
+        fits.push({ case: benchCase.name, variant: variant.name, unit: benchCase.unit, ...fitLine(points) });
+      }
+    }
+  }
+
+  console.log(`\n${'case'.padEnd(14)} ${'variant'.padEnd(20)} ${'fixed/call'.padStart(12)} ${'per item'.padStart(12)}`);
+  for (const fit of fits) {
+    console.log(
+      `${fit.case.padEnd(14)} ${fit.variant.padEnd(20)} ${format(Math.max(0, fit.fixedNs)).padStart(12)} ` +
+        `${`${fit.perElementNs.toFixed(2)}ns/${fit.unit}`.padStart(12)}`
+    );
+  }
+
+  const report = {
+    node: process.version,
+    napi: process.versions.napi,
+    isa,
+    threadPoolSize: native.getThreadPoolSize(),
+    minTimeMs: opts.minTimeMs,
+    results,
+    fits,
+  };
+  fs.writeFileSync(opts.out, JSON.stringify(report, null, 2) + '\n');
+  console.log(`\nWrote ${opts.out}`);
+}
+
+main().catch(err => {
+  console.error((err as Error).message);
+  process.exit(1);
+});
@@ -3,14 +3,23 @@
     {
       "target_name": "dsa_native",
       "sources": [
-        "src/native_binding.cpp"
+        "src/native_binding.cpp",
+        "src/batch_analysis.cpp",
+        "src/chart_parser.cpp",
+        "src/column_store.cpp",
+        "src/series_registry.cpp",
+        "src/stats.cpp",
+        "src/thread_pool.cpp",
+        "src/tree_cache.cpp",
+        "src/window_json.cpp"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
         "../../c_modules/include"
       ],
       "defines": [
-        "NAPI_DISABLE_CPP_EXCEPTIONS"
+        "NAPI_DISABLE_CPP_EXCEPTIONS",
+        "NAPI_VERSION=8"
       ],
       "cflags!": ["-fno-exceptions"],
       "cflags_cc!": ["-fno-exceptions"],
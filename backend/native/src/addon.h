@@ -0,0 +1,91 @@
+/**
+ * Shared helpers for the dsa_native addon translation units
+ */
+
+#ifndef DSA_ADDON_H
+#define DSA_ADDON_H
+
+#include <napi.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// Error buffer size for C function calls
+#define ERR_BUF_SIZE 512
+
+/**
+ * Helper: Format C error code and message for JS
+ */
+inline std::string FormatCError(int errorCode, const char* errorMsg) {
+  return "C Module Error (code " + std::to_string(errorCode) + "): " + errorMsg;
+}
+
+/**
+ * Helper: Convert C error to JS exception
+ */
+inline void ThrowCError(Napi::Env env, int errorCode, const char* errorMsg) {
+  Napi::Error::New(env, FormatCError(errorCode, errorMsg)).ThrowAsJavaScriptException();
+}
+
+/**
+ * Helper: Hand a malloc'ed C result to JS as a typed array without copying
+ *
+ * The returned array's ArrayBuffer wraps `data` directly and free()s it when
+ * garbage collected, so callers must not free `data` after this returns.
+ * Runtimes that forbid external buffers fall back to a copy.
+ */
+template <typename T>
+inline Napi::TypedArrayOf<T> WrapNativeArray(Napi::Env env, T* data, size_t length) {
+#ifdef NODE_API_NO_EXTERNAL_BUFFERS_ALLOWED
+  Napi::TypedArrayOf<T> outputArray = Napi::TypedArrayOf<T>::New(env, length);
+  std::memcpy(outputArray.Data(), data, length * sizeof(T));
+  free(data);
+  return outputArray;
+#else
+  Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(
+      env, data, length * sizeof(T),
+      [](Napi::Env /*env*/, void* finalizeData) { free(finalizeData); });
+  return Napi::TypedArrayOf<T>::New(env, length, buffer, 0);
+#endif
+}
+
+/**
+ * Helper: Hand a malloc'ed byte buffer to JS as a Buffer without copying
+ *
+ * Same ownership rules and fallback as WrapNativeArray.
+ */
+inline Napi::Buffer<char> WrapNativeBuffer(Napi::Env env, char* data, size_t length) {
+#ifdef NODE_API_NO_EXTERNAL_BUFFERS_ALLOWED
+  Napi::Buffer<char> buffer = Napi::Buffer<char>::Copy(env, data, length);
+  free(data);
+  return buffer;
+#else
+  return Napi::Buffer<char>::New(
+      env, data, length, [](Napi::Env /*env*/, char* finalizeData) { free(finalizeData); });
+#endif
+}
+
+static_assert(sizeof(int) == sizeof(int32_t), "spans are exposed to JS as Int32Array");
+
+/**
+ * Register analyzeBatch / CancelToken / thread pool exports (batch_analysis.cpp)
+ */
+void InitBatchAnalysis(Napi::Env env, Napi::Object exports);
+
+/**
+ * Register the ColumnStore class export (column_store.cpp)
+ */
+void InitColumnStore(Napi::Env env, Napi::Object exports);
+
+/**
+ * Register the parseChartColumns export (chart_parser.cpp)
+ */
+void InitChartParser(Napi::Env env, Napi::Object exports);
+
+/**
+ * Register getNativeStats / setNativeStatsEnabled / resetNativeStats (stats.cpp)
+ */
+void InitStats(Napi::Env env, Napi::Object exports);
+
+#endif  // DSA_ADDON_H
@@ -0,0 +1,116 @@
+/**
+ * Worker entry for NativeWorkerPool (workerPool.ts)
+ *
+ * Runs one task per message against this thread's instance of the native
+ * module and posts the result back. Not meant to be imported.
+ */
+
+import { parentPort } from 'worker_threads';
+import {
+  calculateStockSpan,
+  querySegmentTree,
+  serializeWindowResult,
+  analyzeSeries,
+  analyzeBatch,
+  withSegmentTree,
+  withSlidingWindow,
+} from './wrapper';
+import type { WorkerRequest, WorkerResponse, WorkerTask } from './workerPool';
+
+async function runTask(task: WorkerTask, signal: AbortSignal): Promise<unknown> {
+  switch (task.op) {
+    case 'span':
+      return calculateStockSpan(task.prices);
+    case 'range':
+      return withSegmentTree(task.prices, (tree) => querySegmentTree(tree, task.ql, task.qr));
+    case 'window':
+      return withSlidingWindow(task.prices, task.windowSize, async (handle) => {
+        const buf = await serializeWindowResult(handle, task.format);
+        return new Uint8Array(buf.buffer, buf.byteOffset, buf.byteLength);
+      });
+    case 'series':
+      return analyzeSeries(task.prices, task.options);
+    case 'batch':
+      return analyzeBatch(task.jobs, { signal });
+    default:
+      throw new Error(`Unknown worker task: ${(task as { op: string }).op}`);
+  }
+}
+
+// Typed arrays anywhere in a result, however deep (BatchResult columns sit
+// inside per-job objects). Views on shared memory are left to be shared.
+function collectViews(value: unknown, views: ArrayBufferView[]): ArrayBufferView[] {
+  if (ArrayBuffer.isView(value)) {
+    if (value.buffer instanceof ArrayBuffer) views.push(value);
+  } else if (value !== null && typeof value === 'object') {
+    for (const member of Object.values(value)) collectViews(member, views);
+  }
+  return views;
+}
+
+function transferList(views: ArrayBufferView[]): ArrayBuffer[] {
+  return [...new Set(views.map(view => view.buffer as ArrayBuffer))];
+}
+
+// The result with every typed array copied into a buffer of its own, which
+// the runtime can always detach. Buffers become plain Uint8Arrays.
+function adopt(value: unknown): unknown {
+  if (ArrayBuffer.isView(value)) {
+    if (!(value.buffer instanceof ArrayBuffer)) return value;
+    if (value instanceof DataView || value instanceof Buffer) {
+      return new Uint8Array(new Uint8Array(value.buffer, value.byteOffset, value.byteLength));
+    }
+    const View = value.constructor as new (source: ArrayBufferView) => ArrayBufferView;
+    return new View(value);
+  }
+  if (Array.isArray(value)) return value.map(adopt);
+  if (value !== null && typeof value === 'object') {
+    return Object.fromEntries(Object.entries(value).map(([key, member]) => [key, adopt(member)]));
+  }
+  return value;
+}
+
+function reply(response: WorkerResponse): void {
+  const port = parentPort!;
+  if (!response.ok) {
+    port.postMessage(response);
+    return;
+  }
+
+  const views = collectViews(response.result, []);
+  try {
+    port.postMessage(response, transferList(views));
+  } catch (err) {
+    // Addon-owned buffers (and pooled Buffer slabs) refuse to detach; the
+    // runtime checks the transfer list before serializing anything, so copy
+    // each array once here and move the copies
+    if ((err as Error).name !== 'DataCloneError' || views.length === 0) throw err;
+    const result = adopt(response.result);
+    port.postMessage({ ...response, result }, transferList(collectViews(result, [])));
+  }
+}
+
+if (!parentPort) {
+  throw new Error('analysisWorker must be started by NativeWorkerPool');
+}
+
+// Running tasks by request id, for cancellation
+const running = new Map<number, AbortController>();
+
+parentPort.on('message', async (request: WorkerRequest) => {
+  if ('cancel' in request) {
+    running.get(request.id)?.abort();
+    return;
+  }
+
+  const { id, task } = request;
+  const controller = new AbortController();
+  running.set(id, controller);
+  try {
+    reply({ id, ok: true, result: await runTask(task, controller.signal) });
+  } catch (err) {
+    reply({ id, ok: false, error: (err as Error).message });
+  } finally {
+    running.delete(id);
+  }
+});
@@ -0,0 +1,474 @@
+/**
+ * Batch analysis bindings
+ *
+ * analyzeBatch(jobs) runs span, stats, range and window jobs for many price
+ * series on the shared work-stealing pool (thread_pool.h) and resolves a
+ * single promise with columnar results, one entry per job. A failing job
+ * reports its own `error` without failing the rest of the batch.
+ *
+ * Spans, whole-series stats and windows come from one fused analyzeSeries()
+ * pass; only arbitrary ranges need a segment tree.
+ *
+ * A batch may be given a CancelToken: once cancelled, jobs that have not
+ * started yet are skipped and report `error: "Cancelled"`, and a job's range
+ * queries stop between queries. A C call already running is not
+ * interrupted, so cancellation takes effect within one fused series pass
+ * or one tree build.
+ */
+
+#include "addon.h"
+#include "thread_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+extern "C" {
+  #include "stock_span.h"
+  #include "segment_tree.h"
+  #include "series_analysis.h"
+}
+
+template <typename T>
+static T* AllocArray(size_t count) {
+  return static_cast<T*>(malloc(count * sizeof(T)));
+}
+
+/**
+ * One series: job description plus its native results
+ *
+ * Output arrays are malloc'ed on a pool thread and handed to JS without
+ * copying in OnOK(); whatever is still owned here is freed on destruction.
+ */
+struct BatchJob {
+  // Inputs (read-only once queued)
+  const double* prices = nullptr;
+  size_t length = 0;
+  bool span = false;
+  bool stats = false;
+  std::vector<uint32_t> ranges;  // Flattened [ql0, qr0, ql1, qr1, ...]
+  size_t windowSize = 0;
+
+  // Outputs
+  int* spans = nullptr;
+  SeriesStats seriesStats = {0, 0, 0, 0};
+  double* rangeMin = nullptr;
+  double* rangeMax = nullptr;
+  double* rangeAvg = nullptr;
+  double* rangeVariance = nullptr;
+  size_t numWindows = 0;
+  double* windowMax = nullptr;
+  double* windowMin = nullptr;
+  double* windowAvg = nullptr;
+  unsigned char* windowPattern = nullptr;
+  std::string error;
+  double computeTimeMs = 0;
+
+  size_t NumRanges() const { return ranges.size() / 2; }
+
+  ~BatchJob() {
+    free(spans);
+    free(rangeMin);
+    free(rangeMax);
+    free(rangeAvg);
+    free(rangeVariance);
+    free(windowMax);
+    free(windowMin);
+    free(windowAvg);
+    free(windowPattern);
+  }
+};
+
+/**
+ * Spans, whole-series stats and windows in one fused pass
+ */
+static bool RunSeries(BatchJob& job, char* errBuf) {
+  if (job.span) {
+    job.spans = AllocArray<int>(job.length);
+    if (!job.spans) {
+      job.error = FormatCError(-3, "Memory allocation failed for spans array");
+      return false;
+    }
+  }
+
+  if (job.windowSize > 0 && job.windowSize <= job.length) {
+    job.numWindows = job.length - job.windowSize + 1;
+    job.windowMax = AllocArray<double>(job.numWindows);
+    job.windowMin = AllocArray<double>(job.numWindows);
+    job.windowAvg = AllocArray<double>(job.numWindows);
+    job.windowPattern = AllocArray<unsigned char>(job.numWindows);
+    if (!job.windowMax || !job.windowMin || !job.windowAvg || !job.windowPattern) {
+      job.error = FormatCError(-3, "Memory allocation failed for window results");
+      return false;
+    }
+  }
+
+  int result = analyzeSeries(job.prices, job.length, job.windowSize, job.spans,
+                             job.stats ? &job.seriesStats : nullptr,
+                             job.windowMax, job.windowMin, job.windowAvg, job.windowPattern,
+                             errBuf, ERR_BUF_SIZE);
+  if (result != 0) {
+    job.error = FormatCError(result, errBuf);
+    return false;
+  }
+  return true;
+}
+
+using CancelFlag = std::shared_ptr<std::atomic<bool>>;
+
+static const char* const kCancelledError = "Cancelled";
+
+static bool IsCancelled(const std::atomic<bool>* cancelled) {
+  return cancelled && cancelled->load(std::memory_order_relaxed);
+}
+
+static bool RunRanges(BatchJob& job, const std::atomic<bool>* cancelled, char* errBuf) {
+  size_t numRanges = job.NumRanges();
+  job.rangeMin = AllocArray<double>(numRanges);
+  job.rangeMax = AllocArray<double>(numRanges);
+  job.rangeAvg = AllocArray<double>(numRanges);
+  job.rangeVariance = AllocArray<double>(numRanges);
+  if (!job.rangeMin || !job.rangeMax || !job.rangeAvg || !job.rangeVariance) {
+    job.error = FormatCError(-3, "Memory allocation failed for range results");
+    return false;
+  }
+
+  void* tree = nullptr;
+  int result = buildSegmentTree(job.prices, job.length, &tree, errBuf, ERR_BUF_SIZE);
+  if (result != 0) {
+    job.error = FormatCError(result, errBuf);
+    return false;
+  }
+
+  bool stopped = false;
+  for (size_t i = 0; i < numRanges && result == 0; i++) {
+    if (IsCancelled(cancelled)) {
+      stopped = true;
+      break;
+    }
+    result = querySegmentTree(tree, job.ranges[2 * i], job.ranges[2 * i + 1],
+                              &job.rangeMin[i], &job.rangeMax[i], &job.rangeAvg[i],
+                              &job.rangeVariance[i], errBuf, ERR_BUF_SIZE);
+  }
+  freeSegmentTree(tree);
+
+  if (stopped) {
+    job.error = kCancelledError;
+    return false;
+  }
+  if (result != 0) {
+    job.error = FormatCError(result, errBuf);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Execute one job on a pool thread, unless the batch was cancelled first
+ */
+static void RunJob(BatchJob& job, const std::atomic<bool>* cancelled) {
+  auto start = std::chrono::steady_clock::now();
+  char errBuf[ERR_BUF_SIZE] = {0};
+
+  if (IsCancelled(cancelled)) {
+    job.error = kCancelledError;
+    return;
+  }
+
+  bool fused = job.span || job.stats || job.windowSize > 0;
+  bool ok = !fused || RunSeries(job, errBuf);
+  if (ok && !job.ranges.empty()) {
+    if (IsCancelled(cancelled)) {
+      job.error = kCancelledError;
+    } else {
+      RunRanges(job, cancelled, errBuf);
+    }
+  }
+
+  job.computeTimeMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Async worker: analyzeBatch
+ * Resolves: Array<BatchResult>
+ *
+ * Execute() blocks one libuv thread while the pool (plus that thread) works
+ * through the jobs, so a batch costs a single threadpool slot.
+ */
+class BatchWorker : public Napi::AsyncWorker {
+ public:
+  BatchWorker(Napi::Env env, CancelFlag cancelled)
+      : Napi::AsyncWorker(env, "dsa:analyzeBatch"),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        cancelled_(std::move(cancelled)) {}
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+  void AddJob(std::unique_ptr<BatchJob> job, Napi::Value input) {
+    jobs_.push_back(std::move(job));
+    inputRefs_.push_back(Napi::Persistent(input.As<Napi::Object>()));
+  }
+
+ protected:
+  void Execute() override {
+    std::vector<WorkStealingPool::Task> tasks;
+    tasks.reserve(jobs_.size());
+    const std::atomic<bool>* cancelled = cancelled_.get();
+    for (std::unique_ptr<BatchJob>& job : jobs_) {
+      BatchJob* target = job.get();
+      tasks.emplace_back([target, cancelled] { RunJob(*target, cancelled); });
+    }
+    WorkStealingPool::Shared()->RunAll(tasks);
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::HandleScope scope(env);
+
+    Napi::Array results = Napi::Array::New(env, jobs_.size());
+    for (size_t i = 0; i < jobs_.size(); i++) {
+      results.Set(static_cast<uint32_t>(i), BuildResult(env, *jobs_[i]));
+    }
+    deferred_.Resolve(results);
+  }
+
+  void OnError(const Napi::Error& error) override {
+    deferred_.Reject(error.Value());
+  }
+
+ private:
+  // Moves the job's native arrays into JS typed arrays (zero-copy)
+  static Napi::Object BuildResult(Napi::Env env, BatchJob& job) {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("computeTimeMs", Napi::Number::New(env, job.computeTimeMs));
+
+    if (!job.error.empty()) {
+      result.Set("error", Napi::String::New(env, job.error));
+      return result;
+    }
+
+    if (job.spans) {
+      result.Set("spans", WrapNativeArray(env, reinterpret_cast<int32_t*>(job.spans), job.length));
+      job.spans = nullptr;
+    }
+
+    if (job.stats) {
+      Napi::Object stats = Napi::Object::New(env);
+      stats.Set("min", Napi::Number::New(env, job.seriesStats.min));
+      stats.Set("max", Napi::Number::New(env, job.seriesStats.max));
+      stats.Set("avg", Napi::Number::New(env, job.seriesStats.avg));
+      stats.Set("variance", Napi::Number::New(env, job.seriesStats.variance));
+      result.Set("stats", stats);
+    }
+
+    if (!job.ranges.empty()) {
+      size_t numRanges = job.NumRanges();
+      Napi::Object ranges = Napi::Object::New(env);
+      ranges.Set("min", WrapNativeArray(env, job.rangeMin, numRanges));
+      ranges.Set("max", WrapNativeArray(env, job.rangeMax, numRanges));
+      ranges.Set("avg", WrapNativeArray(env, job.rangeAvg, numRanges));
+      ranges.Set("variance", WrapNativeArray(env, job.rangeVariance, numRanges));
+      job.rangeMin = job.rangeMax = job.rangeAvg = job.rangeVariance = nullptr;
+      result.Set("ranges", ranges);
+    }
+
+    if (job.windowSize > 0) {
+      Napi::Object windows = Napi::Object::New(env);
+      windows.Set("max", WrapNativeArray(env, job.windowMax, job.numWindows));
+      windows.Set("min", WrapNativeArray(env, job.windowMin, job.numWindows));
+      windows.Set("avg", WrapNativeArray(env, job.windowAvg, job.numWindows));
+      windows.Set("pattern", WrapNativeArray(env, reinterpret_cast<uint8_t*>(job.windowPattern),
+                                             job.numWindows));
+      job.windowMax = job.windowMin = job.windowAvg = nullptr;
+      job.windowPattern = nullptr;
+      result.Set("windows", windows);
+    }
+
+    return result;
+  }
+
+  Napi::Promise::Deferred deferred_;
+  std::vector<std::unique_ptr<BatchJob>> jobs_;
+  std::vector<Napi::ObjectReference> inputRefs_;
+  CancelFlag cancelled_;  // Shared with the CancelToken; may be null
+};
+
+// Type tag lets analyzeBatch reject arbitrary objects passed as a token
+static const napi_type_tag kCancelTokenTypeTag = {0x5b8e2d47c1f9a063ULL, 0xe4a7039d6b2c81f5ULL};
+
+/**
+ * JS class: CancelToken
+ *
+ * A flag shared with every batch it is passed to. cancel() is one-way and
+ * only sets the flag; the batches notice it before each job.
+ */
+class CancelTokenWrap : public Napi::ObjectWrap<CancelTokenWrap> {
+ public:
+  static Napi::Function Init(Napi::Env env);
+
+  explicit CancelTokenWrap(const Napi::CallbackInfo& info);
+
+  /**
+   * Flag of a CancelToken argument; null (with a pending JS exception) if
+   * the value is something else
+   */
+  static CancelFlag FlagFromValue(Napi::Env env, const Napi::Value& value);
+
+ private:
+  Napi::Value Cancel(const Napi::CallbackInfo& info);
+  Napi::Value GetCancelled(const Napi::CallbackInfo& info);
+
+  CancelFlag flag_ = std::make_shared<std::atomic<bool>>(false);
+};
+
+Napi::Function CancelTokenWrap::Init(Napi::Env env) {
+  return DefineClass(env, "CancelToken", {
+    InstanceMethod("cancel", &CancelTokenWrap::Cancel),
+    InstanceAccessor("cancelled", &CancelTokenWrap::GetCancelled, nullptr),
+  });
+}
+
+CancelTokenWrap::CancelTokenWrap(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<CancelTokenWrap>(info) {
+  info.This().As<Napi::Object>().TypeTag(&kCancelTokenTypeTag);
+}
+
+CancelFlag CancelTokenWrap::FlagFromValue(Napi::Env env, const Napi::Value& value) {
+  if (!value.IsObject() || !value.As<Napi::Object>().CheckTypeTag(&kCancelTokenTypeTag)) {
+    Napi::TypeError::New(env, "Expected CancelToken as second argument")
+        .ThrowAsJavaScriptException();
+    return nullptr;
+  }
+  return Unwrap(value.As<Napi::Object>())->flag_;
+}
+
+/**
+ * Method: cancel
+ * Output: undefined (idempotent)
+ */
+Napi::Value CancelTokenWrap::Cancel(const Napi::CallbackInfo& info) {
+  flag_->store(true, std::memory_order_relaxed);
+  return info.Env().Undefined();
+}
+
+Napi::Value CancelTokenWrap::GetCancelled(const Napi::CallbackInfo& info) {
+  return Napi::Boolean::New(info.Env(), flag_->load(std::memory_order_relaxed));
+}
+
+/**
+ * Helper: Throw a TypeError naming the offending job field
+ */
+static Napi::Value ThrowJobError(Napi::Env env, uint32_t idx, const char* message) {
+  std::string fullMsg = "jobs[" + std::to_string(idx) + "]" + message;
+  Napi::TypeError::New(env, fullMsg).ThrowAsJavaScriptException();
+  return env.Null();
+}
+
+/**
+ * Wrapper: analyzeBatch
+ * Input: Array<{prices: Float64Array, span?: boolean, stats?: boolean,
+ *               ranges?: Uint32Array, windowSize?: number}>,
+ *        optional CancelToken
+ * Output: Promise<Array<{computeTimeMs, error?, spans?, stats?, ranges?, windows?}>>
+ */
+static Napi::Value AnalyzeBatch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected array of batch jobs").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  CancelFlag cancelled;
+  if (info.Length() > 1 && !info[1].IsUndefined()) {
+    cancelled = CancelTokenWrap::FlagFromValue(env, info[1]);
+    if (!cancelled) return env.Null();
+  }
+
+  Napi::Array jobsArray = info[0].As<Napi::Array>();
+  std::unique_ptr<BatchWorker> worker(new BatchWorker(env, std::move(cancelled)));
+
+  for (uint32_t i = 0; i < jobsArray.Length(); i++) {
+    Napi::Value jobValue = jobsArray.Get(i);
+    if (!jobValue.IsObject()) {
+      return ThrowJobError(env, i, " must be an object");
+    }
+    Napi::Object jobObj = jobValue.As<Napi::Object>();
+    std::unique_ptr<BatchJob> job(new BatchJob());
+
+    Napi::Value pricesValue = jobObj.Get("prices");
+    if (!pricesValue.IsTypedArray() ||
+        pricesValue.As<Napi::TypedArray>().TypedArrayType() != napi_float64_array ||
+        pricesValue.As<Napi::TypedArray>().ElementLength() == 0) {
+      return ThrowJobError(env, i, ".prices must be a non-empty Float64Array");
+    }
+    Napi::Float64Array prices = pricesValue.As<Napi::Float64Array>();
+    job->prices = prices.Data();
+    job->length = prices.ElementLength();
+
+    Napi::Value spanValue = jobObj.Get("span");
+    job->span = spanValue.IsBoolean() && spanValue.As<Napi::Boolean>().Value();
+
+    Napi::Value statsValue = jobObj.Get("stats");
+    job->stats = statsValue.IsBoolean() && statsValue.As<Napi::Boolean>().Value();
+
+    Napi::Value rangesValue = jobObj.Get("ranges");
+    if (!rangesValue.IsUndefined()) {
+      if (!rangesValue.IsTypedArray() ||
+          rangesValue.As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array ||
+          rangesValue.As<Napi::TypedArray>().ElementLength() % 2 != 0) {
+        return ThrowJobError(env, i, ".ranges must be a Uint32Array of [ql, qr] pairs");
+      }
+      Napi::Uint32Array ranges = rangesValue.As<Napi::Uint32Array>();
+      job->ranges.assign(ranges.Data(), ranges.Data() + ranges.ElementLength());
+    }
+
+    Napi::Value windowValue = jobObj.Get("windowSize");
+    if (!windowValue.IsUndefined()) {
+      if (!windowValue.IsNumber() || windowValue.As<Napi::Number>().Uint32Value() == 0) {
+        return ThrowJobError(env, i, ".windowSize must be a positive number");
+      }
+      job->windowSize = windowValue.As<Napi::Number>().Uint32Value();
+    }
+
+    worker->AddJob(std::move(job), pricesValue);
+  }
+
+  Napi::Promise promise = worker->Promise();
+  worker.release()->Queue();
+  return promise;
+}
+
+/**
+ * Wrapper: setThreadPoolSize
+ * Input: Number threads (0 restores the default)
+ * Output: undefined
+ */
+static Napi::Value SetThreadPoolSize(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected Number of threads").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  WorkStealingPool::ResizeShared(info[0].As<Napi::Number>().Uint32Value());
+  return env.Undefined();
+}
+
+/**
+ * Wrapper: getThreadPoolSize
+ * Output: Number of worker threads in the shared pool
+ */
+static Napi::Value GetThreadPoolSize(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(WorkStealingPool::Shared()->Size()));
+}
+
+void InitBatchAnalysis(Napi::Env env, Napi::Object exports) {
+  exports.Set("analyzeBatch", Napi::Function::New(env, AnalyzeBatch));
+  exports.Set("CancelToken", CancelTokenWrap::Init(env));
+  exports.Set("setThreadPoolSize", Napi::Function::New(env, SetThreadPoolSize));
+  exports.Set("getThreadPoolSize", Napi::Function::New(env, GetThreadPoolSize));
+}
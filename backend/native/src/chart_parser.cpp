@@ -0,0 +1,94 @@
+/**
+ * Chart response parser bindings
+ *
+ * parseChartColumns(bytes) runs libdsa's chart parser over a raw provider
+ * response and hands the resulting columns to JS without copying, so the
+ * response is never turned into a JS object graph. Parsing is synchronous:
+ * a response of several years of daily rows takes a few milliseconds,
+ * well under what a thread pool round trip would save.
+ */
+
+#include "addon.h"
+#include <cmath>
+
+extern "C" {
+  #include "chart_parser.h"
+}
+
+static const char* const kFieldNames[CHART_FIELD_COUNT] = {
+  "date", "open", "high", "low", "close", "volume",
+};
+
+static const double kSecondsPerDay = 86400.0;
+
+/**
+ * Helper: Owns a ChartColumns result until its arrays move to JS
+ */
+struct ChartColumnsOwner {
+  ChartColumns* chart = nullptr;
+  ~ChartColumnsOwner() { freeChartColumns(chart); }
+};
+
+/**
+ * Wrapper: parseChartColumns
+ * Input: Buffer or Uint8Array holding a chart response (UTF-8 JSON)
+ * Output: Object {date: Int32Array (days since 1970-01-01 UTC), open, high,
+ *         low, close, volume: Float64Array}; rows without a timestamp or
+ *         close are dropped, a missing open/high/low takes the close and a
+ *         missing volume is 0
+ */
+static Napi::Value ParseChartColumnsWrapped(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsTypedArray() ||
+      info[0].As<Napi::TypedArray>().TypedArrayType() != napi_uint8_array) {
+    Napi::TypeError::New(env, "Expected Buffer or Uint8Array as first argument")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Uint8Array bytes = info[0].As<Napi::Uint8Array>();
+  ChartColumnsOwner owner;
+  char errBuf[ERR_BUF_SIZE] = {0};
+  int result = parseChartColumns(reinterpret_cast<const char*>(bytes.Data()),
+                                 bytes.ElementLength(), &owner.chart, errBuf, ERR_BUF_SIZE);
+  if (result != 0) {
+    ThrowCError(env, result, errBuf);
+    return env.Null();
+  }
+
+  ChartColumns* chart = owner.chart;
+  size_t rows = compactChartRows(chart);
+
+  // Timestamps become epoch days; the backend keys history by UTC day
+  int32_t* days = static_cast<int32_t*>(malloc((rows ? rows : 1) * sizeof(int32_t)));
+  if (!days) {
+    ThrowCError(env, -3, "Memory allocation failed");
+    return env.Null();
+  }
+  const double* timestamps = chart->values[CHART_TIMESTAMP];
+  for (size_t i = 0; i < rows; i++) {
+    double day = std::floor(timestamps[i] / kSecondsPerDay);
+    if (!(day >= INT32_MIN && day <= INT32_MAX)) {
+      free(days);
+      Napi::RangeError::New(env, "Chart timestamp out of range").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    days[i] = static_cast<int32_t>(day);
+  }
+
+  Napi::Object resultObj = Napi::Object::New(env);
+  resultObj.Set(kFieldNames[CHART_TIMESTAMP], WrapNativeArray<int32_t>(env, days, rows));
+  for (int f = CHART_TIMESTAMP + 1; f < CHART_FIELD_COUNT; f++) {
+    // Ownership of the column moves to the ArrayBuffer
+    double* values = chart->values[f];
+    chart->values[f] = nullptr;
+    resultObj.Set(kFieldNames[f], WrapNativeArray<double>(env, values, rows));
+  }
+
+  return resultObj;
+}
+
+void InitChartParser(Napi::Env env, Napi::Object exports) {
+  exports.Set("parseChartColumns", Napi::Function::New(env, ParseChartColumnsWrapped));
+}
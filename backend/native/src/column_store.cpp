@@ -0,0 +1,379 @@
+/**
+ * Column store bindings
+ *
+ * new ColumnStore(dir) opens libdsa's append-only OHLCV store for one
+ * symbol. readRange() hands the mapped column files to JS as Float64Arrays
+ * without copying; each array keeps its mapping alive until it is garbage
+ * collected, so arrays stay valid after close() or later appends.
+ *
+ * append() writes and syncs the files on the libuv threadpool and returns a
+ * Promise; the store takes no other append or read until it settles, and a
+ * close() meanwhile waits for it. readRange() is synchronous: it only maps
+ * pages. Open at most one ColumnStore per directory.
+ */
+
+#include "addon.h"
+
+extern "C" {
+  #include "column_store.h"
+}
+
+static const char* const kColumnNames[COLUMN_COUNT] = {
+  "date", "open", "high", "low", "close", "volume",
+};
+
+/**
+ * Helper: Column id for a name, or -1
+ */
+static int FindColumn(const std::string& name) {
+  for (int c = 0; c < COLUMN_COUNT; c++) {
+    if (name == kColumnNames[c]) return c;
+  }
+  return -1;
+}
+
+/**
+ * Helper: Hand a column mapping to JS as a Float64Array
+ *
+ * The array references the mapping directly and releases it when garbage
+ * collected. Runtimes that forbid external buffers get a copy.
+ */
+static Napi::Float64Array WrapColumnMapping(Napi::Env env, const double* values, size_t count,
+                                            void* mapping) {
+  if (count == 0) return Napi::Float64Array::New(env, 0);
+
+#ifdef NODE_API_NO_EXTERNAL_BUFFERS_ALLOWED
+  Napi::Float64Array array = Napi::Float64Array::New(env, count);
+  std::memcpy(array.Data(), values, count * sizeof(double));
+  releaseColumnMapping(mapping);
+  return array;
+#else
+  // Private mapping: writes from JS stay in this process's copy
+  Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(
+      env, const_cast<double*>(values), count * sizeof(double),
+      [](Napi::Env /*env*/, void* /*data*/, void* hint) { releaseColumnMapping(hint); },
+      mapping);
+  return Napi::Float64Array::New(env, count, buffer, 0);
+#endif
+}
+
+/**
+ * JS class: ColumnStore
+ *
+ * Owns a C store handle, closed by close() or the GC finalizer.
+ */
+class ColumnStoreWrap : public Napi::ObjectWrap<ColumnStoreWrap> {
+ public:
+  static Napi::Function Init(Napi::Env env);
+
+  explicit ColumnStoreWrap(const Napi::CallbackInfo& info);
+  void Finalize(Napi::Env env) override;
+
+  // Called on the JS thread once a queued append has finished
+  void AppendDone();
+
+ private:
+  void* RequireHandle(Napi::Env env) const;
+  void Refresh();
+
+  Napi::Value Append(const Napi::CallbackInfo& info);
+  Napi::Value ReadRange(const Napi::CallbackInfo& info);
+  Napi::Value Close(const Napi::CallbackInfo& info);
+  Napi::Value GetRows(const Napi::CallbackInfo& info);
+  Napi::Value GetCoverage(const Napi::CallbackInfo& info);
+  Napi::Value GetClosed(const Napi::CallbackInfo& info);
+
+  void* handle_ = nullptr;
+  bool busy_ = false;            // an append is running on the threadpool
+  bool closeRequested_ = false;  // close() while busy: closed when it settles
+
+  // Header as of the last settled append (the C store changes it under
+  // Execute(), so the accessors read this copy)
+  size_t rows_ = 0;
+  bool covered_ = false;
+  double coverageStart_ = 0;
+  double coverageEnd_ = 0;
+};
+
+/**
+ * Async worker: append
+ * Resolves: Number of rows written (rows already stored are skipped)
+ *
+ * References the store and the column arrays so neither can be collected
+ * under Execute().
+ */
+class ColumnAppendWorker : public Napi::AsyncWorker {
+ public:
+  ColumnAppendWorker(Napi::Env env, Napi::Object storeObj, ColumnStoreWrap* store, void* handle,
+                     double rangeStart, double rangeEnd)
+      : Napi::AsyncWorker(env, "dsa:columnStoreAppend"),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        storeRef_(Napi::Persistent(storeObj)),
+        store_(store),
+        handle_(handle),
+        rangeStart_(rangeStart),
+        rangeEnd_(rangeEnd) {}
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+  void SetColumn(int column, Napi::Float64Array array) {
+    columnRefs_[column] = Napi::Persistent(static_cast<Napi::Object>(array));
+    columns_[column] = array.Data();
+    rows_ = array.ElementLength();
+  }
+
+ protected:
+  void Execute() override {
+    int result = appendColumnRows(handle_, columns_, rows_, rangeStart_, rangeEnd_, &appended_,
+                                  errBuf_, ERR_BUF_SIZE);
+    if (result != 0) SetError(FormatCError(result, errBuf_));
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::HandleScope scope(env);
+    store_->AppendDone();
+    deferred_.Resolve(Napi::Number::New(env, static_cast<double>(appended_)));
+  }
+
+  void OnError(const Napi::Error& error) override {
+    store_->AppendDone();
+    deferred_.Reject(error.Value());
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  Napi::ObjectReference storeRef_;
+  Napi::ObjectReference columnRefs_[COLUMN_COUNT];
+  ColumnStoreWrap* store_;
+  void* handle_;
+  const double* columns_[COLUMN_COUNT] = {nullptr};
+  size_t rows_ = 0;
+  double rangeStart_;
+  double rangeEnd_;
+  size_t appended_ = 0;
+  char errBuf_[ERR_BUF_SIZE] = {0};
+};
+
+Napi::Function ColumnStoreWrap::Init(Napi::Env env) {
+  return DefineClass(env, "ColumnStore", {
+    InstanceMethod("append", &ColumnStoreWrap::Append),
+    InstanceMethod("readRange", &ColumnStoreWrap::ReadRange),
+    InstanceMethod("close", &ColumnStoreWrap::Close),
+    InstanceAccessor("rows", &ColumnStoreWrap::GetRows, nullptr),
+    InstanceAccessor("coverage", &ColumnStoreWrap::GetCoverage, nullptr),
+    InstanceAccessor("closed", &ColumnStoreWrap::GetClosed, nullptr),
+  });
+}
+
+/**
+ * Constructor: new ColumnStore(dir)
+ * Input: String directory (created if missing; its parent must exist)
+ */
+ColumnStoreWrap::ColumnStoreWrap(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<ColumnStoreWrap>(info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected String directory").ThrowAsJavaScriptException();
+    return;
+  }
+
+  std::string dir = info[0].As<Napi::String>().Utf8Value();
+  char errBuf[ERR_BUF_SIZE] = {0};
+  int result = openColumnStore(dir.c_str(), &handle_, errBuf, ERR_BUF_SIZE);
+  if (result != 0) {
+    handle_ = nullptr;
+    ThrowCError(env, result, errBuf);
+    return;
+  }
+  Refresh();
+}
+
+void ColumnStoreWrap::Finalize(Napi::Env /*env*/) {
+  // Never busy here: a pending append references this object
+  closeColumnStore(handle_);
+  handle_ = nullptr;
+}
+
+void ColumnStoreWrap::Refresh() {
+  rows_ = getColumnStoreRows(handle_);
+  covered_ = getColumnStoreCoverage(handle_, &coverageStart_, &coverageEnd_) != 0;
+}
+
+void ColumnStoreWrap::AppendDone() {
+  busy_ = false;
+  Refresh();
+  if (closeRequested_) {
+    closeColumnStore(handle_);
+    handle_ = nullptr;
+  }
+}
+
+void* ColumnStoreWrap::RequireHandle(Napi::Env env) const {
+  if (!handle_ || closeRequested_) {
+    Napi::Error::New(env, "ColumnStore has been closed").ThrowAsJavaScriptException();
+    return nullptr;
+  }
+  if (busy_) {
+    Napi::Error::New(env, "ColumnStore is busy with an append").ThrowAsJavaScriptException();
+    return nullptr;
+  }
+  return handle_;
+}
+
+/**
+ * Method: append
+ * Input: Object {date, open, high, low, close, volume} of equal-length
+ *        Float64Arrays, Number rangeStart, Number rangeEnd
+ * Output: Promise<Number> of rows written (rows already stored are skipped)
+ */
+Napi::Value ColumnStoreWrap::Append(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  void* handle = RequireHandle(env);
+  if (!handle) return env.Null();
+
+  if (info.Length() < 3 || !info[0].IsObject() || !info[1].IsNumber() || !info[2].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (columns Object, Number, Number)")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Object columnsObj = info[0].As<Napi::Object>();
+  Napi::Float64Array columns[COLUMN_COUNT];
+  size_t rows = 0;
+  for (int c = 0; c < COLUMN_COUNT; c++) {
+    Napi::Value value = columnsObj.Get(kColumnNames[c]);
+    if (!value.IsTypedArray() ||
+        value.As<Napi::TypedArray>().TypedArrayType() != napi_float64_array) {
+      Napi::TypeError::New(env, std::string("Column '") + kColumnNames[c] +
+                                    "' must be a Float64Array")
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    Napi::Float64Array array = value.As<Napi::Float64Array>();
+    if (c == 0) {
+      rows = array.ElementLength();
+    } else if (array.ElementLength() != rows) {
+      Napi::RangeError::New(env, "Columns must have equal lengths").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    columns[c] = array;
+  }
+
+  ColumnAppendWorker* worker = new ColumnAppendWorker(
+      env, info.This().As<Napi::Object>(), this, handle,
+      info[1].As<Napi::Number>().DoubleValue(), info[2].As<Napi::Number>().DoubleValue());
+  for (int c = 0; c < COLUMN_COUNT; c++) worker->SetColumn(c, columns[c]);
+  busy_ = true;
+
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
+
+/**
+ * Method: readRange
+ * Input: Number startDate, Number endDate (inclusive), optional Array of
+ *        column names (default: all six)
+ * Output: Object of Float64Arrays keyed by column name; empty arrays if no
+ *         rows fall in the range
+ */
+Napi::Value ColumnStoreWrap::ReadRange(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  void* handle = RequireHandle(env);
+  if (!handle) return env.Null();
+
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber() ||
+      (info.Length() > 2 && !info[2].IsUndefined() && !info[2].IsArray())) {
+    Napi::TypeError::New(env, "Expected (Number, Number, optional Array of column names)")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  bool wanted[COLUMN_COUNT];
+  bool allColumns = info.Length() < 3 || info[2].IsUndefined();
+  for (int c = 0; c < COLUMN_COUNT; c++) wanted[c] = allColumns;
+  if (!allColumns) {
+    Napi::Array names = info[2].As<Napi::Array>();
+    for (uint32_t i = 0; i < names.Length(); i++) {
+      Napi::Value name = names.Get(i);
+      int column = name.IsString() ? FindColumn(name.As<Napi::String>().Utf8Value()) : -1;
+      if (column < 0) {
+        Napi::TypeError::New(env, "Unknown column name").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      wanted[column] = true;
+    }
+  }
+
+  size_t first = 0;
+  size_t count = 0;
+  char errBuf[ERR_BUF_SIZE] = {0};
+  int result = findColumnDateRange(handle, info[0].As<Napi::Number>().DoubleValue(),
+                                   info[1].As<Napi::Number>().DoubleValue(), &first, &count,
+                                   errBuf, ERR_BUF_SIZE);
+  if (result != 0) {
+    ThrowCError(env, result, errBuf);
+    return env.Null();
+  }
+
+  Napi::Object resultObj = Napi::Object::New(env);
+  for (int c = 0; c < COLUMN_COUNT; c++) {
+    if (!wanted[c]) continue;
+
+    const double* values = nullptr;
+    void* mapping = nullptr;
+    result = mapColumnRange(handle, static_cast<ColumnId>(c), first, count, &values, &mapping,
+                            errBuf, ERR_BUF_SIZE);
+    if (result != 0) {
+      ThrowCError(env, result, errBuf);
+      return env.Null();
+    }
+    resultObj.Set(kColumnNames[c], WrapColumnMapping(env, values, count, mapping));
+  }
+
+  return resultObj;
+}
+
+/**
+ * Method: close
+ * Output: undefined (idempotent; arrays already returned stay valid; a
+ *         pending append finishes first)
+ */
+Napi::Value ColumnStoreWrap::Close(const Napi::CallbackInfo& info) {
+  if (busy_) {
+    closeRequested_ = true;
+    return info.Env().Undefined();
+  }
+  closeColumnStore(handle_);
+  handle_ = nullptr;
+  return info.Env().Undefined();
+}
+
+Napi::Value ColumnStoreWrap::GetRows(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), handle_ ? static_cast<double>(rows_) : 0);
+}
+
+/**
+ * Accessor: coverage
+ * Output: Object {start, end} of the dates the store covers, or null
+ */
+Napi::Value ColumnStoreWrap::GetCoverage(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (!handle_ || !covered_) return env.Null();
+
+  Napi::Object resultObj = Napi::Object::New(env);
+  resultObj.Set("start", Napi::Number::New(env, coverageStart_));
+  resultObj.Set("end", Napi::Number::New(env, coverageEnd_));
+  return resultObj;
+}
+
+Napi::Value ColumnStoreWrap::GetClosed(const Napi::CallbackInfo& info) {
+  return Napi::Boolean::New(info.Env(), handle_ == nullptr || closeRequested_);
+}
+
+void InitColumnStore(Napi::Env env, Napi::Object exports) {
+  exports.Set("ColumnStore", ColumnStoreWrap::Init(env));
+}
@@ -14,17 +14,76 @@ export {
   freeSegmentTree,
   analyzeSlidingWindow,
   getWindowResult,
+  serializeWindowResult,
+  iterateWindowChunks,
   freeWindowResult,
+  findInvalidPrice,
+  getNativeDiagnostics,
+  
+  // Call statistics
+  getNativeStats,
+  setNativeStatsEnabled,
+  resetNativeStats,
+  
+  // Series registry
+  registerSeries,
+  appendSeries,
+  releaseSeries,
+  getSeriesInfo,
+  findSeries,
+  querySeriesRange,
+  getTreeCacheStats,
+  setTreeCacheBudget,
+  clearTreeCache,
+  
+  // Column store
+  openColumnStore,
+  
+  // Provider response parsing
+  parseChartColumns,
+  
+  // Fused and batch analysis
+  analyzeSeries,
+  analyzeBatch,
+  setThreadPoolSize,
+  getThreadPoolSize,
+  WINDOW_PATTERNS,
   
   // Helper functions with auto-cleanup
   withSegmentTree,
   withSlidingWindow,
   
+  // Worker thread pool
+  NativeWorkerPool,
+  getWorkerPool,
+  closeWorkerPool,
+  toSharedPrices,
+  defaultWorkerCount,
+  
   // Types
+  type PriceArray,
+  type PriceSource,
+  type SeriesId,
+  type SeriesInfo,
+  type TreeCacheStats,
+  type OhlcvColumns,
+  type ColumnName,
+  type ColumnStoreHandle,
+  type ChartColumns,
   type SegmentTreeHandle,
   type WindowResultHandle,
   type RangeStats,
   type WindowStats,
+  type WindowFormat,
+  type WindowChunkIterator,
+  type SeriesOptions,
+  type BatchJob,
+  type BatchResult,
+  type BatchOptions,
+  type NativeDiagnostics,
+  type NativeStats,
+  type NativeFunctionStats,
+  type WorkerTask,
 } from './wrapper';
 
 /**
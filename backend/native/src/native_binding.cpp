@@ -5,269 +5,1155 @@
  * Handles type conversions, memory management, and error propagation.
  */
 
-#include <napi.h>
+#include "addon.h"
+#include "series_registry.h"
+#include "tree_cache.h"
+#include "window_json.h"
+
+#include <cstdio>
 #include <cstring>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
 
 extern "C" {
   #include "stock_span.h"
   #include "segment_tree.h"
   #include "sliding_window.h"
+  #include "price_validation.h"
+  #include "cpu_dispatch.h"
+}
+
+/**
+ * Helper: Price input from a Float64Array, Float32Array or registered
+ * series (one pointer set)
+ */
+struct PriceInput {
+  const double* f64 = nullptr;
+  const float* f32 = nullptr;
+  size_t length = 0;
+  std::shared_ptr<const double> series;  // Keeps a series snapshot alive
+};
+
+/**
+ * Helper: Validate a Float64Array/Float32Array/series id argument and point
+ * at its data
+ * Returns false (with a pending JS exception) if the value is not usable.
+ */
+static bool GetPriceArray(Napi::Env env, const Napi::Value& value, PriceInput* out,
+                          bool allowEmpty = false) {
+  napi_typedarray_type type = value.IsTypedArray()
+      ? value.As<Napi::TypedArray>().TypedArrayType()
+      : napi_int8_array;
+  if (type != napi_float64_array && type != napi_float32_array && !value.IsNumber()) {
+    Napi::TypeError::New(env, "Expected Float64Array, Float32Array or series id as first argument")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+
+  PriceInput input;
+  if (value.IsNumber()) {
+    // Registered series: read the registry's copy, no marshalling
+    double id = value.As<Napi::Number>().DoubleValue();
+    SeriesSnapshot snapshot;
+    if (!(id >= 1 && id <= UINT32_MAX && std::floor(id) == id)) {
+      Napi::TypeError::New(env, "Invalid series id").ThrowAsJavaScriptException();
+      return false;
+    }
+    if (!SeriesRegistry::Instance().Snapshot(static_cast<uint32_t>(id), &snapshot)) {
+      Napi::Error::New(env, "Unknown series id " + std::to_string(static_cast<uint32_t>(id)))
+          .ThrowAsJavaScriptException();
+      return false;
+    }
+    input.f64 = snapshot.data.get();
+    input.length = snapshot.length;
+    input.series = std::move(snapshot.data);
+  } else if (type == napi_float64_array) {
+    Napi::Float64Array array = value.As<Napi::Float64Array>();
+    input.f64 = array.Data();
+    input.length = array.ElementLength();
+  } else {
+    Napi::Float32Array array = value.As<Napi::Float32Array>();
+    input.f32 = array.Data();
+    input.length = array.ElementLength();
+  }
+
+  if (input.length == 0 && !allowEmpty) {
+    Napi::TypeError::New(env, "Input array cannot be empty").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  *out = input;
+  return true;
 }
 
-// Error buffer size for C function calls
-#define ERR_BUF_SIZE 512
+/**
+ * Helpers: Call the C entry point matching the input precision
+ */
+static int RunStockSpan(const PriceInput& in, int** outSpans, char* errBuf) {
+  return in.f32 ? calculateStockSpanF32(in.f32, in.length, outSpans, errBuf, ERR_BUF_SIZE)
+                : calculateStockSpan(in.f64, in.length, outSpans, errBuf, ERR_BUF_SIZE);
+}
+
+static int RunSegmentTree(const PriceInput& in, void** outHandle, char* errBuf) {
+  return in.f32 ? buildSegmentTreeF32(in.f32, in.length, outHandle, errBuf, ERR_BUF_SIZE)
+                : buildSegmentTree(in.f64, in.length, outHandle, errBuf, ERR_BUF_SIZE);
+}
+
+static int RunSlidingWindow(const PriceInput& in, size_t windowSize, void** outHandle,
+                            char* errBuf) {
+  return in.f32
+      ? analyzeSlidingWindowF32(in.f32, in.length, windowSize, outHandle, errBuf, ERR_BUF_SIZE)
+      : analyzeSlidingWindow(in.f64, in.length, windowSize, outHandle, errBuf, ERR_BUF_SIZE);
+}
+
+/**
+ * Per-environment addon state (one per main thread or worker thread)
+ */
+struct AddonData {
+  Napi::FunctionReference segmentTreeConstructor;
+  Napi::FunctionReference windowResultConstructor;
+  Napi::FunctionReference windowIteratorConstructor;
+};
+
+// Type tags let us reject arbitrary JS objects passed in place of a handle
+static const napi_type_tag kSegmentTreeTypeTag = {0x9c2f3a51d4e84b07ULL, 0xa61b5e2c7f903d18ULL};
+static const napi_type_tag kWindowResultTypeTag = {0x3e7d91c4b2a64f85ULL, 0x8d05f6a1c93e2b74ULL};
 
 /**
- * Helper: Convert C error to JS exception
+ * JS class: SegmentTree
+ *
+ * Owns a C segment tree handle. The tree is released by free() or, if JS
+ * never calls it, by the GC finalizer; both paths are idempotent. The
+ * tree's native size is reported to V8 so large trees create GC pressure.
  */
-static void ThrowCError(Napi::Env env, int errorCode, const char* errorMsg) {
-  std::string fullMsg = "C Module Error (code " + std::to_string(errorCode) + "): " + errorMsg;
-  Napi::Error::New(env, fullMsg).ThrowAsJavaScriptException();
+class SegmentTreeWrap : public Napi::ObjectWrap<SegmentTreeWrap> {
+ public:
+  static Napi::Function Init(Napi::Env env);
+  static Napi::Object NewInstance(Napi::Env env, void* handle);
+  static SegmentTreeWrap* FromValue(Napi::Env env, const Napi::Value& value);
+
+  explicit SegmentTreeWrap(const Napi::CallbackInfo& info);
+  void Finalize(Napi::Env env) override;
+
+  // Returns the C handle, or nullptr (with a pending JS exception) if freed
+  void* RequireHandle(Napi::Env env) const;
+
+  // Frees the C handle now; safe to call more than once
+  void Release(Napi::Env env);
+
+ private:
+  Napi::Value Query(const Napi::CallbackInfo& info);
+  Napi::Value Free(const Napi::CallbackInfo& info);
+  Napi::Value GetLength(const Napi::CallbackInfo& info);
+  Napi::Value GetByteLength(const Napi::CallbackInfo& info);
+  Napi::Value GetFreed(const Napi::CallbackInfo& info);
+
+  void* handle_ = nullptr;
+  size_t byteLength_ = 0;
+};
+
+/**
+ * JS class: WindowResult
+ *
+ * Owns a C sliding window result handle, with the same lifetime rules
+ * as SegmentTree.
+ */
+class WindowResultWrap : public Napi::ObjectWrap<WindowResultWrap> {
+ public:
+  static Napi::Function Init(Napi::Env env);
+  static Napi::Object NewInstance(Napi::Env env, void* handle);
+  static WindowResultWrap* FromValue(Napi::Env env, const Napi::Value& value);
+
+  explicit WindowResultWrap(const Napi::CallbackInfo& info);
+  void Finalize(Napi::Env env) override;
+
+  // Returns the C handle, or nullptr (with a pending JS exception) if freed
+  void* RequireHandle(Napi::Env env) const;
+
+  // Detaches the C handle from JS; safe to call more than once. It is
+  // freed now unless pinned, else when the last pin is dropped.
+  void Release(Napi::Env env);
+
+  // Shares ownership of the C handle with an off-thread reader or iterator,
+  // so it outlives free() from JS and does not depend on this object (the
+  // two may be finalized in either order at env teardown). Returns an empty
+  // pointer, with a pending JS exception, if already freed.
+  std::shared_ptr<void> Pin(Napi::Env env);
+
+ private:
+  Napi::Value Get(const Napi::CallbackInfo& info);
+  Napi::Value Free(const Napi::CallbackInfo& info);
+  Napi::Value GetCount(const Napi::CallbackInfo& info);
+  Napi::Value GetByteLength(const Napi::CallbackInfo& info);
+  Napi::Value GetFreed(const Napi::CallbackInfo& info);
+
+  std::shared_ptr<void> handle_;
+  size_t byteLength_ = 0;
+};
+
+/**
+ * Helper: Run a range query and build {min, max, avg, variance}
+ */
+static Napi::Value QueryTree(Napi::Env env, void* treeHandle,
+                             const Napi::Value& qlValue, const Napi::Value& qrValue) {
+  if (!qlValue.IsNumber() || !qrValue.IsNumber()) {
+    Napi::TypeError::New(env, "Expected (Number, Number) query range").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  size_t ql = qlValue.As<Napi::Number>().Uint32Value();
+  size_t qr = qrValue.As<Napi::Number>().Uint32Value();
+
+  double min, max, avg, variance;
+  char errBuf[ERR_BUF_SIZE] = {0};
+
+  int result = querySegmentTree(treeHandle, ql, qr, &min, &max, &avg, &variance, errBuf, ERR_BUF_SIZE);
+
+  if (result != 0) {
+    ThrowCError(env, result, errBuf);
+    return env.Null();
+  }
+
+  Napi::Object resultObj = Napi::Object::New(env);
+  resultObj.Set("min", Napi::Number::New(env, min));
+  resultObj.Set("max", Napi::Number::New(env, max));
+  resultObj.Set("avg", Napi::Number::New(env, avg));
+  resultObj.Set("variance", Napi::Number::New(env, variance));
+
+  return resultObj;
 }
 
+/**
+ * Helper: Read one window and build {max, min, avg, pattern}
+ */
+static Napi::Value ReadWindow(Napi::Env env, void* windowHandle, const Napi::Value& idxValue) {
+  if (!idxValue.IsNumber()) {
+    Napi::TypeError::New(env, "Expected Number window index").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  size_t idx = idxValue.As<Napi::Number>().Uint32Value();
+
+  double max, min, avg;
+  char pattern[64] = {0};
+  char errBuf[ERR_BUF_SIZE] = {0};
+
+  int result = getWindowResult(windowHandle, idx, &max, &min, &avg, pattern, sizeof(pattern), errBuf, ERR_BUF_SIZE);
+
+  if (result != 0) {
+    ThrowCError(env, result, errBuf);
+    return env.Null();
+  }
+
+  Napi::Object resultObj = Napi::Object::New(env);
+  resultObj.Set("max", Napi::Number::New(env, max));
+  resultObj.Set("min", Napi::Number::New(env, min));
+  resultObj.Set("avg", Napi::Number::New(env, avg));
+  resultObj.Set("pattern", Napi::String::New(env, pattern));
+
+  return resultObj;
+}
+
+Napi::Function SegmentTreeWrap::Init(Napi::Env env) {
+  return DefineClass(env, "SegmentTree", {
+    InstanceMethod("query", &SegmentTreeWrap::Query),
+    InstanceMethod("free", &SegmentTreeWrap::Free),
+    InstanceAccessor("length", &SegmentTreeWrap::GetLength, nullptr),
+    InstanceAccessor("byteLength", &SegmentTreeWrap::GetByteLength, nullptr),
+    InstanceAccessor("freed", &SegmentTreeWrap::GetFreed, nullptr),
+  });
+}
+
+Napi::Object SegmentTreeWrap::NewInstance(Napi::Env env, void* handle) {
+  AddonData* data = env.GetInstanceData<AddonData>();
+  return data->segmentTreeConstructor.New({Napi::External<void>::New(env, handle)});
+}
+
+SegmentTreeWrap* SegmentTreeWrap::FromValue(Napi::Env env, const Napi::Value& value) {
+  if (!value.IsObject() || !value.As<Napi::Object>().CheckTypeTag(&kSegmentTreeTypeTag)) {
+    Napi::TypeError::New(env, "Expected SegmentTree handle").ThrowAsJavaScriptException();
+    return nullptr;
+  }
+  return Unwrap(value.As<Napi::Object>());
+}
+
+SegmentTreeWrap::SegmentTreeWrap(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<SegmentTreeWrap>(info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsExternal()) {
+    Napi::TypeError::New(env, "SegmentTree cannot be constructed directly; use buildSegmentTree()")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  handle_ = info[0].As<Napi::External<void>>().Data();
+  byteLength_ = getSegmentTreeMemoryUsage(handle_);
+  Napi::MemoryManagement::AdjustExternalMemory(env, static_cast<int64_t>(byteLength_));
+  info.This().As<Napi::Object>().TypeTag(&kSegmentTreeTypeTag);
+}
+
+void SegmentTreeWrap::Finalize(Napi::Env env) {
+  Release(env);
+}
+
+void SegmentTreeWrap::Release(Napi::Env env) {
+  if (!handle_) return;
+  freeSegmentTree(handle_);
+  handle_ = nullptr;
+  Napi::MemoryManagement::AdjustExternalMemory(env, -static_cast<int64_t>(byteLength_));
+}
+
+void* SegmentTreeWrap::RequireHandle(Napi::Env env) const {
+  if (!handle_) {
+    Napi::Error::New(env, "SegmentTree has been freed").ThrowAsJavaScriptException();
+  }
+  return handle_;
+}
+
+Napi::Value SegmentTreeWrap::Query(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  void* handle = RequireHandle(env);
+  if (!handle) return env.Null();
+  return QueryTree(env, handle, info[0], info[1]);
+}
+
+Napi::Value SegmentTreeWrap::Free(const Napi::CallbackInfo& info) {
+  Release(info.Env());
+  return info.Env().Undefined();
+}
+
+Napi::Value SegmentTreeWrap::GetLength(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(getSegmentTreeLength(handle_)));
+}
+
+Napi::Value SegmentTreeWrap::GetByteLength(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(handle_ ? byteLength_ : 0));
+}
+
+Napi::Value SegmentTreeWrap::GetFreed(const Napi::CallbackInfo& info) {
+  return Napi::Boolean::New(info.Env(), handle_ == nullptr);
+}
+
+Napi::Function WindowResultWrap::Init(Napi::Env env) {
+  return DefineClass(env, "WindowResult", {
+    InstanceMethod("get", &WindowResultWrap::Get),
+    InstanceMethod("free", &WindowResultWrap::Free),
+    InstanceAccessor("count", &WindowResultWrap::GetCount, nullptr),
+    InstanceAccessor("byteLength", &WindowResultWrap::GetByteLength, nullptr),
+    InstanceAccessor("freed", &WindowResultWrap::GetFreed, nullptr),
+  });
+}
+
+Napi::Object WindowResultWrap::NewInstance(Napi::Env env, void* handle) {
+  AddonData* data = env.GetInstanceData<AddonData>();
+  return data->windowResultConstructor.New({Napi::External<void>::New(env, handle)});
+}
+
+WindowResultWrap* WindowResultWrap::FromValue(Napi::Env env, const Napi::Value& value) {
+  if (!value.IsObject() || !value.As<Napi::Object>().CheckTypeTag(&kWindowResultTypeTag)) {
+    Napi::TypeError::New(env, "Expected WindowResult handle").ThrowAsJavaScriptException();
+    return nullptr;
+  }
+  return Unwrap(value.As<Napi::Object>());
+}
+
+WindowResultWrap::WindowResultWrap(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<WindowResultWrap>(info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsExternal()) {
+    Napi::TypeError::New(env, "WindowResult cannot be constructed directly; use analyzeSlidingWindow()")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  void* handle = info[0].As<Napi::External<void>>().Data();
+  handle_ = std::shared_ptr<void>(handle, freeWindowResult);
+  byteLength_ = getWindowResultMemoryUsage(handle);
+  Napi::MemoryManagement::AdjustExternalMemory(env, static_cast<int64_t>(byteLength_));
+  info.This().As<Napi::Object>().TypeTag(&kWindowResultTypeTag);
+}
+
+void WindowResultWrap::Finalize(Napi::Env env) {
+  Release(env);
+}
+
+void WindowResultWrap::Release(Napi::Env env) {
+  if (!handle_) return;
+  handle_.reset();
+  Napi::MemoryManagement::AdjustExternalMemory(env, -static_cast<int64_t>(byteLength_));
+}
+
+std::shared_ptr<void> WindowResultWrap::Pin(Napi::Env env) {
+  RequireHandle(env);
+  return handle_;
+}
+
+void* WindowResultWrap::RequireHandle(Napi::Env env) const {
+  if (!handle_) {
+    Napi::Error::New(env, "WindowResult has been freed").ThrowAsJavaScriptException();
+  }
+  return handle_.get();
+}
+
+Napi::Value WindowResultWrap::Get(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  void* handle = RequireHandle(env);
+  if (!handle) return env.Null();
+  return ReadWindow(env, handle, info[0]);
+}
+
+Napi::Value WindowResultWrap::Free(const Napi::CallbackInfo& info) {
+  Release(info.Env());
+  return info.Env().Undefined();
+}
+
+Napi::Value WindowResultWrap::GetCount(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(getWindowResultCount(handle_.get())));
+}
+
+Napi::Value WindowResultWrap::GetByteLength(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(handle_ ? byteLength_ : 0));
+}
+
+Napi::Value WindowResultWrap::GetFreed(const Napi::CallbackInfo& info) {
+  return Napi::Boolean::New(info.Env(), handle_ == nullptr);
+}
+
+/**
+ * Base class for computations run on the libuv threadpool.
+ *
+ * Holds a persistent reference to the input typed array (or a registered
+ * series snapshot) so the data cannot be freed while Execute() reads it,
+ * and settles a promise instead of invoking a callback. Subclasses call
+ * SetCError() from Execute() on failure and implement Resolve().
+ *
+ * The input must not be mutated by JS until the promise settles.
+ */
+class PriceWorker : public Napi::AsyncWorker {
+ public:
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+ protected:
+  PriceWorker(Napi::Env env, const char* resourceName, Napi::Value inputValue,
+              const PriceInput& input)
+      : Napi::AsyncWorker(env, resourceName),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        inputRef_(inputValue.IsObject() ? Napi::Persistent(inputValue.As<Napi::Object>())
+                                        : Napi::ObjectReference()),
+        input_(input) {}
+
+  void SetCError(int errorCode) {
+    SetError(FormatCError(errorCode, errBuf_));
+  }
+
+  void OnOK() override {
+    Napi::HandleScope scope(Env());
+    deferred_.Resolve(Resolve());
+  }
+
+  void OnError(const Napi::Error& error) override {
+    deferred_.Reject(error.Value());
+  }
+
+  virtual Napi::Value Resolve() = 0;
+
+  Napi::Promise::Deferred deferred_;
+  Napi::ObjectReference inputRef_;
+  PriceInput input_;
+  char errBuf_[ERR_BUF_SIZE] = {0};
+};
+
 /**
  * Wrapper: calculateStockSpan
- * Input: Float64Array prices
+ * Input: Float64Array | Float32Array prices | Number series id
  * Output: Int32Array spans
  */
 Napi::Value CalculateStockSpan(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
-  // Validate arguments
-  if (info.Length() < 1 || !info[0].IsTypedArray()) {
-    Napi::TypeError::New(env, "Expected Float64Array as first argument").ThrowAsJavaScriptException();
-    return env.Null();
-  }
-  
-  Napi::Float64Array inputArray = info[0].As<Napi::Float64Array>();
-  size_t length = inputArray.ElementLength();
-  
-  if (length == 0) {
-    Napi::TypeError::New(env, "Input array cannot be empty").ThrowAsJavaScriptException();
+  PriceInput input;
+  if (!GetPriceArray(env, info[0], &input)) {
     return env.Null();
   }
   
-  // Get pointer to input data
-  double* prices = reinterpret_cast<double*>(inputArray.ArrayBuffer().Data());
-  prices += inputArray.ByteOffset() / sizeof(double);
-  
   // Call C function
   int* spans = nullptr;
   char errBuf[ERR_BUF_SIZE] = {0};
   
-  int result = calculateStockSpan(prices, length, &spans, errBuf, ERR_BUF_SIZE);
+  int result = RunStockSpan(input, &spans, errBuf);
   
   if (result != 0) {
     ThrowCError(env, result, errBuf);
     return env.Null();
   }
   
-  // Copy result to JS Int32Array
-  Napi::Int32Array outputArray = Napi::Int32Array::New(env, length);
-  int32_t* outputData = reinterpret_cast<int32_t*>(outputArray.ArrayBuffer().Data());
-  outputData += outputArray.ByteOffset() / sizeof(int32_t);
-  
-  for (size_t i = 0; i < length; i++) {
-    outputData[i] = spans[i];
-  }
-  
-  // Free C allocation
-  free(spans);
-  
-  return outputArray;
+  // Hand the C allocation to JS (freed by the ArrayBuffer finalizer)
+  return WrapNativeArray(env, reinterpret_cast<int32_t*>(spans), input.length);
 }
 
 /**
  * Wrapper: buildSegmentTree
- * Input: Float64Array prices
- * Output: Number (opaque handle as external)
+ * Input: Float64Array | Float32Array prices | Number series id
+ * Output: SegmentTree
  */
 Napi::Value BuildSegmentTree(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
-  if (info.Length() < 1 || !info[0].IsTypedArray()) {
-    Napi::TypeError::New(env, "Expected Float64Array as first argument").ThrowAsJavaScriptException();
+  PriceInput input;
+  if (!GetPriceArray(env, info[0], &input)) {
     return env.Null();
   }
   
-  Napi::Float64Array inputArray = info[0].As<Napi::Float64Array>();
-  size_t length = inputArray.ElementLength();
-  
-  if (length == 0) {
-    Napi::TypeError::New(env, "Input array cannot be empty").ThrowAsJavaScriptException();
-    return env.Null();
-  }
-  
-  double* prices = reinterpret_cast<double*>(inputArray.ArrayBuffer().Data());
-  prices += inputArray.ByteOffset() / sizeof(double);
-  
   void* treeHandle = nullptr;
   char errBuf[ERR_BUF_SIZE] = {0};
   
-  int result = buildSegmentTree(prices, length, &treeHandle, errBuf, ERR_BUF_SIZE);
+  int result = RunSegmentTree(input, &treeHandle, errBuf);
   
   if (result != 0) {
     ThrowCError(env, result, errBuf);
     return env.Null();
   }
   
-  // Return handle as external (wrapped pointer)
-  return Napi::External<void>::New(env, treeHandle);
+  return SegmentTreeWrap::NewInstance(env, treeHandle);
 }
 
 /**
  * Wrapper: querySegmentTree
- * Input: External handle, number ql, number qr
+ * Input: SegmentTree, number ql, number qr
  * Output: Object {min, max, avg, variance}
  */
 Napi::Value QuerySegmentTree(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
-  if (info.Length() < 3 || !info[0].IsExternal() || !info[1].IsNumber() || !info[2].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (External, Number, Number)").ThrowAsJavaScriptException();
+  if (info.Length() < 3 || !info[1].IsNumber() || !info[2].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (SegmentTree, Number, Number)").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  void* treeHandle = info[0].As<Napi::External<void>>().Data();
-  size_t ql = info[1].As<Napi::Number>().Uint32Value();
-  size_t qr = info[2].As<Napi::Number>().Uint32Value();
+  SegmentTreeWrap* tree = SegmentTreeWrap::FromValue(env, info[0]);
+  if (!tree) return env.Null();
   
-  double min, max, avg, variance;
-  char errBuf[ERR_BUF_SIZE] = {0};
-  
-  int result = querySegmentTree(treeHandle, ql, qr, &min, &max, &avg, &variance, errBuf, ERR_BUF_SIZE);
+  void* treeHandle = tree->RequireHandle(env);
+  if (!treeHandle) return env.Null();
   
-  if (result != 0) {
-    ThrowCError(env, result, errBuf);
-    return env.Null();
-  }
-  
-  Napi::Object resultObj = Napi::Object::New(env);
-  resultObj.Set("min", Napi::Number::New(env, min));
-  resultObj.Set("max", Napi::Number::New(env, max));
-  resultObj.Set("avg", Napi::Number::New(env, avg));
-  resultObj.Set("variance", Napi::Number::New(env, variance));
-  
-  return resultObj;
+  return QueryTree(env, treeHandle, info[1], info[2]);
 }
 
 /**
  * Wrapper: freeSegmentTree
- * Input: External handle
+ * Input: SegmentTree
  * Output: undefined
+ * 
+ * Idempotent: freeing an already-freed tree is a no-op.
  */
 Napi::Value FreeSegmentTree(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
-  if (info.Length() < 1 || !info[0].IsExternal()) {
-    Napi::TypeError::New(env, "Expected External handle").ThrowAsJavaScriptException();
-    return env.Undefined();
-  }
+  SegmentTreeWrap* tree = SegmentTreeWrap::FromValue(env, info[0]);
+  if (!tree) return env.Undefined();
   
-  void* treeHandle = info[0].As<Napi::External<void>>().Data();
-  freeSegmentTree(treeHandle);
+  tree->Release(env);
   
   return env.Undefined();
 }
 
 /**
  * Wrapper: analyzeSlidingWindow
- * Input: Float64Array prices, Number windowSize
- * Output: External handle
+ * Input: Float64Array | Float32Array prices | Number series id, Number windowSize
+ * Output: WindowResult
  */
 Napi::Value AnalyzeSlidingWindow(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
-  if (info.Length() < 2 || !info[0].IsTypedArray() || !info[1].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (Float64Array, Number)").ThrowAsJavaScriptException();
+  if (info.Length() < 2 || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (Float64Array | Float32Array | series id, Number)").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  Napi::Float64Array inputArray = info[0].As<Napi::Float64Array>();
-  size_t length = inputArray.ElementLength();
-  size_t windowSize = info[1].As<Napi::Number>().Uint32Value();
+  PriceInput input;
+  if (!GetPriceArray(env, info[0], &input)) {
+    return env.Null();
+  }
   
-  if (length == 0 || windowSize == 0) {
+  size_t windowSize = info[1].As<Napi::Number>().Uint32Value();
+  if (windowSize == 0) {
     Napi::TypeError::New(env, "Invalid array length or window size").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  double* prices = reinterpret_cast<double*>(inputArray.ArrayBuffer().Data());
-  prices += inputArray.ByteOffset() / sizeof(double);
-  
   void* windowHandle = nullptr;
   char errBuf[ERR_BUF_SIZE] = {0};
   
-  int result = analyzeSlidingWindow(prices, length, windowSize, &windowHandle, errBuf, ERR_BUF_SIZE);
+  int result = RunSlidingWindow(input, windowSize, &windowHandle, errBuf);
   
   if (result != 0) {
     ThrowCError(env, result, errBuf);
     return env.Null();
   }
   
-  return Napi::External<void>::New(env, windowHandle);
+  return WindowResultWrap::NewInstance(env, windowHandle);
 }
 
 /**
  * Wrapper: getWindowResult
- * Input: External handle, Number idx
+ * Input: WindowResult, Number idx
  * Output: Object {max, min, avg, pattern}
  */
 Napi::Value GetWindowResult(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
-  if (info.Length() < 2 || !info[0].IsExternal() || !info[1].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (External, Number)").ThrowAsJavaScriptException();
+  if (info.Length() < 2 || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (WindowResult, Number)").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  void* windowHandle = info[0].As<Napi::External<void>>().Data();
-  size_t idx = info[1].As<Napi::Number>().Uint32Value();
+  WindowResultWrap* windows = WindowResultWrap::FromValue(env, info[0]);
+  if (!windows) return env.Null();
   
-  double max, min, avg;
-  char pattern[64] = {0};
-  char errBuf[ERR_BUF_SIZE] = {0};
+  void* windowHandle = windows->RequireHandle(env);
+  if (!windowHandle) return env.Null();
   
-  int result = getWindowResult(windowHandle, idx, &max, &min, &avg, pattern, sizeof(pattern), errBuf, ERR_BUF_SIZE);
+  return ReadWindow(env, windowHandle, info[1]);
+}
+
+/**
+ * Wrapper: freeWindowResult
+ * Input: WindowResult
+ * Output: undefined
+ * 
+ * Idempotent: freeing an already-freed result is a no-op.
+ */
+Napi::Value FreeWindowResult(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
   
-  if (result != 0) {
-    ThrowCError(env, result, errBuf);
+  WindowResultWrap* windows = WindowResultWrap::FromValue(env, info[0]);
+  if (!windows) return env.Undefined();
+  
+  windows->Release(env);
+  
+  return env.Undefined();
+}
+
+/**
+ * Wrapper: validatePrices
+ * Input: Float64Array | Float32Array prices | Number series id
+ * Output: Number index of the first NaN/infinite price, or -1 if all finite
+ * 
+ * Vectorized block scan; cheap enough to run synchronously on request input.
+ */
+Napi::Value ValidatePrices(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  PriceInput input;
+  if (!GetPriceArray(env, info[0], &input, true)) {
     return env.Null();
   }
   
-  Napi::Object resultObj = Napi::Object::New(env);
-  resultObj.Set("max", Napi::Number::New(env, max));
-  resultObj.Set("min", Napi::Number::New(env, min));
-  resultObj.Set("avg", Napi::Number::New(env, avg));
-  resultObj.Set("pattern", Napi::String::New(env, pattern));
+  size_t badIndex = 0;
+  int result = input.f32 ? validatePricesF32(input.f32, input.length, &badIndex)
+                         : validatePrices(input.f64, input.length, &badIndex);
+  if (result != 0) {
+    return Napi::Number::New(env, static_cast<double>(badIndex));
+  }
   
-  return resultObj;
+  return Napi::Number::New(env, -1);
 }
 
 /**
- * Wrapper: freeWindowResult
- * Input: External handle
- * Output: undefined
+ * Wrapper: getNativeDiagnostics
+ * Input: none
+ * Output: Object { isa, supportedIsas }
+ * 
+ * `isa` is the kernel variant libdsa selected at load time (or via DSA_ISA).
  */
-Napi::Value FreeWindowResult(const Napi::CallbackInfo& info) {
+Napi::Value GetNativeDiagnostics(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
-  if (info.Length() < 1 || !info[0].IsExternal()) {
-    Napi::TypeError::New(env, "Expected External handle").ThrowAsJavaScriptException();
-    return env.Undefined();
+  static const char* const kIsas[] = {"avx512", "avx2", "sse2", "generic"};
+  Napi::Array supported = Napi::Array::New(env);
+  uint32_t count = 0;
+  for (const char* isa : kIsas) {
+    if (isIsaSupported(isa)) {
+      supported.Set(count++, Napi::String::New(env, isa));
+    }
   }
   
-  void* windowHandle = info[0].As<Napi::External<void>>().Data();
-  freeWindowResult(windowHandle);
-  
-  return env.Undefined();
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("isa", Napi::String::New(env, getActiveIsa()));
+  result.Set("supportedIsas", supported);
+  return result;
+}
+
+/**
+ * Async worker: calculateStockSpan
+ * Resolves: Int32Array spans
+ */
+class StockSpanWorker : public PriceWorker {
+ public:
+  StockSpanWorker(Napi::Env env, Napi::Value inputValue, const PriceInput& input)
+      : PriceWorker(env, "dsa:calculateStockSpan", inputValue, input) {}
+
+  ~StockSpanWorker() override { free(spans_); }
+
+ protected:
+  void Execute() override {
+    int result = RunStockSpan(input_, &spans_, errBuf_);
+    if (result != 0) SetCError(result);
+  }
+
+  Napi::Value Resolve() override {
+    int32_t* spans = reinterpret_cast<int32_t*>(spans_);
+    spans_ = nullptr;  // Ownership moves to the ArrayBuffer
+    return WrapNativeArray(Env(), spans, input_.length);
+  }
+
+ private:
+  int* spans_ = nullptr;
+};
+
+/**
+ * Async worker: buildSegmentTree
+ * Resolves: SegmentTree
+ */
+class SegmentTreeWorker : public PriceWorker {
+ public:
+  SegmentTreeWorker(Napi::Env env, Napi::Value inputValue, const PriceInput& input)
+      : PriceWorker(env, "dsa:buildSegmentTree", inputValue, input) {}
+
+  ~SegmentTreeWorker() override { freeSegmentTree(treeHandle_); }
+
+ protected:
+  void Execute() override {
+    int result = RunSegmentTree(input_, &treeHandle_, errBuf_);
+    if (result != 0) SetCError(result);
+  }
+
+  Napi::Value Resolve() override {
+    void* handle = treeHandle_;
+    treeHandle_ = nullptr;  // Ownership moves to the SegmentTree object
+    return SegmentTreeWrap::NewInstance(Env(), handle);
+  }
+
+ private:
+  void* treeHandle_ = nullptr;
+};
+
+/**
+ * Async worker: analyzeSlidingWindow
+ * Resolves: WindowResult
+ */
+class SlidingWindowWorker : public PriceWorker {
+ public:
+  SlidingWindowWorker(Napi::Env env, Napi::Value inputValue, const PriceInput& input,
+                      size_t windowSize)
+      : PriceWorker(env, "dsa:analyzeSlidingWindow", inputValue, input),
+        windowSize_(windowSize) {}
+
+  ~SlidingWindowWorker() override { freeWindowResult(windowHandle_); }
+
+ protected:
+  void Execute() override {
+    int result = RunSlidingWindow(input_, windowSize_, &windowHandle_, errBuf_);
+    if (result != 0) SetCError(result);
+  }
+
+  Napi::Value Resolve() override {
+    void* handle = windowHandle_;
+    windowHandle_ = nullptr;  // Ownership moves to the WindowResult object
+    return WindowResultWrap::NewInstance(Env(), handle);
+  }
+
+ private:
+  size_t windowSize_;
+  void* windowHandle_ = nullptr;
+};
+
+/**
+ * Wrapper: calculateStockSpanAsync
+ * Input: Float64Array | Float32Array prices | Number series id
+ * Output: Promise<Int32Array>
+ */
+Napi::Value CalculateStockSpanAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  PriceInput input;
+  if (!GetPriceArray(env, info[0], &input)) {
+    return env.Null();
+  }
+
+  StockSpanWorker* worker = new StockSpanWorker(env, info[0], input);
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
+
+/**
+ * Wrapper: buildSegmentTreeAsync
+ * Input: Float64Array | Float32Array prices | Number series id
+ * Output: Promise<SegmentTree>
+ */
+Napi::Value BuildSegmentTreeAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  PriceInput input;
+  if (!GetPriceArray(env, info[0], &input)) {
+    return env.Null();
+  }
+
+  SegmentTreeWorker* worker = new SegmentTreeWorker(env, info[0], input);
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
+
+/**
+ * Wrapper: analyzeSlidingWindowAsync
+ * Input: Float64Array | Float32Array prices | Number series id, Number windowSize
+ * Output: Promise<WindowResult>
+ */
+Napi::Value AnalyzeSlidingWindowAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (Float64Array | Float32Array | series id, Number)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  PriceInput input;
+  if (!GetPriceArray(env, info[0], &input)) {
+    return env.Null();
+  }
+
+  size_t windowSize = info[1].As<Napi::Number>().Uint32Value();
+  if (windowSize == 0) {
+    Napi::TypeError::New(env, "Invalid array length or window size").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  SlidingWindowWorker* worker = new SlidingWindowWorker(env, info[0], input, windowSize);
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
+
+/**
+ * Async worker: serializeWindows
+ * Resolves: Buffer of JSON or NDJSON text
+ *
+ * Pins the WindowResult's handle so free() from JS cannot pull it out from
+ * under Execute().
+ */
+class WindowJsonWorker : public Napi::AsyncWorker {
+ public:
+  WindowJsonWorker(Napi::Env env, std::shared_ptr<void> handle, WindowFormat format)
+      : Napi::AsyncWorker(env, "dsa:serializeWindows"),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        handle_(std::move(handle)),
+        format_(format) {}
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+ protected:
+  void Execute() override {
+    int result = EncodeAllWindows(handle_.get(), format_, output_, errBuf_, ERR_BUF_SIZE);
+    if (result != 0) SetError(FormatCError(result, errBuf_));
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::HandleScope scope(env);
+    handle_.reset();
+
+    size_t size = output_.Size();
+    deferred_.Resolve(WrapNativeBuffer(env, output_.Release(), size));
+  }
+
+  void OnError(const Napi::Error& error) override {
+    handle_.reset();
+    deferred_.Reject(error.Value());
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  std::shared_ptr<void> handle_;
+  WindowFormat format_;
+  ByteBuffer output_;
+  char errBuf_[ERR_BUF_SIZE] = {0};
+};
+
+/**
+ * Helper: Parse an optional "json" | "ndjson" argument
+ */
+static bool GetWindowFormat(Napi::Env env, const Napi::Value& value, WindowFormat* outFormat) {
+  if (value.IsUndefined()) {
+    *outFormat = WindowFormat::Json;
+    return true;
+  }
+
+  std::string name = value.IsString() ? value.As<Napi::String>().Utf8Value() : "";
+  if (name == "json") {
+    *outFormat = WindowFormat::Json;
+  } else if (name == "ndjson") {
+    *outFormat = WindowFormat::Ndjson;
+  } else {
+    Napi::TypeError::New(env, "Format must be 'json' or 'ndjson'").ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Wrapper: serializeWindows
+ * Input: WindowResult handle, optional String format ("json" | "ndjson")
+ * Output: Promise<Buffer>
+ */
+Napi::Value SerializeWindows(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  WindowResultWrap* windows = WindowResultWrap::FromValue(env, info[0]);
+  if (!windows) return env.Null();
+
+  WindowFormat format;
+  if (!GetWindowFormat(env, info[1], &format)) return env.Null();
+
+  std::shared_ptr<void> handle = windows->Pin(env);
+  if (!handle) return env.Null();
+
+  WindowJsonWorker* worker = new WindowJsonWorker(env, std::move(handle), format);
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
+
+/**
+ * JS class: WindowChunkIterator
+ *
+ * Streams a WindowResult as JSON / NDJSON in chunks of `chunkWindows`
+ * windows. Each next() encodes one chunk on the libuv threadpool and
+ * resolves a Buffer, or null once every window has been produced. The
+ * WindowResult's handle stays pinned (see WindowResultWrap::Pin) until the
+ * last chunk, close(), or finalization of the iterator.
+ */
+class WindowIteratorWrap : public Napi::ObjectWrap<WindowIteratorWrap> {
+ public:
+  static Napi::Function Init(Napi::Env env);
+  static Napi::Object NewInstance(Napi::Env env, const Napi::Value& windows,
+                                  const Napi::Value& format, const Napi::Value& chunkWindows);
+
+  explicit WindowIteratorWrap(const Napi::CallbackInfo& info);
+  void Finalize(Napi::Env env) override;
+
+  // Called by the chunk worker when a chunk settles
+  void ChunkDone(size_t end);
+
+ private:
+  Napi::Value Next(const Napi::CallbackInfo& info);
+  Napi::Value Close(const Napi::CallbackInfo& info);
+  Napi::Value GetPosition(const Napi::CallbackInfo& info);
+  Napi::Value GetCount(const Napi::CallbackInfo& info);
+  Napi::Value GetDone(const Napi::CallbackInfo& info);
+
+  void Unpin();
+
+  std::shared_ptr<void> handle_;
+  WindowFormat format_ = WindowFormat::Json;
+  size_t chunkWindows_ = 0;
+  size_t count_ = 0;
+  size_t position_ = 0;
+  bool busy_ = false;
+  bool closeRequested_ = false;
+};
+
+/**
+ * Async worker: WindowChunkIterator.next()
+ * Resolves: Buffer (one encoded chunk)
+ */
+class WindowChunkWorker : public Napi::AsyncWorker {
+ public:
+  WindowChunkWorker(Napi::Env env, Napi::Object iteratorObj, WindowIteratorWrap* iterator,
+                    std::shared_ptr<void> handle, WindowFormat format, size_t start, size_t end,
+                    size_t count)
+      : Napi::AsyncWorker(env, "dsa:windowChunk"),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        iteratorRef_(Napi::Persistent(iteratorObj)),
+        iterator_(iterator),
+        handle_(std::move(handle)),
+        format_(format),
+        start_(start),
+        end_(end),
+        count_(count) {}
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+ protected:
+  void Execute() override {
+    bool json = format_ == WindowFormat::Json;
+    bool ok = (!json || start_ > 0 || output_.Append("[", 1));
+
+    int result = ok ? EncodeWindows(handle_.get(), start_, end_, format_, output_, errBuf_, ERR_BUF_SIZE) : -3;
+    if (result == 0 && json && end_ == count_ && !output_.Append("]", 1)) result = -3;
+
+    if (result == -3 && errBuf_[0] == '\0') {
+      snprintf(errBuf_, ERR_BUF_SIZE, "Memory allocation failed for JSON output");
+    }
+    if (result != 0) SetError(FormatCError(result, errBuf_));
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::HandleScope scope(env);
+    iterator_->ChunkDone(end_);
+
+    size_t size = output_.Size();
+    deferred_.Resolve(WrapNativeBuffer(env, output_.Release(), size));
+  }
+
+  void OnError(const Napi::Error& error) override {
+    iterator_->ChunkDone(count_);  // Abandon the iteration
+    deferred_.Reject(error.Value());
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  Napi::ObjectReference iteratorRef_;
+  WindowIteratorWrap* iterator_;
+  std::shared_ptr<void> handle_;
+  WindowFormat format_;
+  size_t start_;
+  size_t end_;
+  size_t count_;
+  ByteBuffer output_;
+  char errBuf_[ERR_BUF_SIZE] = {0};
+};
+
+Napi::Function WindowIteratorWrap::Init(Napi::Env env) {
+  return DefineClass(env, "WindowChunkIterator", {
+    InstanceMethod("next", &WindowIteratorWrap::Next),
+    InstanceMethod("close", &WindowIteratorWrap::Close),
+    InstanceAccessor("position", &WindowIteratorWrap::GetPosition, nullptr),
+    InstanceAccessor("count", &WindowIteratorWrap::GetCount, nullptr),
+    InstanceAccessor("done", &WindowIteratorWrap::GetDone, nullptr),
+  });
+}
+
+Napi::Object WindowIteratorWrap::NewInstance(Napi::Env env, const Napi::Value& windows,
+                                             const Napi::Value& format,
+                                             const Napi::Value& chunkWindows) {
+  AddonData* data = env.GetInstanceData<AddonData>();
+  return data->windowIteratorConstructor.New({windows, format, chunkWindows});
+}
+
+WindowIteratorWrap::WindowIteratorWrap(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<WindowIteratorWrap>(info) {
+  Napi::Env env = info.Env();
+
+  WindowResultWrap* windows = WindowResultWrap::FromValue(env, info[0]);
+  if (!windows) return;
+
+  if (!GetWindowFormat(env, info[1], &format_)) return;
+
+  if (!info[2].IsNumber() || info[2].As<Napi::Number>().Uint32Value() == 0) {
+    Napi::TypeError::New(env, "chunkWindows must be a positive number").ThrowAsJavaScriptException();
+    return;
+  }
+  chunkWindows_ = info[2].As<Napi::Number>().Uint32Value();
+
+  handle_ = windows->Pin(env);
+  if (!handle_) return;
+
+  count_ = getWindowResultCount(handle_.get());
+}
+
+void WindowIteratorWrap::Finalize(Napi::Env /*env*/) {
+  Unpin();
+}
+
+// Drops this iterator's share of the handle; never touches the
+// WindowResult object, which may already be finalized at env teardown
+void WindowIteratorWrap::Unpin() {
+  handle_.reset();
+}
+
+void WindowIteratorWrap::ChunkDone(size_t end) {
+  busy_ = false;
+  position_ = end;
+  if (position_ >= count_ || closeRequested_) {
+    position_ = count_;
+    Unpin();
+  }
+}
+
+Napi::Value WindowIteratorWrap::Next(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (busy_) {
+    Napi::Error::New(env, "next() called while a chunk is pending").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (!handle_) {
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    deferred.Resolve(env.Null());
+    return deferred.Promise();
+  }
+
+  size_t end = count_ - position_ < chunkWindows_ ? count_ : position_ + chunkWindows_;
+  busy_ = true;
+
+  WindowChunkWorker* worker = new WindowChunkWorker(
+      env, info.This().As<Napi::Object>(), this, handle_, format_, position_, end, count_);
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
+
+Napi::Value WindowIteratorWrap::Close(const Napi::CallbackInfo& info) {
+  if (busy_) {
+    closeRequested_ = true;  // Unpinned when the pending chunk settles
+  } else {
+    position_ = count_;
+    Unpin();
+  }
+  return info.Env().Undefined();
+}
+
+Napi::Value WindowIteratorWrap::GetPosition(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(position_));
+}
+
+Napi::Value WindowIteratorWrap::GetCount(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(count_));
+}
+
+Napi::Value WindowIteratorWrap::GetDone(const Napi::CallbackInfo& info) {
+  return Napi::Boolean::New(info.Env(), handle_ == nullptr);
+}
+
+/**
+ * Wrapper: createWindowIterator
+ * Input: WindowResult handle, String format ("json" | "ndjson"), Number chunkWindows
+ * Output: WindowChunkIterator
+ */
+Napi::Value CreateWindowIterator(const Napi::CallbackInfo& info) {
+  return WindowIteratorWrap::NewInstance(info.Env(), info[0], info[1], info[2]);
 }
 
 /**
  * Module initialization
  */
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  // Freed automatically when the environment shuts down
+  AddonData* data = new AddonData();
+  data->segmentTreeConstructor = Napi::Persistent(SegmentTreeWrap::Init(env));
+  data->windowResultConstructor = Napi::Persistent(WindowResultWrap::Init(env));
+  data->windowIteratorConstructor = Napi::Persistent(WindowIteratorWrap::Init(env));
+  env.SetInstanceData(data);
+
   exports.Set("calculateStockSpan", Napi::Function::New(env, CalculateStockSpan));
   exports.Set("buildSegmentTree", Napi::Function::New(env, BuildSegmentTree));
   exports.Set("querySegmentTree", Napi::Function::New(env, QuerySegmentTree));
@@ -275,6 +1161,22 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
   exports.Set("analyzeSlidingWindow", Napi::Function::New(env, AnalyzeSlidingWindow));
   exports.Set("getWindowResult", Napi::Function::New(env, GetWindowResult));
   exports.Set("freeWindowResult", Napi::Function::New(env, FreeWindowResult));
+  exports.Set("validatePrices", Napi::Function::New(env, ValidatePrices));
+  exports.Set("getNativeDiagnostics", Napi::Function::New(env, GetNativeDiagnostics));
+
+  // Promise-returning variants that run on the libuv threadpool
+  exports.Set("calculateStockSpanAsync", Napi::Function::New(env, CalculateStockSpanAsync));
+  exports.Set("buildSegmentTreeAsync", Napi::Function::New(env, BuildSegmentTreeAsync));
+  exports.Set("analyzeSlidingWindowAsync", Napi::Function::New(env, AnalyzeSlidingWindowAsync));
+  exports.Set("serializeWindows", Napi::Function::New(env, SerializeWindows));
+  exports.Set("createWindowIterator", Napi::Function::New(env, CreateWindowIterator));
+
+  InitBatchAnalysis(env, exports);
+  InitSeriesRegistry(env, exports);
+  InitTreeCache(env, exports);
+  InitColumnStore(env, exports);
+  InitChartParser(env, exports);
+  InitStats(env, exports);
   
   return exports;
 }
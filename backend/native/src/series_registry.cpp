@@ -0,0 +1,346 @@
+/**
+ * Process-wide price series registry and its bindings (see series_registry.h)
+ */
+
+#include "series_registry.h"
+#include "addon.h"
+#include "tree_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+extern "C" {
+  #include "price_validation.h"
+}
+
+// Growth floor for appended series, in values
+static const size_t kMinCapacity = 256;
+
+static std::shared_ptr<double> AllocValues(size_t capacity) {
+  return std::shared_ptr<double>(new double[capacity > 0 ? capacity : 1],
+                                 std::default_delete<double[]>());
+}
+
+SeriesRegistry& SeriesRegistry::Instance() {
+  // Leaked on purpose: worker threads may still hold snapshots at exit
+  static SeriesRegistry* registry = new SeriesRegistry();
+  return *registry;
+}
+
+void SeriesRegistry::Fill(Series* series, const double* values, size_t length) {
+  // Always a fresh buffer so existing snapshots keep the old values
+  series->buffer = AllocValues(length);
+  if (length > 0) {
+    std::memcpy(series->buffer.get(), values, length * sizeof(double));
+  }
+  series->length = length;
+  series->capacity = length;
+  series->version++;
+}
+
+void SeriesRegistry::FillInfo(const Series& series, SeriesInfo* out) {
+  out->symbol = series.symbol;
+  out->length = series.length;
+  out->capacity = series.capacity;
+  out->version = series.version;
+  out->refs = series.refs;
+}
+
+uint32_t SeriesRegistry::Register(const std::string& symbol, const double* values,
+                                  size_t length) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto found = bySymbol_.find(symbol);
+  if (found != bySymbol_.end()) {
+    Series& series = series_[found->second];
+    Fill(&series, values, length);
+    series.refs++;
+    return found->second;
+  }
+
+  uint32_t id = nextId_++;
+  Series& series = series_[id];
+  series.symbol = symbol;
+  Fill(&series, values, length);
+  series.refs = 1;
+  bySymbol_[symbol] = id;
+  return id;
+}
+
+bool SeriesRegistry::Append(uint32_t id, const double* values, size_t length,
+                            SeriesInfo* out) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto found = series_.find(id);
+  if (found == series_.end()) return false;
+  Series& series = found->second;
+
+  size_t needed = series.length + length;
+  if (needed > kMaxLength) return false;
+
+  if (needed > series.capacity) {
+    // Geometric growth into a new buffer; snapshots keep the old one
+    size_t capacity = std::min(kMaxLength,
+                               std::max({needed, series.capacity * 2, kMinCapacity}));
+    std::shared_ptr<double> grown = AllocValues(capacity);
+    if (series.length > 0) {
+      std::memcpy(grown.get(), series.buffer.get(), series.length * sizeof(double));
+    }
+    series.buffer = grown;
+    series.capacity = capacity;
+  }
+
+  // Past the end of every snapshot of this buffer, so readers are unaffected
+  if (length > 0) {
+    std::memcpy(series.buffer.get() + series.length, values, length * sizeof(double));
+  }
+  series.length = needed;
+  series.version++;
+
+  if (out) FillInfo(series, out);
+  return true;
+}
+
+bool SeriesRegistry::Release(uint32_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto found = series_.find(id);
+  if (found == series_.end()) return false;
+
+  if (--found->second.refs == 0) {
+    bySymbol_.erase(found->second.symbol);
+    series_.erase(found);
+  }
+  return true;
+}
+
+bool SeriesRegistry::Snapshot(uint32_t id, SeriesSnapshot* out) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto found = series_.find(id);
+  if (found == series_.end()) return false;
+
+  out->data = found->second.buffer;
+  out->length = found->second.length;
+  out->version = found->second.version;
+  return true;
+}
+
+bool SeriesRegistry::Info(uint32_t id, SeriesInfo* out) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto found = series_.find(id);
+  if (found == series_.end()) return false;
+
+  FillInfo(found->second, out);
+  return true;
+}
+
+bool SeriesRegistry::Find(const std::string& symbol, uint32_t* outId) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto found = bySymbol_.find(symbol);
+  if (found == bySymbol_.end()) return false;
+
+  *outId = found->second;
+  return true;
+}
+
+bool GetSeriesId(Napi::Env env, const Napi::Value& value, uint32_t* outId) {
+  double raw = value.IsNumber() ? value.As<Napi::Number>().DoubleValue() : -1;
+  if (!(raw >= 1 && raw <= UINT32_MAX && std::floor(raw) == raw)) {
+    Napi::TypeError::New(env, "Expected series id").ThrowAsJavaScriptException();
+    return false;
+  }
+  *outId = static_cast<uint32_t>(raw);
+  return true;
+}
+
+/**
+ * Helper: Point at Float64Array values (or widen a Float32Array into
+ * `scratch`) and check they are all finite
+ * Returns false (with a pending JS exception) on bad input.
+ */
+static bool GetSeriesValues(Napi::Env env, const Napi::Value& value,
+                            std::vector<double>* scratch, const double** outData,
+                            size_t* outLength) {
+  napi_typedarray_type type = value.IsTypedArray()
+      ? value.As<Napi::TypedArray>().TypedArrayType()
+      : napi_int8_array;
+
+  if (type == napi_float64_array) {
+    Napi::Float64Array array = value.As<Napi::Float64Array>();
+    *outData = array.Data();
+    *outLength = array.ElementLength();
+  } else if (type == napi_float32_array) {
+    Napi::Float32Array array = value.As<Napi::Float32Array>();
+    scratch->assign(array.Data(), array.Data() + array.ElementLength());
+    *outData = scratch->data();
+    *outLength = scratch->size();
+  } else {
+    Napi::TypeError::New(env, "Expected Float64Array or Float32Array of prices")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+
+  size_t badIndex = 0;
+  if (validatePrices(*outData, *outLength, &badIndex) != 0) {
+    Napi::RangeError::New(env, "Price at index " + std::to_string(badIndex) + " is not finite")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Helper: Series info as a JS object
+ */
+static Napi::Object SeriesInfoToObject(Napi::Env env, uint32_t id, const SeriesInfo& info) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("id", Napi::Number::New(env, id));
+  result.Set("symbol", Napi::String::New(env, info.symbol));
+  result.Set("length", Napi::Number::New(env, static_cast<double>(info.length)));
+  result.Set("version", Napi::Number::New(env, static_cast<double>(info.version)));
+  result.Set("refs", Napi::Number::New(env, info.refs));
+  result.Set("byteLength",
+             Napi::Number::New(env, static_cast<double>(info.capacity * sizeof(double))));
+  return result;
+}
+
+/**
+ * Wrapper: registerSeries
+ * Input: String symbol, Float64Array | Float32Array prices
+ * Output: Number series id
+ */
+static Napi::Value RegisterSeries(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected (String, Float64Array | Float32Array)")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::vector<double> scratch;
+  const double* values = nullptr;
+  size_t length = 0;
+  if (!GetSeriesValues(env, info[1], &scratch, &values, &length)) {
+    return env.Null();
+  }
+  if (length > SeriesRegistry::kMaxLength) {
+    Napi::RangeError::New(env, "Series too long").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  uint32_t id = SeriesRegistry::Instance().Register(
+      info[0].As<Napi::String>().Utf8Value(), values, length);
+  return Napi::Number::New(env, id);
+}
+
+/**
+ * Wrapper: appendSeries
+ * Input: Number id, Float64Array | Float32Array prices
+ * Output: Object {id, symbol, length, version, refs, byteLength}
+ */
+static Napi::Value AppendSeries(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  uint32_t id = 0;
+  if (!GetSeriesId(env, info[0], &id)) {
+    return env.Null();
+  }
+
+  std::vector<double> scratch;
+  const double* values = nullptr;
+  size_t length = 0;
+  if (!GetSeriesValues(env, info[1], &scratch, &values, &length)) {
+    return env.Null();
+  }
+
+  SeriesRegistry& registry = SeriesRegistry::Instance();
+  SeriesInfo seriesInfo;
+  if (!registry.Append(id, values, length, &seriesInfo)) {
+    bool known = registry.Info(id, &seriesInfo);
+    Napi::RangeError::New(env, known ? std::string("Series too long")
+                                     : "Unknown series id " + std::to_string(id))
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  return SeriesInfoToObject(env, id, seriesInfo);
+}
+
+/**
+ * Wrapper: releaseSeries
+ * Input: Number id
+ * Output: Boolean (false if the id was unknown)
+ */
+static Napi::Value ReleaseSeries(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  uint32_t id = 0;
+  if (!GetSeriesId(env, info[0], &id)) {
+    return env.Null();
+  }
+
+  SeriesRegistry& registry = SeriesRegistry::Instance();
+  if (!registry.Release(id)) {
+    return Napi::Boolean::New(env, false);
+  }
+
+  // Last reference gone: drop its cached segment tree too
+  SeriesInfo seriesInfo;
+  if (!registry.Info(id, &seriesInfo)) {
+    TreeCache::Instance().Erase(id);
+  }
+  return Napi::Boolean::New(env, true);
+}
+
+/**
+ * Wrapper: getSeriesInfo
+ * Input: Number id
+ * Output: Object {id, symbol, length, version, refs, byteLength} | null
+ */
+static Napi::Value GetSeriesInfo(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  uint32_t id = 0;
+  if (!GetSeriesId(env, info[0], &id)) {
+    return env.Null();
+  }
+
+  SeriesInfo seriesInfo;
+  if (!SeriesRegistry::Instance().Info(id, &seriesInfo)) {
+    return env.Null();
+  }
+  return SeriesInfoToObject(env, id, seriesInfo);
+}
+
+/**
+ * Wrapper: findSeries
+ * Input: String symbol
+ * Output: Number series id | null
+ */
+static Napi::Value FindSeries(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected String symbol").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  uint32_t id = 0;
+  if (!SeriesRegistry::Instance().Find(info[0].As<Napi::String>().Utf8Value(), &id)) {
+    return env.Null();
+  }
+  return Napi::Number::New(env, id);
+}
+
+void InitSeriesRegistry(Napi::Env env, Napi::Object exports) {
+  exports.Set("registerSeries", Napi::Function::New(env, RegisterSeries));
+  exports.Set("appendSeries", Napi::Function::New(env, AppendSeries));
+  exports.Set("releaseSeries", Napi::Function::New(env, ReleaseSeries));
+  exports.Set("getSeriesInfo", Napi::Function::New(env, GetSeriesInfo));
+  exports.Set("findSeries", Napi::Function::New(env, FindSeries));
+}
@@ -0,0 +1,106 @@
+/**
+ * Interned price series referenced by id
+ *
+ * A series is uploaded (and validated) once with registerSeries and then
+ * passed to span, segment tree and sliding window calls by numeric id, so
+ * repeated analyses of the same symbol skip the JS allocation and the
+ * marshalling of a fresh typed array.
+ *
+ * The registry is process-wide: every addon instance (main thread and
+ * worker_threads) sees the same series. Each registerSeries call adds a
+ * reference and releaseSeries drops one; the series is removed when the
+ * last reference goes. Calls in flight hold a snapshot, which keeps the
+ * values they read alive even if the series is released or replaced.
+ */
+
+#ifndef DSA_SERIES_REGISTRY_H
+#define DSA_SERIES_REGISTRY_H
+
+#include <napi.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * A consistent view of a series: `length` values at `data`
+ *
+ * Appends write past the end of existing snapshots (or into a new buffer),
+ * so a snapshot never changes while it is held.
+ */
+struct SeriesSnapshot {
+  std::shared_ptr<const double> data;
+  size_t length = 0;
+  uint64_t version = 0;
+};
+
+struct SeriesInfo {
+  std::string symbol;
+  size_t length = 0;
+  size_t capacity = 0;
+  uint64_t version = 0;
+  uint32_t refs = 0;
+};
+
+class SeriesRegistry {
+ public:
+  static SeriesRegistry& Instance();
+
+  /**
+   * Register `symbol` with a copy of `values` and add a reference.
+   * An already registered symbol keeps its id and has its values replaced.
+   */
+  uint32_t Register(const std::string& symbol, const double* values, size_t length);
+
+  /**
+   * Append values (amortized O(k)); false if the id is unknown or the
+   * series would exceed kMaxLength
+   */
+  bool Append(uint32_t id, const double* values, size_t length, SeriesInfo* out);
+
+  /**
+   * Drop one reference; false if the id is unknown
+   */
+  bool Release(uint32_t id);
+
+  bool Snapshot(uint32_t id, SeriesSnapshot* out) const;
+  bool Info(uint32_t id, SeriesInfo* out) const;
+  bool Find(const std::string& symbol, uint32_t* outId) const;
+
+  // Same limit libdsa applies to a single input array
+  static constexpr size_t kMaxLength = 10000000;
+
+ private:
+  struct Series {
+    std::string symbol;
+    std::shared_ptr<double> buffer;
+    size_t length = 0;
+    size_t capacity = 0;
+    uint64_t version = 0;
+    uint32_t refs = 0;
+  };
+
+  static void Fill(Series* series, const double* values, size_t length);
+  static void FillInfo(const Series& series, SeriesInfo* out);
+
+  mutable std::mutex mutex_;
+  std::unordered_map<uint32_t, Series> series_;
+  std::unordered_map<std::string, uint32_t> bySymbol_;
+  uint32_t nextId_ = 1;
+};
+
+/**
+ * Helper: Read a series id argument
+ * Returns false (with a pending JS exception) if the value is not an id.
+ */
+bool GetSeriesId(Napi::Env env, const Napi::Value& value, uint32_t* outId);
+
+/**
+ * Register registerSeries / appendSeries / releaseSeries / getSeriesInfo /
+ * findSeries exports
+ */
+void InitSeriesRegistry(Napi::Env env, Napi::Object exports);
+
+#endif  // DSA_SERIES_REGISTRY_H
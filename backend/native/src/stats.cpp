@@ -0,0 +1,97 @@
+/**
+ * libdsa call statistics bindings
+ *
+ * getNativeStats() copies libdsa's per-function counters and latency
+ * histograms (dsa_stats.h) into plain JS values. The counters are
+ * process-wide: calls from every addon instance, worker thread and the
+ * batch pool are included. Collection is off unless DSA_STATS=1 is set or
+ * setNativeStatsEnabled(true) is called.
+ */
+
+#include "addon.h"
+#include <limits>
+#include <memory>
+
+extern "C" {
+  #include "dsa_stats.h"
+}
+
+/**
+ * Wrapper: getNativeStats
+ * Input: none
+ * Output: Object {enabled, bucketBoundsNs: Float64Array (exclusive upper
+ *         bounds; the last is Infinity), functions: {[name]: {calls, errors,
+ *         elements, bytesAllocated, totalNs, histogram: Float64Array}}}
+ *
+ * Counters are exact up to 2^53 (they are returned as doubles).
+ */
+static Napi::Value GetNativeStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  auto stats = std::make_unique<DsaStats>();
+  getDsaStats(stats.get());
+
+  Napi::Float64Array bounds = Napi::Float64Array::New(env, DSA_STAT_BUCKETS);
+  for (size_t b = 0; b < DSA_STAT_BUCKETS; b++) {
+    uint64_t bound = getDsaStatBucketBound(b);
+    bounds[b] = bound == UINT64_MAX ? std::numeric_limits<double>::infinity()
+                                    : static_cast<double>(bound);
+  }
+
+  Napi::Object functions = Napi::Object::New(env);
+  for (int f = 0; f < DSA_STAT_COUNT; f++) {
+    const DsaFunctionStats& s = stats->functions[f];
+    Napi::Float64Array histogram = Napi::Float64Array::New(env, DSA_STAT_BUCKETS);
+    for (size_t b = 0; b < DSA_STAT_BUCKETS; b++) {
+      histogram[b] = static_cast<double>(s.histogram[b]);
+    }
+
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("calls", Napi::Number::New(env, static_cast<double>(s.calls)));
+    entry.Set("errors", Napi::Number::New(env, static_cast<double>(s.errors)));
+    entry.Set("elements", Napi::Number::New(env, static_cast<double>(s.elements)));
+    entry.Set("bytesAllocated", Napi::Number::New(env, static_cast<double>(s.bytes_allocated)));
+    entry.Set("totalNs", Napi::Number::New(env, static_cast<double>(s.total_ns)));
+    entry.Set("histogram", histogram);
+    functions.Set(getDsaStatName(f), entry);
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("enabled", Napi::Boolean::New(env, stats->enabled != 0));
+  result.Set("bucketBoundsNs", bounds);
+  result.Set("functions", functions);
+  return result;
+}
+
+/**
+ * Wrapper: setNativeStatsEnabled
+ * Input: boolean
+ * Output: undefined
+ */
+static Napi::Value SetNativeStatsEnabled(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsBoolean()) {
+    Napi::TypeError::New(env, "Expected boolean as first argument").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  setDsaStatsEnabled(info[0].As<Napi::Boolean>().Value() ? 1 : 0);
+  return env.Undefined();
+}
+
+/**
+ * Wrapper: resetNativeStats
+ * Input: none
+ * Output: undefined
+ */
+static Napi::Value ResetNativeStats(const Napi::CallbackInfo& info) {
+  resetDsaStats();
+  return info.Env().Undefined();
+}
+
+void InitStats(Napi::Env env, Napi::Object exports) {
+  exports.Set("getNativeStats", Napi::Function::New(env, GetNativeStats));
+  exports.Set("setNativeStatsEnabled", Napi::Function::New(env, SetNativeStatsEnabled));
+  exports.Set("resetNativeStats", Napi::Function::New(env, ResetNativeStats));
+}
@@ -0,0 +1,172 @@
+/**
+ * Work-stealing thread pool implementation
+ */
+
+#include "thread_pool.h"
+
+#include <cstdlib>
+
+struct WorkStealingPool::Batch {
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t remaining;
+};
+
+WorkStealingPool::WorkStealingPool(size_t numThreads) {
+  if (numThreads == 0) numThreads = 1;
+
+  queues_.reserve(numThreads);
+  for (size_t i = 0; i < numThreads; i++) {
+    queues_.push_back(std::make_unique<WorkerQueue>());
+  }
+
+  workers_.reserve(numThreads);
+  for (size_t i = 0; i < numThreads; i++) {
+    workers_.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void WorkStealingPool::RunAll(std::vector<Task>& tasks) {
+  if (tasks.empty()) return;
+
+  Batch batch;
+  batch.remaining = tasks.size();
+
+  size_t numQueues = queues_.size();
+  size_t start;
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    start = nextQueue_;
+    nextQueue_ = (nextQueue_ + tasks.size()) % numQueues;
+  }
+
+  // Spread tasks round-robin so every worker starts with local work
+  for (size_t i = 0; i < tasks.size(); i++) {
+    WorkerQueue& queue = *queues_[(start + i) % numQueues];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back({&tasks[i], &batch});
+    queued_++;  // Under the queue lock, so a pop can never count it first
+  }
+
+  {
+    // Workers test queued_ under this lock before sleeping; taking it
+    // here means none can miss the notify below
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+  }
+  wake_.notify_all();
+
+  // Help out until nothing is left to steal, then wait for stragglers
+  QueuedTask item;
+  while (Steal(start, item)) {
+    RunTask(item);
+
+    std::lock_guard<std::mutex> lock(batch.mutex);
+    if (batch.remaining == 0) break;
+  }
+
+  // Always take the batch lock before returning: the last RunTask may
+  // still be notifying, and `batch` lives on this stack frame.
+  std::unique_lock<std::mutex> lock(batch.mutex);
+  batch.done.wait(lock, [&batch] { return batch.remaining == 0; });
+}
+
+void WorkStealingPool::WorkerLoop(size_t self) {
+  for (;;) {
+    QueuedTask item;
+    if (PopLocal(self, item) || Steal(self + 1, item)) {
+      RunTask(item);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    wake_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+    if (stop_ && queued_.load() == 0) return;
+  }
+}
+
+bool WorkStealingPool::PopLocal(size_t self, QueuedTask& out) {
+  WorkerQueue& queue = *queues_[self];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) return false;
+
+  // Owner takes the most recently pushed task (LIFO)
+  out = queue.tasks.back();
+  queue.tasks.pop_back();
+  queued_--;
+  return true;
+}
+
+bool WorkStealingPool::Steal(size_t start, QueuedTask& out) {
+  size_t numQueues = queues_.size();
+  for (size_t k = 0; k < numQueues; k++) {
+    WorkerQueue& queue = *queues_[(start + k) % numQueues];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) continue;
+
+    // Thieves take the oldest task (FIFO) to keep contention at opposite ends
+    out = queue.tasks.front();
+    queue.tasks.pop_front();
+    queued_--;
+    return true;
+  }
+  return false;
+}
+
+void WorkStealingPool::RunTask(const QueuedTask& item) {
+  (*item.task)();
+
+  Batch* batch = item.batch;
+  std::lock_guard<std::mutex> lock(batch->mutex);
+  if (--batch->remaining == 0) {
+    batch->done.notify_all();
+  }
+}
+
+size_t WorkStealingPool::DefaultSize() {
+  const char* configured = std::getenv("DSA_NATIVE_THREADS");
+  if (configured) {
+    long value = std::strtol(configured, nullptr, 10);
+    if (value > 0) return static_cast<size_t>(value);
+  }
+
+  unsigned int cores = std::thread::hardware_concurrency();
+  return cores > 0 ? cores : 1;
+}
+
+// The shared pool is intentionally never destroyed: joining workers during
+// static destruction could block process exit behind an in-flight batch.
+static std::mutex sharedPoolMutex;
+static std::shared_ptr<WorkStealingPool>* sharedPool = new std::shared_ptr<WorkStealingPool>();
+
+std::shared_ptr<WorkStealingPool> WorkStealingPool::Shared() {
+  std::lock_guard<std::mutex> lock(sharedPoolMutex);
+  if (!*sharedPool) {
+    *sharedPool = std::make_shared<WorkStealingPool>(DefaultSize());
+  }
+  return *sharedPool;
+}
+
+void WorkStealingPool::ResizeShared(size_t numThreads) {
+  std::shared_ptr<WorkStealingPool> replacement =
+      std::make_shared<WorkStealingPool>(numThreads > 0 ? numThreads : DefaultSize());
+
+  std::shared_ptr<WorkStealingPool> previous;
+  {
+    std::lock_guard<std::mutex> lock(sharedPoolMutex);
+    previous = *sharedPool;
+    *sharedPool = replacement;
+  }
+  // `previous` joins its (idle) workers here unless a batch still holds it
+}
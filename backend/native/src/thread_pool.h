@@ -0,0 +1,87 @@
+/**
+ * Work-stealing thread pool for batch analysis
+ *
+ * Each worker owns a deque of tasks: it pops its own work LIFO (cache-warm)
+ * and, when empty, steals FIFO from other workers so long and short series
+ * even out across cores. The pool is independent of the libuv threadpool,
+ * whose few threads stay free for I/O and single-series calls.
+ */
+
+#ifndef DSA_THREAD_POOL_H
+#define DSA_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+ public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingPool(size_t numThreads);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  size_t Size() const { return workers_.size(); }
+
+  /**
+   * Run every task and block until all have finished.
+   *
+   * Tasks are spread round-robin across worker deques. The calling thread
+   * steals work too instead of idling, so a batch never waits on a busy
+   * pool. Tasks must not throw.
+   */
+  void RunAll(std::vector<Task>& tasks);
+
+  /**
+   * Process-wide pool shared by every addon instance (main thread and
+   * worker_threads), created on first use. Default size comes from
+   * DSA_NATIVE_THREADS, else the hardware concurrency.
+   */
+  static std::shared_ptr<WorkStealingPool> Shared();
+
+  /**
+   * Replace the shared pool with one of `numThreads` workers (0 restores
+   * the default). Batches already running keep the old pool until done.
+   */
+  static void ResizeShared(size_t numThreads);
+
+  static size_t DefaultSize();
+
+ private:
+  struct Batch;
+
+  struct QueuedTask {
+    Task* task;
+    Batch* batch;
+  };
+
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<QueuedTask> tasks;
+  };
+
+  void WorkerLoop(size_t self);
+  bool PopLocal(size_t self, QueuedTask& out);
+  bool Steal(size_t start, QueuedTask& out);
+  static void RunTask(const QueuedTask& item);
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> workers_;
+
+  std::mutex sleepMutex_;
+  std::condition_variable wake_;
+  std::atomic<size_t> queued_{0};  // Changed only under a queue mutex
+  bool stop_ = false;
+  size_t nextQueue_ = 0;
+};
+
+#endif  // DSA_THREAD_POOL_H
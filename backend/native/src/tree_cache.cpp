@@ -0,0 +1,328 @@
+/**
+ * Segment tree cache and its bindings (see tree_cache.h)
+ */
+
+#include "tree_cache.h"
+#include "addon.h"
+
+extern "C" {
+  #include "segment_tree.h"
+}
+
+CachedTree::~CachedTree() {
+  freeSegmentTree(handle);
+}
+
+TreeCache& TreeCache::Instance() {
+  // Leaked on purpose, like the series registry
+  static TreeCache* cache = new TreeCache();
+  return *cache;
+}
+
+size_t TreeCache::DefaultBudget() {
+  const char* env = getenv("DSA_TREE_CACHE_MB");
+  if (env && *env) {
+    char* end = nullptr;
+    unsigned long long mb = strtoull(env, &end, 10);
+    if (end && *end == '\0') return static_cast<size_t>(mb) << 20;
+  }
+  return static_cast<size_t>(256) << 20;
+}
+
+std::shared_ptr<CachedTree> TreeCache::Lookup(uint32_t id, uint64_t version) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto found = entries_.find(id);
+  if (found == entries_.end() || found->second.version != version ||
+      !found->second.tree->built || found->second.tree->error != 0) {
+    return nullptr;
+  }
+
+  hits_++;
+  lru_.splice(lru_.begin(), lru_, found->second.lru);
+  return found->second.tree;
+}
+
+std::shared_ptr<CachedTree> TreeCache::Acquire(uint32_t id, const SeriesSnapshot& snapshot) {
+  std::shared_ptr<CachedTree> tree;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto found = entries_.find(id);
+    if (found != entries_.end() && found->second.version == snapshot.version) {
+      // Built or being built: share it
+      hits_++;
+      lru_.splice(lru_.begin(), lru_, found->second.lru);
+      tree = found->second.tree;
+    } else if (found != entries_.end() && found->second.version > snapshot.version) {
+      // Snapshot taken before the series changed: build a private tree
+      // rather than displacing the newer one
+      misses_++;
+      tree = std::make_shared<CachedTree>();
+    } else {
+      // Miss, or a tree over older values of the series
+      if (found != entries_.end()) RemoveLocked(found);
+      misses_++;
+      tree = std::make_shared<CachedTree>();
+      lru_.push_front(id);
+      entries_[id] = Entry{snapshot.version, tree, lru_.begin()};
+    }
+  }
+
+  // One thread builds; the others wait here and reuse its result
+  {
+    std::lock_guard<std::mutex> build(tree->buildMutex);
+    if (!tree->built) {
+      char errBuf[ERR_BUF_SIZE] = {0};
+      tree->error = buildSegmentTree(snapshot.data.get(), snapshot.length, &tree->handle,
+                                     errBuf, ERR_BUF_SIZE);
+      if (tree->error != 0) {
+        tree->errorMessage = errBuf;
+      } else {
+        tree->byteLength = getSegmentTreeMemoryUsage(tree->handle);
+      }
+      tree->built = true;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = entries_.find(id);
+  if (found == entries_.end() || found->second.tree != tree) {
+    return tree;  // Evicted or replaced meanwhile; still usable by this caller
+  }
+  if (tree->error != 0) {
+    RemoveLocked(found);
+  } else if (found->second.charged == 0) {
+    found->second.charged = tree->byteLength;
+    byteLength_ += tree->byteLength;
+    EvictLocked();
+  }
+  return tree;
+}
+
+void TreeCache::RemoveLocked(EntryMap::iterator found) {
+  byteLength_ -= found->second.charged;
+  lru_.erase(found->second.lru);
+  entries_.erase(found);
+}
+
+void TreeCache::EvictLocked() {
+  auto it = lru_.end();
+  while (byteLength_ > budget_ && it != lru_.begin()) {
+    --it;
+    auto found = entries_.find(*it);
+    if (found->second.charged == 0) continue;  // Still building
+
+    byteLength_ -= found->second.charged;
+    it = lru_.erase(it);
+    entries_.erase(found);
+    evictions_++;
+  }
+}
+
+void TreeCache::Erase(uint32_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = entries_.find(id);
+  if (found != entries_.end()) RemoveLocked(found);
+}
+
+void TreeCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+  byteLength_ = 0;
+}
+
+void TreeCache::SetBudget(size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  budget_ = bytes;
+  EvictLocked();
+}
+
+TreeCacheStats TreeCache::Stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TreeCacheStats stats;
+  stats.entries = entries_.size();
+  stats.byteLength = byteLength_;
+  stats.budget = budget_;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.evictions = evictions_;
+  return stats;
+}
+
+struct RangeResult {
+  double min = 0;
+  double max = 0;
+  double avg = 0;
+  double variance = 0;
+};
+
+/**
+ * Helper: Query a cached tree; returns the C error code (message in outError)
+ */
+static int QueryCachedTree(const CachedTree& tree, size_t ql, size_t qr, RangeResult* out,
+                           std::string* outError) {
+  if (tree.error != 0) {
+    *outError = FormatCError(tree.error, tree.errorMessage.c_str());
+    return tree.error;
+  }
+
+  char errBuf[ERR_BUF_SIZE] = {0};
+  int result = querySegmentTree(tree.handle, ql, qr, &out->min, &out->max, &out->avg,
+                                &out->variance, errBuf, ERR_BUF_SIZE);
+  if (result != 0) *outError = FormatCError(result, errBuf);
+  return result;
+}
+
+/**
+ * Helper: Range statistics as {min, max, avg, variance}
+ */
+static Napi::Object RangeResultToObject(Napi::Env env, const RangeResult& range) {
+  Napi::Object resultObj = Napi::Object::New(env);
+  resultObj.Set("min", Napi::Number::New(env, range.min));
+  resultObj.Set("max", Napi::Number::New(env, range.max));
+  resultObj.Set("avg", Napi::Number::New(env, range.avg));
+  resultObj.Set("variance", Napi::Number::New(env, range.variance));
+  return resultObj;
+}
+
+/**
+ * Async worker: querySeriesRange cache miss (builds the tree)
+ * Resolves: Object {min, max, avg, variance}
+ */
+class SeriesRangeWorker : public Napi::AsyncWorker {
+ public:
+  SeriesRangeWorker(Napi::Env env, Napi::Promise::Deferred deferred, uint32_t id,
+                    SeriesSnapshot snapshot, size_t ql, size_t qr)
+      : Napi::AsyncWorker(env, "dsa:querySeriesRange"),
+        deferred_(deferred),
+        id_(id),
+        snapshot_(std::move(snapshot)),
+        ql_(ql),
+        qr_(qr) {}
+
+ protected:
+  void Execute() override {
+    std::shared_ptr<CachedTree> tree = TreeCache::Instance().Acquire(id_, snapshot_);
+    std::string error;
+    if (QueryCachedTree(*tree, ql_, qr_, &range_, &error) != 0) SetError(error);
+  }
+
+  void OnOK() override {
+    Napi::HandleScope scope(Env());
+    deferred_.Resolve(RangeResultToObject(Env(), range_));
+  }
+
+  void OnError(const Napi::Error& error) override {
+    deferred_.Reject(error.Value());
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  uint32_t id_;
+  SeriesSnapshot snapshot_;
+  size_t ql_;
+  size_t qr_;
+  RangeResult range_;
+};
+
+/**
+ * Wrapper: querySeriesRange
+ * Input: Number series id, Number ql, Number qr
+ * Output: Promise<{min, max, avg, variance}>
+ *
+ * A cached tree is queried immediately on the calling thread; a miss builds
+ * the tree on the libuv threadpool.
+ */
+static Napi::Value QuerySeriesRange(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 3 || !info[1].IsNumber() || !info[2].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (series id, Number, Number)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  uint32_t id = 0;
+  if (!GetSeriesId(env, info[0], &id)) {
+    return env.Null();
+  }
+
+  SeriesSnapshot snapshot;
+  if (!SeriesRegistry::Instance().Snapshot(id, &snapshot)) {
+    Napi::Error::New(env, "Unknown series id " + std::to_string(id)).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  size_t ql = info[1].As<Napi::Number>().Uint32Value();
+  size_t qr = info[2].As<Napi::Number>().Uint32Value();
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+
+  std::shared_ptr<CachedTree> tree = TreeCache::Instance().Lookup(id, snapshot.version);
+  if (tree) {
+    RangeResult range;
+    std::string error;
+    if (QueryCachedTree(*tree, ql, qr, &range, &error) != 0) {
+      deferred.Reject(Napi::Error::New(env, error).Value());
+    } else {
+      deferred.Resolve(RangeResultToObject(env, range));
+    }
+    return deferred.Promise();
+  }
+
+  SeriesRangeWorker* worker =
+      new SeriesRangeWorker(env, deferred, id, std::move(snapshot), ql, qr);
+  worker->Queue();
+  return deferred.Promise();
+}
+
+/**
+ * Wrapper: getTreeCacheStats
+ * Output: Object {entries, byteLength, budget, hits, misses, evictions}
+ */
+static Napi::Value GetTreeCacheStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  TreeCacheStats stats = TreeCache::Instance().Stats();
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("entries", Napi::Number::New(env, static_cast<double>(stats.entries)));
+  result.Set("byteLength", Napi::Number::New(env, static_cast<double>(stats.byteLength)));
+  result.Set("budget", Napi::Number::New(env, static_cast<double>(stats.budget)));
+  result.Set("hits", Napi::Number::New(env, static_cast<double>(stats.hits)));
+  result.Set("misses", Napi::Number::New(env, static_cast<double>(stats.misses)));
+  result.Set("evictions", Napi::Number::New(env, static_cast<double>(stats.evictions)));
+  return result;
+}
+
+/**
+ * Wrapper: setTreeCacheBudget
+ * Input: Number bytes (0 disables caching)
+ * Output: undefined
+ */
+static Napi::Value SetTreeCacheBudget(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber() || info[0].As<Napi::Number>().DoubleValue() < 0) {
+    Napi::TypeError::New(env, "Expected non-negative Number of bytes").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  TreeCache::Instance().SetBudget(static_cast<size_t>(info[0].As<Napi::Number>().DoubleValue()));
+  return env.Undefined();
+}
+
+/**
+ * Wrapper: clearTreeCache
+ * Output: undefined (trees in use are freed when their queries finish)
+ */
+static Napi::Value ClearTreeCache(const Napi::CallbackInfo& info) {
+  TreeCache::Instance().Clear();
+  return info.Env().Undefined();
+}
+
+void InitTreeCache(Napi::Env env, Napi::Object exports) {
+  exports.Set("querySeriesRange", Napi::Function::New(env, QuerySeriesRange));
+  exports.Set("getTreeCacheStats", Napi::Function::New(env, GetTreeCacheStats));
+  exports.Set("setTreeCacheBudget", Napi::Function::New(env, SetTreeCacheBudget));
+  exports.Set("clearTreeCache", Napi::Function::New(env, ClearTreeCache));
+}
@@ -0,0 +1,98 @@
+/**
+ * LRU cache of segment trees over registered series
+ *
+ * querySeriesRange(id, ql, qr) answers from a tree built over the series'
+ * current values; the tree is kept for later queries, so a repeated range
+ * query on a hot series costs only the O(log n) walk. Entries are keyed by
+ * series id and invalidated when the series version changes.
+ *
+ * Trees are reference-counted: concurrent queries share one tree (and one
+ * build, if they arrive while it is being built), and a tree evicted while
+ * queries are still running is freed when the last of them finishes. The
+ * cache evicts least recently used trees to stay within a byte budget
+ * (DSA_TREE_CACHE_MB, default 256; 0 disables caching). Process-wide,
+ * like the series registry.
+ */
+
+#ifndef DSA_TREE_CACHE_H
+#define DSA_TREE_CACHE_H
+
+#include "series_registry.h"
+
+#include <atomic>
+#include <list>
+
+struct CachedTree {
+  ~CachedTree();
+
+  std::mutex buildMutex;         // Held by the building thread
+  std::atomic<bool> built{false};
+  void* handle = nullptr;
+  size_t byteLength = 0;
+  int error = 0;                 // C error code if the build failed
+  std::string errorMessage;
+};
+
+struct TreeCacheStats {
+  size_t entries = 0;
+  size_t byteLength = 0;
+  size_t budget = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+};
+
+class TreeCache {
+ public:
+  static TreeCache& Instance();
+
+  /**
+   * Built tree for this series version, or nullptr; never blocks on a build
+   */
+  std::shared_ptr<CachedTree> Lookup(uint32_t id, uint64_t version);
+
+  /**
+   * Tree for the snapshot, building it on a miss (blocks; call off the JS
+   * thread). Check `error` on the result.
+   */
+  std::shared_ptr<CachedTree> Acquire(uint32_t id, const SeriesSnapshot& snapshot);
+
+  void Erase(uint32_t id);
+  void Clear();
+  void SetBudget(size_t bytes);
+  TreeCacheStats Stats() const;
+
+  static size_t DefaultBudget();
+
+ private:
+  TreeCache() : budget_(DefaultBudget()) {}
+
+  struct Entry {
+    uint64_t version;
+    std::shared_ptr<CachedTree> tree;
+    std::list<uint32_t>::iterator lru;
+    size_t charged = 0;  // Bytes counted against the budget (0 while building)
+  };
+
+  using EntryMap = std::unordered_map<uint32_t, Entry>;
+
+  void RemoveLocked(EntryMap::iterator found);
+  void EvictLocked();
+
+  mutable std::mutex mutex_;
+  EntryMap entries_;
+  std::list<uint32_t> lru_;  // Most recently used first
+  size_t byteLength_ = 0;
+  size_t budget_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
+};
+
+/**
+ * Register querySeriesRange / getTreeCacheStats / setTreeCacheBudget /
+ * clearTreeCache exports
+ */
+void InitTreeCache(Napi::Env env, Napi::Object exports);
+
+#endif  // DSA_TREE_CACHE_H
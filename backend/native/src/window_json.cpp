@@ -0,0 +1,154 @@
+/**
+ * JSON / NDJSON encoding of sliding window results
+ */
+
+#include "window_json.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+  #include "sliding_window.h"
+}
+
+// Windows copied out of the C handle per block
+static const size_t kBlockSize = 1024;
+
+// Upper bound for one encoded window: keys, punctuation, a 20-digit index,
+// three numbers of at most 32 chars and the longest pattern name
+static const size_t kMaxWindowBytes = 192;
+
+ByteBuffer::~ByteBuffer() {
+  free(data_);
+}
+
+bool ByteBuffer::Reserve(size_t extra) {
+  if (capacity_ - size_ >= extra) return true;
+
+  size_t needed = size_ + extra;
+  size_t capacity = capacity_ > 0 ? capacity_ : 4096;
+  while (capacity < needed) capacity *= 2;
+
+  char* grown = static_cast<char*>(realloc(data_, capacity));
+  if (!grown) return false;
+  data_ = grown;
+  capacity_ = capacity;
+  return true;
+}
+
+bool ByteBuffer::Append(const char* bytes, size_t length) {
+  if (!Reserve(length)) return false;
+  memcpy(data_ + size_, bytes, length);
+  size_ += length;
+  return true;
+}
+
+char* ByteBuffer::Release() {
+  char* data = data_;
+  data_ = nullptr;
+  size_ = capacity_ = 0;
+  return data;
+}
+
+template <size_t N>
+static inline char* AppendLiteral(char* p, const char (&literal)[N]) {
+  memcpy(p, literal, N - 1);
+  return p + N - 1;
+}
+
+/**
+ * Shortest round-trip decimal for `value`, writing at most 32 chars
+ *
+ * Fixed notation for 1e-6 <= |v| < 1e21 (what JSON.stringify prints),
+ * scientific otherwise. Falls back to %.17g where the standard library
+ * lacks floating-point to_chars.
+ */
+static char* AppendDouble(char* p, double value) {
+  if (!std::isfinite(value)) {
+    return AppendLiteral(p, "null");
+  }
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  double magnitude = std::fabs(value);
+  std::chars_format format = (magnitude == 0.0 || (magnitude >= 1e-6 && magnitude < 1e21))
+                                 ? std::chars_format::fixed
+                                 : std::chars_format::scientific;
+  return std::to_chars(p, p + 32, value, format).ptr;
+#else
+  return p + snprintf(p, 32, "%.17g", value);
+#endif
+}
+
+static char* AppendIndex(char* p, size_t index) {
+  return std::to_chars(p, p + 24, static_cast<unsigned long long>(index)).ptr;
+}
+
+int EncodeWindows(const void* windowHandle, size_t start, size_t end, WindowFormat format,
+                  ByteBuffer& out, char* errBuf, size_t errBufLen) {
+  double max[kBlockSize];
+  double min[kBlockSize];
+  double avg[kBlockSize];
+  unsigned char pattern[kBlockSize];
+
+  for (size_t block = start; block < end; block += kBlockSize) {
+    size_t count = end - block < kBlockSize ? end - block : kBlockSize;
+
+    int result = copyWindowResults(windowHandle, block, count, max, min, avg, pattern,
+                                   errBuf, errBufLen);
+    if (result != 0) return result;
+
+    if (!out.Reserve(count * kMaxWindowBytes)) {
+      snprintf(errBuf, errBufLen, "Memory allocation failed for JSON output");
+      return -3;
+    }
+
+    char* p = out.Cursor();
+    for (size_t i = 0; i < count; i++) {
+      size_t index = block + i;
+      if (format == WindowFormat::Json && index > 0) *p++ = ',';
+
+      p = AppendLiteral(p, "{\"index\":");
+      p = AppendIndex(p, index);
+      p = AppendLiteral(p, ",\"max\":");
+      p = AppendDouble(p, max[i]);
+      p = AppendLiteral(p, ",\"min\":");
+      p = AppendDouble(p, min[i]);
+      p = AppendLiteral(p, ",\"avg\":");
+      p = AppendDouble(p, avg[i]);
+      p = AppendLiteral(p, ",\"pattern\":\"");
+
+      const char* name = windowPatternName(pattern[i]);
+      size_t nameLength = strlen(name);
+      memcpy(p, name, nameLength);
+      p += nameLength;
+      p = AppendLiteral(p, "\"}");
+
+      if (format == WindowFormat::Ndjson) *p++ = '\n';
+    }
+    out.Advance(static_cast<size_t>(p - out.Cursor()));
+  }
+
+  return 0;
+}
+
+int EncodeAllWindows(const void* windowHandle, WindowFormat format, ByteBuffer& out,
+                     char* errBuf, size_t errBufLen) {
+  size_t count = getWindowResultCount(windowHandle);
+
+  if (format == WindowFormat::Json && !out.Append("[", 1)) {
+    snprintf(errBuf, errBufLen, "Memory allocation failed for JSON output");
+    return -3;
+  }
+
+  int result = EncodeWindows(windowHandle, 0, count, format, out, errBuf, errBufLen);
+  if (result != 0) return result;
+
+  if (format == WindowFormat::Json && !out.Append("]", 1)) {
+    snprintf(errBuf, errBufLen, "Memory allocation failed for JSON output");
+    return -3;
+  }
+  return 0;
+}
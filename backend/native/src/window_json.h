@@ -0,0 +1,73 @@
+/**
+ * JSON / NDJSON encoding of sliding window results
+ *
+ * Plain C++ (no N-API) so it can run on any thread. Windows are read from
+ * the C handle in column blocks and written straight into a malloc'ed
+ * byte buffer that the binding hands to JS as a Buffer without copying.
+ */
+
+#ifndef DSA_WINDOW_JSON_H
+#define DSA_WINDOW_JSON_H
+
+#include <cstddef>
+
+enum class WindowFormat {
+  Json,    // [{...},{...}]
+  Ndjson,  // {...}\n{...}\n
+};
+
+/**
+ * Growable malloc'ed byte buffer
+ *
+ * Release() transfers ownership of the bytes (free() them when done);
+ * otherwise they are freed on destruction.
+ */
+class ByteBuffer {
+ public:
+  ByteBuffer() = default;
+  ~ByteBuffer();
+
+  ByteBuffer(const ByteBuffer&) = delete;
+  ByteBuffer& operator=(const ByteBuffer&) = delete;
+
+  // Ensure room for `extra` more bytes; false on allocation failure
+  bool Reserve(size_t extra);
+  bool Append(const char* bytes, size_t length);
+
+  char* Cursor() { return data_ + size_; }
+  void Advance(size_t length) { size_ += length; }
+
+  const char* Data() const { return data_; }
+  size_t Size() const { return size_; }
+  char* Release();
+
+ private:
+  char* data_ = nullptr;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+};
+
+/**
+ * Encode windows [start, end) of a WindowResult handle
+ *
+ * Each window is written as {"index":i,"max":..,"min":..,"avg":..,"pattern":".."}.
+ * Numbers use the shortest round-trip form (fixed notation for ordinary
+ * magnitudes, like JSON.stringify); non-finite values become null.
+ *
+ * For Json, a comma precedes every window except index 0; the caller adds
+ * the surrounding brackets (see EncodeAllWindows). For Ndjson every window
+ * ends with a newline, so chunks can be concatenated as-is.
+ *
+ * @return 0 on success, or a libdsa error code (-3 on allocation failure)
+ *         with a message in errBuf
+ */
+int EncodeWindows(const void* windowHandle, size_t start, size_t end, WindowFormat format,
+                  ByteBuffer& out, char* errBuf, size_t errBufLen);
+
+/**
+ * Encode every window, including the brackets for Json
+ */
+int EncodeAllWindows(const void* windowHandle, WindowFormat format, ByteBuffer& out,
+                     char* errBuf, size_t errBufLen);
+
+#endif  // DSA_WINDOW_JSON_H
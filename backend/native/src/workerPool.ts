@@ -0,0 +1,371 @@
+/**
+ * Worker thread pool for native analysis
+ *
+ * Each worker loads its own instance of dsa_native.node (the addon keeps
+ * per-environment state, so this is safe) and runs whole analyses there:
+ * the native call, the result conversion and any JSON encoding. The main
+ * isolate only posts a message and receives the result, so request
+ * handling is never blocked and concurrent analyses run in parallel.
+ *
+ * Prices are passed in SharedArrayBuffers, which every worker reads in
+ * place; results come back in transferred ArrayBuffers, at any depth of
+ * the result. Native-owned buffers the runtime refuses to detach are copied
+ * once in the worker and the copies transferred; nothing is cloned twice.
+ */
+
+import { Worker } from 'worker_threads';
+import os from 'os';
+import path from 'path';
+import type {
+  PriceArray,
+  PriceSource,
+  RangeStats,
+  WindowFormat,
+  SeriesOptions,
+  BatchJob,
+  BatchOptions,
+  BatchResult,
+} from './wrapper';
+
+/**
+ * Tasks understood by the worker entry (analysisWorker.ts)
+ */
+export type WorkerTask =
+  | { op: 'span'; prices: PriceSource }
+  | { op: 'range'; prices: PriceSource; ql: number; qr: number }
+  | { op: 'window'; prices: PriceSource; windowSize: number; format: WindowFormat }
+  | { op: 'series'; prices: Float64Array; options: SeriesOptions }
+  | { op: 'batch'; jobs: BatchJob[] };
+
+/**
+ * A task to run, or the cancellation of a running one
+ */
+export type WorkerRequest =
+  | { id: number; task: WorkerTask }
+  | { id: number; cancel: true };
+
+export type WorkerResponse =
+  | { id: number; ok: true; result: unknown }
+  | { id: number; ok: false; error: string };
+
+interface PendingTask {
+  id: number;
+  task: WorkerTask;
+  resolve: (result: unknown) => void;
+  reject: (err: Error) => void;
+}
+
+interface PoolWorker {
+  worker: Worker;
+  task: PendingTask | null;
+  answered: boolean;  // Has replied to a task, so it did start
+}
+
+// Workers in a row that may die before answering a task before the pool
+// stops replacing them (bad WORKER_SCRIPT, missing loader, top-level throw)
+const MAX_STARTUP_FAILURES = 3;
+
+// Same extension as this module: .js when compiled, .ts under tsx (workers
+// inherit the parent's execArgv, including the tsx loader)
+const WORKER_SCRIPT = path.join(__dirname, `analysisWorker${path.extname(__filename)}`);
+
+/**
+ * Default pool size: DSA_WORKER_THREADS, else one worker per core minus
+ * the main thread
+ */
+export function defaultWorkerCount(): number {
+  const configured = parseInt(process.env.DSA_WORKER_THREADS || '', 10);
+  if (configured > 0) return configured;
+  return Math.max(1, os.cpus().length - 1);
+}
+
+/**
+ * Copy prices into a SharedArrayBuffer (no-op if they already live in one)
+ *
+ * Convert a series once and pass the result to any number of pool tasks;
+ * workers read the same memory. The element type is preserved.
+ */
+export function toSharedPrices(prices: PriceArray | number[]): PriceArray {
+  if (!Array.isArray(prices) && prices.buffer instanceof SharedArrayBuffer) {
+    return prices;
+  }
+
+  if (prices instanceof Float32Array) {
+    const view = new Float32Array(new SharedArrayBuffer(prices.byteLength));
+    view.set(prices);
+    return view;
+  }
+
+  const view = new Float64Array(new SharedArrayBuffer(prices.length * Float64Array.BYTES_PER_ELEMENT));
+  view.set(prices);
+  return view;
+}
+
+// Registered series ids are process-wide and pass through as-is
+function shareSource(prices: PriceSource): PriceSource {
+  return typeof prices === 'number' ? prices : toSharedPrices(prices);
+}
+
+/**
+ * Fixed-size pool of analysis workers with a FIFO task queue
+ *
+ * A worker that dies is replaced and its task rejected. Idle workers do not
+ * keep the process alive. If MAX_STARTUP_FAILURES workers in a row die
+ * before answering a task, workers evidently cannot start: the pool stops
+ * replacing them, rejects every queued and later task, and reports
+ * `failed`.
+ */
+export class NativeWorkerPool {
+  private workers: PoolWorker[] = [];
+  private queue: PendingTask[] = [];
+  private nextId = 1;
+  private closed = false;
+  private startupFailures = 0;
+  private failure: Error | null = null;
+
+  constructor(readonly size: number = defaultWorkerCount()) {
+    if (!Number.isInteger(size) || size < 1) {
+      throw new Error(`Invalid worker pool size: ${size}`);
+    }
+    for (let i = 0; i < size; i++) {
+      this.workers.push(this.spawn());
+    }
+  }
+
+  /** True once workers have failed to start and the pool runs nothing */
+  get failed(): boolean {
+    return this.failure !== null;
+  }
+
+  /** Tasks queued or running */
+  get pending(): number {
+    return this.queue.length + this.workers.filter(w => w.task !== null).length;
+  }
+
+  /**
+   * Stock spans, computed in a worker
+   */
+  async calculateStockSpan(prices: PriceSource): Promise<Int32Array> {
+    return (await this.run({ op: 'span', prices: shareSource(prices) })) as Int32Array;
+  }
+
+  /**
+   * Range statistics from a segment tree built and freed in a worker
+   */
+  async queryRange(prices: PriceSource, ql: number, qr: number): Promise<RangeStats> {
+    return (await this.run({ op: 'range', prices: shareSource(prices), ql, qr })) as RangeStats;
+  }
+
+  /**
+   * Sliding window analysis serialized to JSON/NDJSON in a worker
+   */
+  async serializeWindows(
+    prices: PriceSource,
+    windowSize: number,
+    format: WindowFormat = 'json'
+  ): Promise<Buffer> {
+    const bytes = (await this.run({
+      op: 'window',
+      prices: shareSource(prices),
+      windowSize,
+      format,
+    })) as Uint8Array;
+    // Buffers arrive as plain Uint8Arrays; re-wrap without copying
+    return Buffer.from(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  }
+
+  /**
+   * Fused series analysis (see analyzeSeries) in a worker
+   */
+  async analyzeSeries(
+    prices: Float64Array,
+    options: SeriesOptions = {}
+  ): Promise<BatchResult & { stats: RangeStats }> {
+    const shared = toSharedPrices(prices) as Float64Array;
+    return (await this.run({ op: 'series', prices: shared, options })) as BatchResult & {
+      stats: RangeStats;
+    };
+  }
+
+  /**
+   * Batch analysis (see analyzeBatch) in a worker
+   * 
+   * Aborting `signal` rejects at once with its reason; the worker skips the
+   * jobs it has not started and takes no new task until the batch returns.
+   */
+  async analyzeBatch(jobs: BatchJob[], opts: BatchOptions = {}): Promise<BatchResult[]> {
+    const shared = jobs.map(job => ({
+      ...job,
+      prices: toSharedPrices(job.prices) as Float64Array,
+    }));
+    return (await this.run({ op: 'batch', jobs: shared }, opts.signal)) as BatchResult[];
+  }
+
+  /**
+   * Queue a raw task; resolves with the worker's result
+   * 
+   * Aborting `signal` drops the task if it is still queued, or asks its
+   * worker to cancel it, and rejects with the signal's reason.
+   */
+  run(task: WorkerTask, signal?: AbortSignal): Promise<unknown> {
+    if (this.closed) {
+      return Promise.reject(new Error('Worker pool is closed'));
+    }
+    if (this.failure) {
+      return Promise.reject(this.failure);
+    }
+    if (signal?.aborted) {
+      return Promise.reject(signal.reason);
+    }
+
+    return new Promise((resolve, reject) => {
+      const pending: PendingTask = { id: this.nextId++, task, resolve, reject };
+      if (signal) {
+        const onAbort = () => this.cancel(pending, signal.reason);
+        signal.addEventListener('abort', onAbort, { once: true });
+        pending.resolve = (result) => {
+          signal.removeEventListener('abort', onAbort);
+          resolve(result);
+        };
+        pending.reject = (err) => {
+          signal.removeEventListener('abort', onAbort);
+          reject(err);
+        };
+      }
+      this.queue.push(pending);
+      this.dispatch();
+    });
+  }
+
+  /**
+   * Terminate all workers; queued and running tasks are rejected
+   */
+  async close(): Promise<void> {
+    if (this.closed) return;
+    this.closed = true;
+
+    const error = new Error('Worker pool is closed');
+    for (const pending of this.queue.splice(0)) {
+      pending.reject(error);
+    }
+
+    await Promise.all(
+      this.workers.map(async (entry) => {
+        const task = entry.task;
+        entry.task = null;
+        task?.reject(error);
+        await entry.worker.terminate();
+      })
+    );
+    this.workers = [];
+  }
+
+  private spawn(): PoolWorker {
+    const entry: PoolWorker = { worker: new Worker(WORKER_SCRIPT), task: null, answered: false };
+
+    entry.worker.on('message', (msg: WorkerResponse) => {
+      entry.answered = true;
+      this.startupFailures = 0;
+
+      const task = entry.task;
+      if (!task || task.id !== msg.id) return;
+
+      entry.task = null;
+      if (msg.ok) {
+        task.resolve(msg.result);
+      } else {
+        task.reject(new Error(msg.error));
+      }
+      this.dispatch();
+    });
+
+    entry.worker.on('error', (err) => this.replace(entry, err));
+    entry.worker.on('exit', (code) => {
+      this.replace(entry, new Error(`Analysis worker exited with code ${code}`));
+    });
+
+    entry.worker.unref();
+    return entry;
+  }
+
+  // A crashed worker fails its task and is swapped for a fresh one, unless
+  // workers keep dying before they answer anything
+  private replace(entry: PoolWorker, err: Error): void {
+    const index = this.workers.indexOf(entry);
+    if (index === -1) return;
+
+    const task = entry.task;
+    entry.task = null;
+    task?.reject(err);
+
+    entry.worker.removeAllListeners();
+    void entry.worker.terminate();
+
+    if (!entry.answered && ++this.startupFailures >= MAX_STARTUP_FAILURES && !this.failure) {
+      this.failure = new Error(`Analysis workers failed to start: ${err.message}`);
+      for (const pending of this.queue.splice(0)) {
+        pending.reject(this.failure);
+      }
+    }
+
+    if (this.closed || this.failure) {
+      this.workers.splice(index, 1);
+      return;
+    }
+    this.workers[index] = this.spawn();
+    this.dispatch();
+  }
+
+  // A running task keeps its worker until the worker answers (the answer
+  // is then ignored: the task has already been rejected)
+  private cancel(pending: PendingTask, reason: unknown): void {
+    const index = this.queue.indexOf(pending);
+    if (index !== -1) {
+      this.queue.splice(index, 1);
+    } else {
+      const entry = this.workers.find(w => w.task === pending);
+      const request: WorkerRequest = { id: pending.id, cancel: true };
+      entry?.worker.postMessage(request);
+    }
+    pending.reject(reason as Error);
+  }
+
+  private dispatch(): void {
+    for (const entry of this.workers) {
+      if (this.queue.length === 0) return;
+      if (entry.task !== null) continue;
+
+      const pending = this.queue.shift() as PendingTask;
+      entry.task = pending;
+      // Busy workers keep the process alive until their task settles
+      entry.worker.ref();
+      const request: WorkerRequest = { id: pending.id, task: pending.task };
+      entry.worker.postMessage(request);
+    }
+
+    for (const entry of this.workers) {
+      if (entry.task === null) entry.worker.unref();
+    }
+  }
+}
+
+let sharedPool: NativeWorkerPool | null = null;
+
+/**
+ * Process-wide pool, created on first use with defaultWorkerCount() workers
+ */
+export function getWorkerPool(): NativeWorkerPool {
+  if (!sharedPool) {
+    sharedPool = new NativeWorkerPool();
+  }
+  return sharedPool;
+}
+
+/**
+ * Close the process-wide pool (a later getWorkerPool() starts a new one)
+ */
+export async function closeWorkerPool(): Promise<void> {
+  const pool = sharedPool;
+  sharedPool = null;
+  await pool?.close();
+}
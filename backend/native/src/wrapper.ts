@@ -5,27 +5,78 @@
  * Handles resource cleanup and error propagation.
  */
 
-import { Worker } from 'worker_threads';
+/**
+ * Price input accepted by span, segment tree, sliding window and validation
+ * 
+ * Float32Array input runs the float32 kernels: half the input bytes, with
+ * min/max stored as float and sums accumulated in double. Results match
+ * the Float64Array path on the same values.
+ */
+export type PriceArray = Float64Array | Float32Array;
+
+/**
+ * Id of a price series held natively (see registerSeries)
+ */
+export type SeriesId = number;
+
+/**
+ * Input to span, segment tree and sliding window analysis: prices, or the
+ * id of a registered series (analyzed in place, nothing is marshalled)
+ */
+export type PriceSource = PriceArray | SeriesId;
 
 // Native module types
 interface NativeModule {
-  calculateStockSpan(prices: Float64Array): Int32Array;
-  buildSegmentTree(prices: Float64Array): unknown; // Opaque external handle
-  querySegmentTree(handle: unknown, ql: number, qr: number): {
-    min: number;
-    max: number;
-    avg: number;
-    variance: number;
-  };
-  freeSegmentTree(handle: unknown): void;
-  analyzeSlidingWindow(prices: Float64Array, windowSize: number): unknown; // Opaque handle
-  getWindowResult(handle: unknown, idx: number): {
-    max: number;
-    min: number;
-    avg: number;
-    pattern: string;
-  };
-  freeWindowResult(handle: unknown): void;
+  calculateStockSpan(prices: PriceSource): Int32Array;
+  buildSegmentTree(prices: PriceSource): SegmentTreeHandle;
+  querySegmentTree(handle: SegmentTreeHandle, ql: number, qr: number): RangeStats;
+  freeSegmentTree(handle: SegmentTreeHandle): void;
+  analyzeSlidingWindow(prices: PriceSource, windowSize: number): WindowResultHandle;
+  getWindowResult(handle: WindowResultHandle, idx: number): WindowStats;
+  freeWindowResult(handle: WindowResultHandle): void;
+  validatePrices(prices: PriceArray): number;
+  getNativeDiagnostics(): NativeDiagnostics;
+
+  // Threadpool variants: run the C computation off the main thread
+  calculateStockSpanAsync(prices: PriceSource): Promise<Int32Array>;
+  buildSegmentTreeAsync(prices: PriceSource): Promise<SegmentTreeHandle>;
+  analyzeSlidingWindowAsync(prices: PriceSource, windowSize: number): Promise<WindowResultHandle>;
+  serializeWindows(handle: WindowResultHandle, format?: WindowFormat): Promise<Buffer>;
+  createWindowIterator(
+    handle: WindowResultHandle,
+    format: WindowFormat,
+    chunkWindows: number
+  ): WindowChunkIterator;
+
+  // Batch analysis on the native work-stealing pool
+  analyzeBatch(jobs: BatchJob[], token?: CancelTokenHandle): Promise<BatchResult[]>;
+  CancelToken: new () => CancelTokenHandle;
+  setThreadPoolSize(threads: number): void;
+  getThreadPoolSize(): number;
+
+  // Series registry (process-wide)
+  registerSeries(symbol: string, prices: PriceArray): SeriesId;
+  appendSeries(id: SeriesId, prices: PriceArray): SeriesInfo;
+  releaseSeries(id: SeriesId): boolean;
+  getSeriesInfo(id: SeriesId): SeriesInfo | null;
+  findSeries(symbol: string): SeriesId | null;
+
+  // Segment tree cache over registered series (process-wide)
+  querySeriesRange(id: SeriesId, ql: number, qr: number): Promise<RangeStats>;
+  getTreeCacheStats(): TreeCacheStats;
+  setTreeCacheBudget(bytes: number): void;
+  clearTreeCache(): void;
+
+  // Column store (column_store.cpp)
+  ColumnStore: new (dir: string) => ColumnStoreHandle;
+
+  // Provider response parsing (chart_parser.cpp)
+  parseChartColumns(bytes: Uint8Array): ChartColumns;
+
+  // libdsa call statistics (stats.cpp)
+  getNativeStats(): NativeStats;
+  setNativeStatsEnabled(enabled: boolean): void;
+  resetNativeStats(): void;
 }
 
 // Lazy load native module (allows fallback if not compiled)
@@ -49,45 +100,56 @@ function loadNativeModule(): NativeModule {
 /**
  * Calculate stock span for price array
  * 
- * @param prices Array of stock prices
+ * Runs on the libuv threadpool; `prices` must not be modified until the
+ * returned promise settles.
+ * 
+ * @param prices Array of stock prices (Float64Array or Float32Array) or series id
  * @returns Array of span values (same length as input)
  * @throws Error if native module fails or invalid input
  */
-export async function calculateStockSpan(prices: Float64Array): Promise<Int32Array> {
-  return new Promise((resolve, reject) => {
-    try {
-      const native = loadNativeModule();
-      const result = native.calculateStockSpan(prices);
-      resolve(result);
-    } catch (err) {
-      reject(new Error(`Stock span calculation failed: ${(err as Error).message}`));
-    }
-  });
+export async function calculateStockSpan(prices: PriceSource): Promise<Int32Array> {
+  try {
+    const native = loadNativeModule();
+    return await native.calculateStockSpanAsync(prices);
+  } catch (err) {
+    throw new Error(`Stock span calculation failed: ${(err as Error).message}`);
+  }
 }
 
 /**
- * Opaque handle for segment tree
- * IMPORTANT: Must call freeSegmentTree() when done to prevent memory leak
+ * Native segment tree (GC-managed)
+ * 
+ * The native memory is released by freeSegmentTree()/free() or, if neither
+ * is called, when the object is garbage collected. Freeing twice is a no-op.
+ * Prefer freeing explicitly (or withSegmentTree) for prompt release.
  */
-export type SegmentTreeHandle = unknown;
+export interface SegmentTreeHandle {
+  /** Number of prices the tree was built over (0 once freed) */
+  readonly length: number;
+  /** Native memory held by the tree, reported to V8 (0 once freed) */
+  readonly byteLength: number;
+  readonly freed: boolean;
+  query(ql: number, qr: number): RangeStats;
+  free(): void;
+}
 
 /**
  * Build segment tree from price array
  * 
- * @param prices Array of stock prices
- * @returns Opaque handle (must be freed with freeSegmentTree)
+ * Runs on the libuv threadpool; `prices` must not be modified until the
+ * returned promise settles.
+ * 
+ * @param prices Array of stock prices (Float64Array or Float32Array) or series id
+ * @returns Tree handle (free with freeSegmentTree when done)
  * @throws Error if build fails
  */
-export async function buildSegmentTree(prices: Float64Array): Promise<SegmentTreeHandle> {
-  return new Promise((resolve, reject) => {
-    try {
-      const native = loadNativeModule();
-      const handle = native.buildSegmentTree(prices);
-      resolve(handle);
-    } catch (err) {
-      reject(new Error(`Segment tree build failed: ${(err as Error).message}`));
-    }
-  });
+export async function buildSegmentTree(prices: PriceSource): Promise<SegmentTreeHandle> {
+  try {
+    const native = loadNativeModule();
+    return await native.buildSegmentTreeAsync(prices);
+  } catch (err) {
+    throw new Error(`Segment tree build failed: ${(err as Error).message}`);
+  }
 }
 
 /**
@@ -128,8 +190,10 @@ export async function querySegmentTree(
 /**
  * Free segment tree resources
  * 
+ * Idempotent: freeing an already-freed tree is a no-op.
+ * 
  * @param handle Tree handle to free
- * @throws Error if handle is invalid
+ * @throws Error if handle is not a SegmentTree
  */
 export async function freeSegmentTree(handle: SegmentTreeHandle): Promise<void> {
   return new Promise((resolve, reject) => {
@@ -144,32 +208,40 @@ export async function freeSegmentTree(handle: SegmentTreeHandle): Promise<void>
 }
 
 /**
- * Opaque handle for sliding window results
- * IMPORTANT: Must call freeWindowResult() when done
+ * Native sliding window results (GC-managed, same lifetime rules as
+ * SegmentTreeHandle)
  */
-export type WindowResultHandle = unknown;
+export interface WindowResultHandle {
+  /** Number of windows (0 once freed) */
+  readonly count: number;
+  /** Native memory held by the results, reported to V8 (0 once freed) */
+  readonly byteLength: number;
+  readonly freed: boolean;
+  get(idx: number): WindowStats;
+  free(): void;
+}
 
 /**
  * Analyze prices using sliding window
  * 
- * @param prices Array of stock prices
+ * Runs on the libuv threadpool; `prices` must not be modified until the
+ * returned promise settles.
+ * 
+ * @param prices Array of stock prices (Float64Array or Float32Array) or series id
  * @param windowSize Size of sliding window
- * @returns Handle to window results (must be freed)
+ * @returns Handle to window results (free with freeWindowResult when done)
  * @throws Error if analysis fails
  */
 export async function analyzeSlidingWindow(
-  prices: Float64Array,
+  prices: PriceSource,
   windowSize: number
 ): Promise<WindowResultHandle> {
-  return new Promise((resolve, reject) => {
-    try {
-      const native = loadNativeModule();
-      const handle = native.analyzeSlidingWindow(prices, windowSize);
-      resolve(handle);
-    } catch (err) {
-      reject(new Error(`Sliding window analysis failed: ${(err as Error).message}`));
-    }
-  });
+  try {
+    const native = loadNativeModule();
+    return await native.analyzeSlidingWindowAsync(prices, windowSize);
+  } catch (err) {
+    throw new Error(`Sliding window analysis failed: ${(err as Error).message}`);
+  }
 }
 
 /**
@@ -205,11 +277,99 @@ export async function getWindowResult(
   });
 }
 
+/**
+ * Text encodings produced by serializeWindowResult
+ */
+export type WindowFormat = 'json' | 'ndjson';
+
+/**
+ * Serialize all windows to JSON or NDJSON natively
+ * 
+ * Produces `[{"index":0,"max":..,"min":..,"avg":..,"pattern":".."},...]`
+ * (or one object per line for 'ndjson') on the libuv threadpool, without
+ * creating a JS object per window. Numbers use shortest round-trip
+ * formatting, so JSON.parse yields the exact doubles.
+ * 
+ * The handle stays valid while serializing; freeing it meanwhile is safe
+ * and takes effect once serialization finishes.
+ * 
+ * @param handle Window result handle
+ * @param format 'json' (default) or 'ndjson'
+ * @returns Buffer of UTF-8 text, ready to send as a response body
+ * @throws Error if handle is freed or invalid
+ */
+export async function serializeWindowResult(
+  handle: WindowResultHandle,
+  format: WindowFormat = 'json'
+): Promise<Buffer> {
+  try {
+    const native = loadNativeModule();
+    return await native.serializeWindows(handle, format);
+  } catch (err) {
+    throw new Error(`Window serialization failed: ${(err as Error).message}`);
+  }
+}
+
+/**
+ * Native chunked encoder over a WindowResult (see iterateWindowChunks)
+ */
+export interface WindowChunkIterator {
+  /** Windows encoded so far */
+  readonly position: number;
+  readonly count: number;
+  readonly done: boolean;
+  /** Encode the next chunk; null once all windows have been produced */
+  next(): Promise<Buffer | null>;
+  /** Stop early and release the pin on the WindowResult */
+  close(): void;
+}
+
+/**
+ * Stream all windows as JSON / NDJSON in fixed-size chunks
+ * 
+ * Each chunk of `chunkWindows` windows is encoded on the libuv threadpool
+ * only when the consumer asks for it, so memory stays bounded by one chunk
+ * and the first bytes are ready after one chunk. Concatenating the chunks
+ * gives exactly the serializeWindowResult output. Breaking out of the loop
+ * closes the iterator.
+ * 
+ * Example:
+ *   Readable.from(iterateWindowChunks(handle, 'ndjson')).pipe(res);
+ * 
+ * @param handle Window result handle (kept alive until iteration ends)
+ * @param format 'json' (default) or 'ndjson'
+ * @param chunkWindows Windows per chunk
+ */
+export async function* iterateWindowChunks(
+  handle: WindowResultHandle,
+  format: WindowFormat = 'json',
+  chunkWindows = 8192
+): AsyncGenerator<Buffer> {
+  let iterator: WindowChunkIterator;
+  try {
+    iterator = loadNativeModule().createWindowIterator(handle, format, chunkWindows);
+  } catch (err) {
+    throw new Error(`Window iteration failed: ${(err as Error).message}`);
+  }
+
+  try {
+    for (;;) {
+      const chunk = await iterator.next();
+      if (chunk === null) return;
+      yield chunk;
+    }
+  } finally {
+    iterator.close();
+  }
+}
+
 /**
  * Free window result resources
  * 
+ * Idempotent: freeing an already-freed result is a no-op.
+ * 
  * @param handle Window result handle to free
- * @throws Error if handle is invalid
+ * @throws Error if handle is not a WindowResult
  */
 export async function freeWindowResult(handle: WindowResultHandle): Promise<void> {
   return new Promise((resolve, reject) => {
@@ -223,6 +383,312 @@ export async function freeWindowResult(handle: WindowResultHandle): Promise<void
   });
 }
 
+/**
+ * Find the first non-finite price
+ * 
+ * Synchronous, vectorized native scan, suitable for validating request
+ * bodies before analysis.
+ * 
+ * @param prices Array of stock prices
+ * @returns Index of the first NaN/infinite price, or -1 if all are finite
+ */
+export function findInvalidPrice(prices: PriceArray): number {
+  return loadNativeModule().validatePrices(prices);
+}
+
+export interface NativeDiagnostics {
+  isa: string;              // 'avx512' | 'avx2' | 'sse2' | 'generic'
+  supportedIsas: string[];  // variants usable on this CPU, best first
+}
+
+/**
+ * Report which SIMD kernel variant libdsa is running
+ * 
+ * The variant is chosen once when the library loads (best supported, or
+ * `DSA_ISA` if set); results are identical across variants.
+ */
+export function getNativeDiagnostics(): NativeDiagnostics {
+  return loadNativeModule().getNativeDiagnostics();
+}
+
+/**
+ * Counters for one libdsa function, since load or the last reset
+ */
+export interface NativeFunctionStats {
+  calls: number;
+  /** Calls that returned a C error */
+  errors: number;
+  /** Input sizes summed: prices, range length, rows or bytes (chart_parse) */
+  elements: number;
+  /** Memory handed back by successful calls */
+  bytesAllocated: number;
+  totalNs: number;
+  /** Call counts per latency bucket (see NativeStats.bucketBoundsNs) */
+  histogram: Float64Array;
+}
+
+export interface NativeStats {
+  enabled: boolean;
+  /** Exclusive upper bound of each histogram bucket in ns; the last is Infinity */
+  bucketBoundsNs: Float64Array;
+  /** Keyed by function: stock_span, segment_tree_build, segment_tree_query,
+   *  sliding_window, series_analysis, chart_parse, column_append, column_map */
+  functions: Record<string, NativeFunctionStats>;
+}
+
+/**
+ * Read libdsa's per-function call statistics
+ * 
+ * Counts calls, errors, elements and allocated bytes and keeps a latency
+ * histogram (4 buckets per power of two) for each analysis function.
+ * Process-wide: calls from worker threads and the batch pool are included.
+ * All zero unless collection is on (DSA_STATS=1 or setNativeStatsEnabled).
+ */
+export function getNativeStats(): NativeStats {
+  return loadNativeModule().getNativeStats();
+}
+
+/**
+ * Turn libdsa statistics collection on or off (counters are kept)
+ * 
+ * While off, each native call pays one atomic load and reads no clock.
+ */
+export function setNativeStatsEnabled(enabled: boolean): void {
+  loadNativeModule().setNativeStatsEnabled(enabled);
+}
+
+/**
+ * Zero libdsa's call statistics
+ */
+export function resetNativeStats(): void {
+  loadNativeModule().resetNativeStats();
+}
+
+/**
+ * Registered series metadata
+ */
+export interface SeriesInfo {
+  id: SeriesId;
+  symbol: string;
+  length: number;
+  /** Bumped on every registerSeries/appendSeries that changes the values */
+  version: number;
+  /** Outstanding registerSeries references */
+  refs: number;
+  /** Native memory reserved for the values */
+  byteLength: number;
+}
+
+/**
+ * Register a price series natively and return its id
+ * 
+ * The prices are validated and copied once; pass the id to
+ * calculateStockSpan, buildSegmentTree or analyzeSlidingWindow (or the
+ * worker pool) instead of the array. Registering a symbol that is already
+ * registered replaces its values and returns the same id. Each call adds a
+ * reference: pair it with releaseSeries. Series are shared by all threads
+ * in the process.
+ * 
+ * @param symbol Key for the series (e.g. a ticker and date range)
+ * @param prices Prices to copy (Float32Array is widened to double)
+ * @throws Error if a price is not finite
+ */
+export function registerSeries(symbol: string, prices: PriceArray): SeriesId {
+  try {
+    return loadNativeModule().registerSeries(symbol, prices);
+  } catch (err) {
+    throw new Error(`Series registration failed: ${(err as Error).message}`);
+  }
+}
+
+/**
+ * Append prices to a registered series (amortized O(k))
+ * 
+ * Analyses already running keep seeing the values they started with.
+ * 
+ * @returns Updated series info
+ * @throws Error if the id is unknown or a price is not finite
+ */
+export function appendSeries(id: SeriesId, prices: PriceArray): SeriesInfo {
+  try {
+    return loadNativeModule().appendSeries(id, prices);
+  } catch (err) {
+    throw new Error(`Series append failed: ${(err as Error).message}`);
+  }
+}
+
+/**
+ * Drop one reference to a series; the last release frees it
+ * 
+ * @returns false if the id was not registered
+ */
+export function releaseSeries(id: SeriesId): boolean {
+  return loadNativeModule().releaseSeries(id);
+}
+
+/**
+ * Metadata for a registered series, or null if the id is unknown
+ */
+export function getSeriesInfo(id: SeriesId): SeriesInfo | null {
+  return loadNativeModule().getSeriesInfo(id);
+}
+
+/**
+ * Id registered for a symbol, or null
+ */
+export function findSeries(symbol: string): SeriesId | null {
+  return loadNativeModule().findSeries(symbol);
+}
+
+/**
+ * Range statistics over a registered series, from a cached segment tree
+ * 
+ * The first query of a series version builds its tree on the libuv
+ * threadpool; later queries reuse it and resolve without leaving the
+ * calling thread. Trees are evicted least recently used once the cache
+ * exceeds its byte budget, and dropped when the series changes or is
+ * released.
+ * 
+ * @param id Registered series
+ * @param ql Left index (inclusive)
+ * @param qr Right index (inclusive)
+ * @throws Error if the id is unknown or the range is invalid
+ */
+export async function querySeriesRange(
+  id: SeriesId,
+  ql: number,
+  qr: number
+): Promise<RangeStats> {
+  try {
+    const native = loadNativeModule();
+    return await native.querySeriesRange(id, ql, qr);
+  } catch (err) {
+    throw new Error(`Series range query failed: ${(err as Error).message}`);
+  }
+}
+
+export interface TreeCacheStats {
+  entries: number;
+  byteLength: number;  // native memory held by cached trees
+  budget: number;
+  hits: number;
+  misses: number;
+  evictions: number;
+}
+
+/**
+ * Segment tree cache occupancy and hit/miss counters
+ */
+export function getTreeCacheStats(): TreeCacheStats {
+  return loadNativeModule().getTreeCacheStats();
+}
+
+/**
+ * Set the segment tree cache budget in bytes (0 disables caching);
+ * evicts immediately if the cache is over the new budget
+ */
+export function setTreeCacheBudget(bytes: number): void {
+  loadNativeModule().setTreeCacheBudget(bytes);
+}
+
+/**
+ * Drop every cached tree (trees in use are freed when their queries finish)
+ */
+export function clearTreeCache(): void {
+  loadNativeModule().clearTreeCache();
+}
+
+/**
+ * OHLCV columns, one value per row; dates are epoch milliseconds
+ */
+export interface OhlcvColumns {
+  date: Float64Array;
+  open: Float64Array;
+  high: Float64Array;
+  low: Float64Array;
+  close: Float64Array;
+  volume: Float64Array;
+}
+
+export type ColumnName = keyof OhlcvColumns;
+
+/**
+ * Append-only on-disk OHLCV history for one symbol (libdsa column store)
+ */
+export interface ColumnStoreHandle {
+  /** Committed rows */
+  readonly rows: number;
+  /** Dates the stored rows are complete for, or null while empty */
+  readonly coverage: { start: number; end: number } | null;
+  readonly closed: boolean;
+  /**
+   * Append the complete rows for [rangeStart, rangeEnd]; rows already
+   * stored are skipped. Resolves with the number of rows written, once
+   * they are synced to disk. The store takes no other append or read until
+   * then (close() waits for it), and `columns` must not be modified.
+   */
+  append(columns: OhlcvColumns, rangeStart: number, rangeEnd: number): Promise<number>;
+  /** Rows dated within [startDate, endDate], mapped without copying */
+  readRange(startDate: number, endDate: number): OhlcvColumns;
+  readRange<K extends ColumnName>(
+    startDate: number,
+    endDate: number,
+    columns: K[]
+  ): Pick<OhlcvColumns, K>;
+  close(): void;
+}
+
+/**
+ * Open (or create) a column store directory
+ * 
+ * Reads return Float64Arrays backed by a private mapping of the column
+ * files: no parsing and no copy, and they stay valid after close(). An
+ * append must not start after the end of the stored coverage, so the
+ * store never has holes. Open at most one store per directory.
+ * 
+ * @param dir Store directory; its parent must exist
+ * @throws Error if the directory cannot be created or holds a corrupt store
+ */
+export function openColumnStore(dir: string): ColumnStoreHandle {
+  try {
+    const native = loadNativeModule();
+    return new native.ColumnStore(dir);
+  } catch (err) {
+    throw new Error(`Column store open failed: ${(err as Error).message}`);
+  }
+}
+
+/**
+ * Columns parsed from a chart response; dates are days since 1970-01-01 UTC
+ */
+export interface ChartColumns {
+  date: Int32Array;
+  open: Float64Array;
+  high: Float64Array;
+  low: Float64Array;
+  close: Float64Array;
+  volume: Float64Array;
+}
+
+/**
+ * Parse a Yahoo Finance v8 chart response straight into typed columns
+ * 
+ * Reads chart.result[0] without building JS objects for the response.
+ * Rows without a timestamp or close are dropped; a missing open, high or
+ * low takes the close and a missing volume is 0. Synchronous: a few years
+ * of daily rows parse in a few milliseconds.
+ * 
+ * @param bytes Raw response body (UTF-8 JSON)
+ * @throws Error if the body is malformed or has no chart result
+ */
+export function parseChartColumns(bytes: Uint8Array): ChartColumns {
+  try {
+    return loadNativeModule().parseChartColumns(bytes);
+  } catch (err) {
+    throw new Error(`Chart parse failed: ${(err as Error).message}`);
+  }
+}
+
 /**
  * Helper: Auto-cleanup segment tree with callback pattern
  * 
@@ -233,7 +699,7 @@ export async function freeWindowResult(handle: WindowResultHandle): Promise<void
  *   });
  */
 export async function withSegmentTree<T>(
-  prices: Float64Array,
+  prices: PriceSource,
   callback: (handle: SegmentTreeHandle) => Promise<T>
 ): Promise<T> {
   const handle = await buildSegmentTree(prices);
@@ -248,7 +714,7 @@ export async function withSegmentTree<T>(
  * Helper: Auto-cleanup window analysis with callback pattern
  */
 export async function withSlidingWindow<T>(
-  prices: Float64Array,
+  prices: PriceSource,
   windowSize: number,
   callback: (handle: WindowResultHandle) => Promise<T>
 ): Promise<T> {
@@ -259,3 +725,177 @@ export async function withSlidingWindow<T>(
     await freeWindowResult(handle);
   }
 }
+
+/**
+ * One series in an analyzeBatch call
+ */
+export interface BatchJob {
+  prices: Float64Array;
+  /** Compute stock spans */
+  span?: boolean;
+  /** Compute whole-series min/max/avg/variance */
+  stats?: boolean;
+  /** Range queries as flattened inclusive [ql, qr] pairs */
+  ranges?: Uint32Array;
+  /** Run sliding window analysis with this window size */
+  windowSize?: number;
+}
+
+/**
+ * Columnar results for one BatchJob
+ *
+ * Only the sections requested by the job are present. `pattern` holds
+ * WINDOW_PATTERNS indices.
+ */
+export interface BatchResult {
+  computeTimeMs: number;
+  /** Set when this job failed; other jobs in the batch are unaffected */
+  error?: string;
+  spans?: Int32Array;
+  stats?: RangeStats;
+  ranges?: {
+    min: Float64Array;
+    max: Float64Array;
+    avg: Float64Array;
+    variance: Float64Array;
+  };
+  windows?: {
+    max: Float64Array;
+    min: Float64Array;
+    avg: Float64Array;
+    pattern: Uint8Array;
+  };
+}
+
+/**
+ * Window pattern names, indexed by BatchResult.windows.pattern codes
+ */
+export const WINDOW_PATTERNS: ReadonlyArray<WindowStats['pattern']> = [
+  'bullish',
+  'bearish',
+  'volatile',
+  'stable',
+];
+
+/**
+ * Native cancellation flag shared with running batches
+ */
+interface CancelTokenHandle {
+  readonly cancelled: boolean;
+  cancel(): void;
+}
+
+/**
+ * Options for analyzeBatch
+ */
+export interface BatchOptions {
+  /** Skip the jobs that have not started once this is aborted */
+  signal?: AbortSignal;
+}
+
+/**
+ * Analyze many price series in one native call
+ * 
+ * Jobs are spread across a native work-stealing pool (sized by
+ * DSA_NATIVE_THREADS or the core count), so uneven series lengths still
+ * keep every core busy. No job's `prices` may be modified until the
+ * returned promise settles.
+ * 
+ * Aborting `signal` stops the pool from starting further jobs and a job's
+ * remaining range queries (a fused series pass or tree build already
+ * running finishes) and rejects with the abort reason once the native call
+ * has let go of the inputs.
+ * 
+ * @param jobs Series and the analyses to run on each
+ * @param opts Optional abort signal
+ * @returns One result per job, in order
+ * @throws Error if a job is malformed (per-job C errors are reported in `error`)
+ * @throws The signal's reason if aborted
+ */
+export async function analyzeBatch(
+  jobs: BatchJob[],
+  opts: BatchOptions = {}
+): Promise<BatchResult[]> {
+  const { signal } = opts;
+  signal?.throwIfAborted();
+
+  let results: BatchResult[];
+  try {
+    const native = loadNativeModule();
+    const token = signal ? new native.CancelToken() : undefined;
+    const onAbort = () => token?.cancel();
+    signal?.addEventListener('abort', onAbort, { once: true });
+    try {
+      results = await native.analyzeBatch(jobs, token);
+    } finally {
+      signal?.removeEventListener('abort', onAbort);
+    }
+  } catch (err) {
+    throw new Error(`Batch analysis failed: ${(err as Error).message}`);
+  }
+
+  signal?.throwIfAborted();
+  return results;
+}
+
+/**
+ * Options for analyzeSeries
+ */
+export interface SeriesOptions {
+  /** Compute stock spans (default true) */
+  span?: boolean;
+  /** Also run sliding window analysis with this window size */
+  windowSize?: number;
+}
+
+/**
+ * Analyze one series in a single fused native pass
+ * 
+ * Validates once and computes spans, whole-series statistics and optional
+ * windows together, without building a segment tree. Prefer this over
+ * calculateStockSpan + querySegmentTree(0, n-1) + analyzeSlidingWindow.
+ * 
+ * @param prices Array of stock prices
+ * @param opts What to compute besides the statistics
+ * @returns Columnar results (stats always present)
+ * @throws Error if analysis fails
+ */
+export async function analyzeSeries(
+  prices: Float64Array,
+  opts: SeriesOptions = {}
+): Promise<BatchResult & { stats: RangeStats }> {
+  const [result] = await analyzeBatch([
+    { prices, span: opts.span !== false, stats: true, windowSize: opts.windowSize },
+  ]);
+  if (result.error || !result.stats) {
+    throw new Error(`Series analysis failed: ${result.error}`);
+  }
+  return result as BatchResult & { stats: RangeStats };
+}
+
+/**
+ * Resize the native batch thread pool (0 restores the default)
+ */
+export function setThreadPoolSize(threads: number): void {
+  loadNativeModule().setThreadPoolSize(threads);
+}
+
+/**
+ * Number of threads in the native batch thread pool
+ */
+export function getThreadPoolSize(): number {
+  return loadNativeModule().getThreadPoolSize();
+}
+
+/**
+ * Worker thread pool: whole analyses off the main thread, prices shared
+ * through SharedArrayBuffers (see workerPool.ts)
+ */
+export {
+  NativeWorkerPool,
+  getWorkerPool,
+  closeWorkerPool,
+  toSharedPrices,
+  defaultWorkerCount,
+  type WorkerTask,
+} from './workerPool';
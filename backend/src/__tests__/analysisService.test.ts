@@ -4,9 +4,26 @@
  * IMPORTANT: No embedded market data. Tests use mocked providers.
  */
 
-import { analysisService } from '../services/analysisService';
+import { analysisService, AnalysisService } from '../services/analysisService';
 import { DataProvider } from '../services/dataProvider';
-import { OHLCVData } from '../types';
+import { OHLCVColumns } from '../types';
+import { allocateColumns, toEpochDay } from '../utils/ohlcv';
+import { HISTORICAL_TTL_MS } from '../cache/historicalCache';
+
+// Daily columns from `startDate`, close rising by one a day from 100
+function history(rows: number, startDate: string): OHLCVColumns {
+  const columns = allocateColumns(rows);
+  const firstDay = toEpochDay(startDate);
+  for (let i = 0; i < rows; i++) {
+    columns.date[i] = firstDay + i;
+    columns.open[i] = 100 + i;
+    columns.high[i] = 101 + i;
+    columns.low[i] = 99 + i;
+    columns.close[i] = 100 + i;
+    columns.volume[i] = 1000;
+  }
+  return columns;
+}
 
 // Mock data provider
 jest.mock('../services/dataProvider', () => {
@@ -34,6 +51,15 @@ jest.mock('../cache/fileCache', () => ({
   },
 }));
 
+// Mock column store (nothing stored unless a test says so)
+jest.mock('../cache/columnStore', () => ({
+  ...jest.requireActual('../cache/columnStore'),
+  historicalStore: {
+    load: jest.fn(async () => null),
+    purge: jest.fn(),
+  },
+}));
+
 // Mock native module
 jest.mock('../native/dist/wrapper', () => ({
   calculateStockSpan: jest.fn(async (prices: Float64Array) => {
@@ -58,8 +84,41 @@ jest.mock('../native/dist/wrapper', () => ({
     avg: 105,
     pattern: 'stable',
   })),
+  serializeWindowResult: jest.fn(async (_handle, format: string) => {
+    return Buffer.from(format === 'ndjson' ? '' : '[]');
+  }),
+  analyzeSlidingWindow: jest.fn(async (prices: Float64Array, windowSize: number) => ({
+    count: prices.length - windowSize + 1,
+  })),
+  iterateWindowChunks: jest.fn(async function* () {
+    yield Buffer.from('[');
+    yield Buffer.from(']');
+  }),
+  freeWindowResult: jest.fn(async () => undefined),
+  registerSeries: jest.fn(() => 1),
+  releaseSeries: jest.fn(() => true),
+  getSeriesInfo: jest.fn(() => null),
+  querySeriesRange: jest.fn(async () => ({
+    min: 100,
+    max: 110,
+    avg: 105,
+    variance: 10,
+  })),
 }));
 
+// Mock worker pool (used once a test unsets DSA_WORKER_THREADS=0)
+jest.mock('../native/dist/workerPool', () => {
+  const pool = {
+    calculateStockSpan: jest.fn(async (prices: Float64Array) => new Int32Array(prices.length).fill(3)),
+    queryRange: jest.fn(async () => ({ min: 1, max: 2, avg: 1.5, variance: 0.25 })),
+    serializeWindows: jest.fn(async () => Buffer.from('[]')),
+  };
+  return {
+    getWorkerPool: jest.fn(() => pool),
+    closeWorkerPool: jest.fn(),
+  };
+});
+
 describe('AnalysisService', () => {
   beforeEach(() => {
     jest.clearAllMocks();
@@ -81,6 +140,110 @@ describe('AnalysisService', () => {
       expect(result.processingTimeMs).toBeGreaterThan(0);
     });
 
+    it('should pass Float32Array prices to the native module unconverted', async () => {
+      const { calculateStockSpan } = jest.requireMock('../native/dist/wrapper');
+      const prices = new Float32Array([100, 102, 98, 105, 107]);
+
+      await analysisService.calculateSpan(undefined, undefined, undefined, prices);
+
+      expect(calculateStockSpan).toHaveBeenLastCalledWith(prices);
+    });
+
+    it('should register symbol history once and analyze it by series id', async () => {
+      const { calculateStockSpan, registerSeries } = jest.requireMock('../native/dist/wrapper');
+      const { createDataProvider } = jest.requireMock('../services/dataProvider');
+      const provider = createDataProvider();
+      provider.fetchHistoricalData.mockResolvedValue(history(4, '2024-01-01'));
+
+      await analysisService.calculateSpan('SERIES', '2024-01-01', '2024-01-04');
+      await analysisService.calculateSpan('SERIES', '2024-01-01', '2024-01-04');
+
+      expect(provider.fetchHistoricalData).toHaveBeenCalledTimes(1);
+      expect(registerSeries).toHaveBeenCalledTimes(1);
+      expect(calculateStockSpan).toHaveBeenLastCalledWith(1);
+    });
+
+    it('should register stored close columns without fetching or JSON caching', async () => {
+      const { registerSeries } = jest.requireMock('../native/dist/wrapper');
+      const { historicalStore } = jest.requireMock('../cache/columnStore');
+      const { createDataProvider } = jest.requireMock('../services/dataProvider');
+      const { cache } = jest.requireMock('../cache/fileCache');
+      const provider = createDataProvider();
+      const close = Float64Array.from({ length: 5 }, (_, i) => 100 + i);
+      historicalStore.load.mockResolvedValueOnce({ columns: { close }, fetched: false });
+
+      await analysisService.calculateSpan('STORED', '2024-03-01', '2024-03-05');
+
+      expect(provider.fetchHistoricalData).not.toHaveBeenCalled();
+      expect(cache.get).not.toHaveBeenCalled();
+      expect(registerSeries).toHaveBeenCalledWith('historical:STORED:2024-03-01:2024-03-05', close);
+    });
+
+    it('should share one provider fetch between concurrent misses', async () => {
+      const { createDataProvider } = jest.requireMock('../services/dataProvider');
+      const provider = createDataProvider();
+      provider.fetchHistoricalData.mockResolvedValue(history(3, '2024-04-01'));
+
+      await Promise.all(
+        Array.from({ length: 5 }, () =>
+          analysisService.calculateSpan('HERD', '2024-04-01', '2024-04-03')
+        )
+      );
+
+      expect(provider.fetchHistoricalData).toHaveBeenCalledTimes(1);
+    });
+
+    it('should keep an expired series registered until its analysis finishes', async () => {
+      const { calculateStockSpan, registerSeries, releaseSeries } = jest.requireMock('../native/dist/wrapper');
+      const { createDataProvider } = jest.requireMock('../services/dataProvider');
+      const provider = createDataProvider();
+      provider.fetchHistoricalData.mockResolvedValue(history(3, '2024-05-01'));
+      registerSeries.mockReturnValueOnce(7).mockReturnValueOnce(8);
+
+      let finish = () => {};
+      calculateStockSpan.mockImplementationOnce(
+        (id: number) => new Promise(resolve => {
+          finish = () => resolve(new Int32Array(id));
+        })
+      );
+      const running = analysisService.calculateSpan('HELD', '2024-05-01', '2024-05-03');
+      await new Promise(resolve => setImmediate(resolve));
+
+      // Another symbol registers after the first series has expired
+      const later = Date.now() + HISTORICAL_TTL_MS + 1;
+      const clock = jest.spyOn(Date, 'now').mockReturnValue(later);
+      try {
+        await analysisService.calculateSpan('OTHER', '2024-05-01', '2024-05-03');
+        expect(releaseSeries).not.toHaveBeenCalledWith(7);
+
+        finish();
+        await running;
+        expect(releaseSeries).toHaveBeenCalledWith(7);
+      } finally {
+        clock.mockRestore();
+      }
+    });
+
+    it('should free the least recently used series over the budget', async () => {
+      const { registerSeries, releaseSeries } = jest.requireMock('../native/dist/wrapper');
+      const { createDataProvider } = jest.requireMock('../services/dataProvider');
+      const provider = createDataProvider();
+      provider.fetchHistoricalData.mockImplementation(async () => history(3, '2024-06-01'));
+      registerSeries.mockReturnValueOnce(21).mockReturnValueOnce(22).mockReturnValueOnce(23);
+
+      // Room for two series of three closes
+      const service = new AnalysisService(2 * 3 * Float64Array.BYTES_PER_ELEMENT);
+      await service.calculateSpan('FIRST', '2024-06-01', '2024-06-03');
+      await service.calculateSpan('SECOND', '2024-06-01', '2024-06-03');
+      await service.calculateSpan('FIRST', '2024-06-01', '2024-06-03');
+      expect(releaseSeries).not.toHaveBeenCalled();
+
+      await service.calculateSpan('THIRD', '2024-06-01', '2024-06-03');
+      expect(releaseSeries).toHaveBeenCalledTimes(1);
+      expect(releaseSeries).toHaveBeenCalledWith(22);
+      expect(registerSeries).toHaveBeenCalledTimes(3);
+    });
+
     it('should throw error when neither symbol nor prices provided', async () => {
       await expect(
         analysisService.calculateSpan(undefined, undefined, undefined, undefined)
@@ -114,6 +277,19 @@ describe('AnalysisService', () => {
       expect(result.processingTimeMs).toBeGreaterThan(0);
     });
 
+    it('should query registered series through the native tree cache', async () => {
+      const { querySeriesRange, withSegmentTree } = jest.requireMock('../native/dist/wrapper');
+      const { createDataProvider } = jest.requireMock('../services/dataProvider');
+      const provider = createDataProvider();
+      provider.fetchHistoricalData.mockResolvedValue(history(6, '2024-02-01'));
+
+      const result = await analysisService.analyzeRange('RANGE', '2024-02-01', '2024-02-06', 1, 4);
+
+      expect(result.stats.max).toBe(110);
+      expect(querySeriesRange).toHaveBeenCalledWith(1, 1, 4);
+      expect(withSegmentTree).not.toHaveBeenCalled();
+    });
+
     it('should throw error for invalid range bounds', async () => {
       const prices = [100, 102, 98, 105, 107];
       
@@ -168,6 +344,103 @@ describe('AnalysisService', () => {
     });
   });
 
+  describe('analyzeWindowEncoded', () => {
+    it('should return natively serialized windows', async () => {
+      const prices = new Float64Array([100, 102, 98, 105, 107]);
+
+      const result = await analysisService.analyzeWindowEncoded(
+        undefined,
+        undefined,
+        undefined,
+        3,
+        prices,
+        'ndjson'
+      );
+
+      expect(result.windowSize).toBe(3);
+      expect(result.format).toBe('ndjson');
+      expect(Buffer.isBuffer(result.windows)).toBe(true);
+    });
+
+    it('should throw error for invalid window size', async () => {
+      const prices = [100, 102, 98];
+
+      await expect(
+        analysisService.analyzeWindowEncoded(undefined, undefined, undefined, 5, prices)
+      ).rejects.toThrow('Invalid window size');
+    });
+  });
+
+  describe('with the worker pool', () => {
+    beforeEach(() => {
+      delete process.env.DSA_WORKER_THREADS;
+    });
+
+    afterEach(() => {
+      process.env.DSA_WORKER_THREADS = '0';
+    });
+
+    it('should run span, range and encoded window analyses in workers', async () => {
+      const wrapper = jest.requireMock('../native/dist/wrapper');
+      const pool = jest.requireMock('../native/dist/workerPool').getWorkerPool();
+      const prices = new Float64Array([100, 102, 98, 105, 107]);
+
+      const span = await analysisService.calculateSpan(undefined, undefined, undefined, prices);
+      const range = await analysisService.analyzeRange(undefined, undefined, undefined, 1, 3, prices);
+      await analysisService.analyzeWindowEncoded(undefined, undefined, undefined, 3, prices, 'ndjson');
+
+      expect(span.spans).toEqual([3, 3, 3, 3, 3]);
+      expect(range.stats.min).toBe(1);
+      expect(pool.calculateStockSpan).toHaveBeenCalledWith(prices);
+      expect(pool.queryRange).toHaveBeenCalledWith(prices, 1, 3);
+      expect(pool.serializeWindows).toHaveBeenCalledWith(prices, 3, 'ndjson');
+      expect(wrapper.calculateStockSpan).not.toHaveBeenCalled();
+      expect(wrapper.withSegmentTree).not.toHaveBeenCalled();
+      expect(wrapper.withSlidingWindow).not.toHaveBeenCalled();
+    });
+
+    it('should fall back to the main thread when workers fail to start', async () => {
+      const wrapper = jest.requireMock('../native/dist/wrapper');
+      const pool = jest.requireMock('../native/dist/workerPool').getWorkerPool();
+      const prices = new Float64Array([100, 102, 98, 105, 107]);
+
+      pool.failed = true;
+      try {
+        await analysisService.calculateSpan(undefined, undefined, undefined, prices);
+      } finally {
+        delete pool.failed;
+      }
+
+      expect(wrapper.calculateStockSpan).toHaveBeenCalled();
+      expect(pool.calculateStockSpan).not.toHaveBeenCalled();
+    });
+  });
+
+  describe('streamWindows', () => {
+    it('should stream encoded chunks and free the native result', async () => {
+      const { freeWindowResult } = jest.requireMock('../native/dist/wrapper');
+      const prices = new Float64Array([100, 102, 98, 105, 107]);
+
+      const result = await analysisService.streamWindows(
+        undefined,
+        undefined,
+        undefined,
+        2,
+        prices
+      );
+
+      expect(result.windowCount).toBe(4);
+
+      const chunks: Buffer[] = [];
+      for await (const chunk of result.stream) {
+        chunks.push(chunk as Buffer);
+      }
+
+      expect(Buffer.concat(chunks).toString()).toBe('[]');
+      expect(freeWindowResult).toHaveBeenCalledTimes(1);
+    });
+  });
+
   describe('searchSymbols', () => {
     it('should return empty array on provider error', async () => {
       const result = await analysisService.searchSymbols('AAPL');
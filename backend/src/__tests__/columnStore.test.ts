@@ -0,0 +1,204 @@
+/**
+ * Historical column store unit tests
+ *
+ * The native store is replaced by a stand-in with the same append/coverage
+ * rules (float64 columns, dates in epoch milliseconds); rows are generated
+ * per requested day, or by a stand-in for Yahoo's chart endpoint.
+ */
+
+import fs from 'fs';
+import os from 'os';
+import path from 'path';
+import { HistoricalStore } from '../cache/columnStore';
+import { YahooFinanceProvider } from '../services/dataProvider';
+import { OHLCVColumns } from '../types';
+import { allocateColumns, toEpochDay } from '../utils/ohlcv';
+
+jest.mock('../nativeBridge', () => {
+  // State lives in the store directory, so renames carry it along
+  const names = ['date', 'open', 'high', 'low', 'close', 'volume'];
+
+  class MockColumnStore {
+    private file: string;
+    private state: {
+      columns: Record<string, number[]>;
+      coverage: { start: number; end: number } | null;
+    };
+
+    constructor(dir: string) {
+      // eslint-disable-next-line @typescript-eslint/no-var-requires
+      const nodeFs = require('fs');
+      nodeFs.mkdirSync(dir, { recursive: true });
+      this.file = `${dir}/state.json`;
+      this.state = nodeFs.existsSync(this.file)
+        ? JSON.parse(nodeFs.readFileSync(this.file, 'utf-8'))
+        : { columns: Object.fromEntries(names.map(name => [name, []])), coverage: null };
+    }
+
+    get coverage() {
+      return this.state.coverage;
+    }
+
+    async append(columns: Record<string, Float64Array>, rangeStart: number, rangeEnd: number): Promise<number> {
+      const { coverage, columns: stored } = this.state;
+      if (coverage && rangeStart > coverage.end) throw new Error('gap');
+      const last = stored.date.length > 0 ? stored.date[stored.date.length - 1] : -Infinity;
+      let appended = 0;
+      columns.date.forEach((date, i) => {
+        if (date <= last || date > rangeEnd) return;
+        names.forEach(name => stored[name].push(columns[name][i]));
+        appended++;
+      });
+      this.state.coverage = coverage
+        ? { start: coverage.start, end: Math.max(coverage.end, rangeEnd) }
+        : { start: rangeStart, end: rangeEnd };
+      // eslint-disable-next-line @typescript-eslint/no-var-requires
+      require('fs').writeFileSync(this.file, JSON.stringify(this.state));
+      return appended;
+    }
+
+    readRange(startDate: number, endDate: number) {
+      const { columns: stored } = this.state;
+      const rows = stored.date
+        .map((date, i) => (date >= startDate && date <= endDate ? i : -1))
+        .filter(i => i >= 0);
+      return Object.fromEntries(
+        names.map(name => [name, Float64Array.from(rows, i => stored[name][i])])
+      );
+    }
+
+    close(): void {}
+  }
+
+  return {
+    openColumnStore: (dir: string) => new MockColumnStore(dir),
+    // Chart responses are parsed in JS
+    parseChartColumns: () => {
+      throw new Error('Native DSA module not compiled');
+    },
+  };
+});
+
+// One row per day in [startDate, endDate], close = day number
+const provider = jest.fn(async (startDate: string, endDate: string): Promise<OHLCVColumns> => {
+  const firstDay = toEpochDay(startDate);
+  const columns = allocateColumns(toEpochDay(endDate) - firstDay + 1);
+  for (let i = 0; i < columns.date.length; i++) {
+    const day = firstDay + i;
+    columns.date[i] = day;
+    columns.open[i] = day;
+    columns.high[i] = day;
+    columns.low[i] = day;
+    columns.close[i] = day;
+    columns.volume[i] = 1;
+  }
+  return columns;
+});
+
+describe('HistoricalStore', () => {
+  let rootDir: string;
+  let store: HistoricalStore;
+
+  beforeEach(() => {
+    provider.mockClear();
+    rootDir = fs.mkdtempSync(path.join(os.tmpdir(), 'dsa-columns-'));
+    store = new HistoricalStore(rootDir);
+  });
+
+  afterEach(() => {
+    fs.rmSync(rootDir, { recursive: true, force: true });
+  });
+
+  it('should fetch a range once and then serve it from the store', async () => {
+    const first = await store.load('ABC', '2020-01-01', '2020-01-10', provider);
+    const second = await store.load('abc', '2020-01-03', '2020-01-08', provider);
+
+    expect(first?.fetched).toBe(true);
+    expect(first?.columns.close.length).toBe(10);
+    expect(second?.fetched).toBe(false);
+    expect(second?.columns.date.at(0)).toBe(toEpochDay('2020-01-03'));
+    expect(second?.columns.close.length).toBe(6);
+    expect(provider).toHaveBeenCalledTimes(1);
+  });
+
+  it('should fetch only the missing edges of a wider range', async () => {
+    await store.load('ABC', '2020-01-05', '2020-01-10', provider);
+    const wider = await store.load('ABC', '2020-01-01', '2020-01-15', provider);
+
+    expect(provider).toHaveBeenNthCalledWith(2, '2020-01-01', '2020-01-04');
+    expect(provider).toHaveBeenNthCalledWith(3, '2020-01-11', '2020-01-15');
+    expect(wider?.columns).toEqual(await provider('2020-01-01', '2020-01-15'));
+  });
+
+  it('should leave ranges far from the stored history to the caller', async () => {
+    await store.load('ABC', '2020-01-01', '2020-01-05', provider);
+    const distant = await store.load('ABC', '2021-06-01', '2021-06-05', provider);
+
+    expect(distant).toBeNull();
+    expect(provider).toHaveBeenCalledTimes(1);
+  });
+
+  it('should keep the stored history across instances', async () => {
+    await store.load('ABC', '2020-01-01', '2020-01-10', provider);
+    const reopened = await new HistoricalStore(rootDir).load('ABC', '2020-01-02', '2020-01-04', provider);
+
+    expect(reopened?.fetched).toBe(false);
+    expect(reopened?.columns.close.length).toBe(3);
+  });
+});
+
+describe('HistoricalStore with the Yahoo provider', () => {
+  let rootDir: string;
+
+  // Chart endpoint: one bar per day stamped at 14:30 UTC, for
+  // period1 <= timestamp < period2; close = day number
+  function yahoo(): YahooFinanceProvider {
+    const provider = new YahooFinanceProvider();
+    const client = (provider as unknown as { client: { get: unknown } }).client;
+    client.get = jest.fn(async (_url: string, options: { params: Record<string, number> }) => {
+      const { period1, period2 } = options.params;
+      const timestamp: number[] = [];
+      for (let day = Math.floor(period1 / 86400); day * 86400 < period2; day++) {
+        const time = day * 86400 + 52200;
+        if (time >= period1 && time < period2) timestamp.push(time);
+      }
+      const close = timestamp.map(time => Math.floor(time / 86400));
+      const quote = { open: close, high: close, low: close, close, volume: close };
+      const body = { chart: { result: [{ timestamp, indicators: { quote: [quote] } }] } };
+      return { data: Buffer.from(JSON.stringify(body)) };
+    });
+    return provider;
+  }
+
+  beforeEach(() => {
+    rootDir = fs.mkdtempSync(path.join(os.tmpdir(), 'dsa-columns-'));
+  });
+
+  afterEach(() => {
+    fs.rmSync(rootDir, { recursive: true, force: true });
+  });
+
+  it('should store the end date of each fetched range', async () => {
+    const provider = yahoo();
+    const fetch = (start: string, end: string) => provider.fetchHistoricalData('ABC', start, end);
+    const store = new HistoricalStore(rootDir);
+
+    const first = await store.load('ABC', '2020-01-01', '2020-01-10', fetch);
+    const rolled = await store.load('ABC', '2020-01-02', '2020-01-11', fetch);
+    const reread = await new HistoricalStore(rootDir).load('ABC', '2020-01-01', '2020-01-11', fetch);
+
+    expect(Array.from(first?.columns.date ?? [])).toEqual(
+      Array.from({ length: 10 }, (_, i) => toEpochDay('2020-01-01') + i)
+    );
+    expect(rolled?.columns.date.length).toBe(10);
+    expect(rolled?.columns.close.at(-1)).toBe(toEpochDay('2020-01-11'));
+    expect(reread?.fetched).toBe(false);
+    expect(reread?.columns.date.length).toBe(11);
+  });
+
+  it('should return only the requested days', async () => {
+    const data = await yahoo().fetchHistoricalData('ABC', '2020-01-05', '2020-01-05');
+
+    expect(Array.from(data.date)).toEqual(new Array(1).fill(toEpochDay('2020-01-05')));
+  });
+});
@@ -0,0 +1,108 @@
+/**
+ * File cache expiry index unit tests
+ */
+
+import fs from 'fs';
+import os from 'os';
+import path from 'path';
+import { FileCache } from '../cache/fileCache';
+
+const entryFiles = (dir: string) => fs.readdirSync(dir).filter(file => file.endsWith('.json'));
+
+describe('FileCache', () => {
+  let cacheDir: string;
+  let now: jest.SpyInstance<number, []>;
+
+  beforeEach(() => {
+    cacheDir = fs.mkdtempSync(path.join(os.tmpdir(), 'dsa-cache-'));
+    now = jest.spyOn(Date, 'now').mockReturnValue(1000000);
+  });
+
+  afterEach(() => {
+    now.mockRestore();
+    fs.rmSync(cacheDir, { recursive: true, force: true });
+  });
+
+  it('should clean expired entries without reading entry files', async () => {
+    const cache = new FileCache(cacheDir);
+    await cache.init();
+    await cache.set('short', { value: 1 }, 1000);
+    await cache.set('long', { value: 2 }, 60000);
+
+    now.mockReturnValue(1005000);
+    const readFile = jest.spyOn(fs.promises, 'readFile');
+    await cache.clean();
+
+    expect(readFile).not.toHaveBeenCalled();
+    readFile.mockRestore();
+    expect(entryFiles(cacheDir)).toHaveLength(1);
+    expect(await cache.get('short')).toBeNull();
+    expect(await cache.get('long')).toEqual({ value: 2 });
+  });
+
+  it('should keep an entry rewritten with a later expiry', async () => {
+    const cache = new FileCache(cacheDir);
+    await cache.set('key', { value: 1 }, 1000);
+    await cache.set('key', { value: 2 }, 60000);
+
+    now.mockReturnValue(1005000);
+    await cache.clean();
+
+    expect(await cache.get('key')).toEqual({ value: 2 });
+  });
+
+  it('should not clean deleted entries again', async () => {
+    const cache = new FileCache(cacheDir);
+    await cache.set('key', { value: 1 }, 1000);
+    await cache.delete('key');
+
+    now.mockReturnValue(1005000);
+    const unlink = jest.spyOn(fs.promises, 'unlink');
+    await cache.clean();
+
+    expect(unlink).not.toHaveBeenCalled();
+    unlink.mockRestore();
+  });
+
+  it('should retry a file whose unlink failed', async () => {
+    const cache = new FileCache(cacheDir);
+    await cache.set('short', { value: 1 }, 1000);
+
+    now.mockReturnValue(1005000);
+    const denied = Object.assign(new Error('denied'), { code: 'EACCES' });
+    const unlink = jest.spyOn(fs.promises, 'unlink').mockRejectedValueOnce(denied);
+    await cache.clean();
+    expect(entryFiles(cacheDir)).toHaveLength(1);
+
+    await new FileCache(cacheDir).clean();
+    expect(entryFiles(cacheDir)).toHaveLength(0);
+
+    await cache.clean();
+    expect(entryFiles(cacheDir)).toHaveLength(0);
+    unlink.mockRestore();
+  });
+
+  it('should keep the index across instances', async () => {
+    const first = new FileCache(cacheDir);
+    await first.set('short', { value: 1 }, 1000);
+    await first.set('long', { value: 2 }, 60000);
+
+    now.mockReturnValue(1005000);
+    await new FileCache(cacheDir).clean();
+
+    expect(entryFiles(cacheDir)).toHaveLength(1);
+  });
+
+  it('should index a cache directory written without an index', async () => {
+    await new FileCache(cacheDir).set('short', { value: 1 }, 1000);
+    await new FileCache(cacheDir).set('long', { value: 2 }, 60000);
+    fs.unlinkSync(path.join(cacheDir, 'expiry.idx'));
+
+    now.mockReturnValue(1005000);
+    const cache = new FileCache(cacheDir);
+    await cache.clean();
+
+    expect(entryFiles(cacheDir)).toHaveLength(1);
+    expect(await cache.get('long')).toEqual({ value: 2 });
+  });
+});
@@ -0,0 +1,51 @@
+/**
+ * Memory cache tier unit tests
+ */
+
+import { MemoryCache } from '../cache/memoryCache';
+
+const sizeOf = (value: Float64Array) => value.byteLength;
+
+describe('MemoryCache', () => {
+  it('should count hits and misses', () => {
+    const memory = new MemoryCache<Float64Array>(sizeOf, 1024);
+    const value = new Float64Array(4);
+
+    expect(memory.get('a')).toBeNull();
+    memory.set('a', value);
+
+    expect(memory.get('a')).toBe(value);
+    expect(memory.stats()).toMatchObject({ entries: 1, byteLength: 32, hits: 1, misses: 1 });
+  });
+
+  it('should evict least recently used entries over the byte budget', () => {
+    const memory = new MemoryCache<Float64Array>(sizeOf, 64);
+    memory.set('a', new Float64Array(4));
+    memory.set('b', new Float64Array(4));
+    memory.get('a');
+    memory.set('c', new Float64Array(4));
+
+    expect(memory.get('b')).toBeNull();
+    expect(memory.get('a')).not.toBeNull();
+    expect(memory.get('c')).not.toBeNull();
+    expect(memory.stats()).toMatchObject({ entries: 2, byteLength: 64, evictions: 1 });
+  });
+
+  it('should drop expired entries on access', () => {
+    const memory = new MemoryCache<Float64Array>(sizeOf, 1024);
+    const now = jest.spyOn(Date, 'now').mockReturnValue(1000);
+    memory.set('a', new Float64Array(4), 50);
+
+    now.mockReturnValue(1050);
+    expect(memory.get('a')).toBeNull();
+    expect(memory.stats().byteLength).toBe(0);
+    now.mockRestore();
+  });
+
+  it('should not hold a value larger than the budget', () => {
+    const memory = new MemoryCache<Float64Array>(sizeOf, 16);
+    memory.set('a', new Float64Array(4));
+
+    expect(memory.stats().entries).toBe(0);
+  });
+});
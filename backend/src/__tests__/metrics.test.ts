@@ -0,0 +1,62 @@
+/**
+ * Prometheus formatting of native call statistics
+ */
+
+import { formatNativeMetrics, NativeStatsSnapshot } from '../utils/metrics';
+
+// Bounds as libdsa reports them: 64 ns, then four per power of two
+function bucketBounds(): number[] {
+  const bounds = [2 ** 6];
+  for (let shift = 6; shift <= 36; shift++) {
+    for (let sub = 1; sub <= 4; sub++) {
+      bounds.push((4 + sub) * 2 ** (shift - 2));
+    }
+  }
+  bounds.push(Infinity);
+  return bounds;
+}
+
+function snapshot(histogram: Map<number, number>): NativeStatsSnapshot {
+  const bounds = bucketBounds();
+  const counts = bounds.map((_, i) => histogram.get(i) ?? 0);
+  const calls = counts.reduce((a, b) => a + b, 0);
+  return {
+    enabled: true,
+    bucketBoundsNs: bounds,
+    functions: {
+      stock_span: { calls, errors: 1, elements: 500, bytesAllocated: 2000, totalNs: 3e6, histogram: counts },
+    },
+  };
+}
+
+describe('formatNativeMetrics', () => {
+  it('should report the module as down without stats', () => {
+    const text = formatNativeMetrics(null);
+    expect(text).toContain('dsa_native_up 0');
+    expect(text).not.toContain('dsa_native_calls_total');
+  });
+
+  it('should emit counters per function', () => {
+    const text = formatNativeMetrics(snapshot(new Map([[0, 2]])));
+    expect(text).toContain('dsa_native_up 1');
+    expect(text).toContain('dsa_native_stats_enabled 1');
+    expect(text).toContain('# TYPE dsa_native_calls_total counter');
+    expect(text).toContain('dsa_native_calls_total{function="stock_span"} 2');
+    expect(text).toContain('dsa_native_errors_total{function="stock_span"} 1');
+    expect(text).toContain('dsa_native_elements_total{function="stock_span"} 500');
+    expect(text).toContain('dsa_native_allocated_bytes_total{function="stock_span"} 2000');
+  });
+
+  it('should emit cumulative histogram buckets at even powers of two', () => {
+    // One call under 64 ns, one in [64, 80) ns, one in [256, 320) ns
+    const text = formatNativeMetrics(snapshot(new Map([[0, 1], [1, 1], [9, 1]])));
+    const histogram = 'dsa_native_call_duration_seconds';
+    expect(text).toContain(`${histogram}_bucket{function="stock_span",le="6.4e-8"} 1`);
+    expect(text).toContain(`${histogram}_bucket{function="stock_span",le="2.56e-7"} 2`);
+    expect(text).toContain(`${histogram}_bucket{function="stock_span",le="0.000001024"} 3`);
+    expect(text).toContain(`${histogram}_bucket{function="stock_span",le="+Inf"} 3`);
+    expect(text).toContain(`${histogram}_sum{function="stock_span"} 0.003`);
+    expect(text).toContain(`${histogram}_count{function="stock_span"} 3`);
+    expect(text).not.toContain('le="1.28e-7"');
+  });
+});
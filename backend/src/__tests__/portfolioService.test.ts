@@ -0,0 +1,197 @@
+/**
+ * Portfolio batch analysis unit tests
+ *
+ * Fetches are held open by the test so concurrency and cancellation can be
+ * observed; the native batch analyzer echoes one result per job.
+ */
+
+import { portfolioService } from '../services/portfolioService';
+import { getHistoricalColumns } from '../cache/historicalCache';
+import { analyzeBatch, getAnalysisPool } from '../nativeBridge';
+import { Portfolio } from '../types';
+import { allocateColumns } from '../utils/ohlcv';
+
+jest.mock('../services/dataProvider', () => ({
+  createDataProvider: jest.fn(() => ({ fetchHistoricalData: jest.fn() })),
+}));
+
+jest.mock('../cache/historicalCache', () => ({
+  getHistoricalColumns: jest.fn(),
+}));
+
+jest.mock('../nativeBridge', () => ({
+  analyzeBatch: jest.fn(async (jobs: Array<{ prices: Float64Array }>) =>
+    jobs.map(({ prices }) => ({
+      computeTimeMs: 1,
+      spans: new Int32Array(prices.length).fill(2),
+      stats: { min: 1, max: 3, avg: 2, variance: 1 },
+    }))
+  ),
+  getAnalysisPool: jest.fn(() => null),
+}));
+
+const mockGetHistoricalColumns = getHistoricalColumns as jest.Mock;
+const mockAnalyzeBatch = analyzeBatch as jest.Mock;
+const mockGetAnalysisPool = getAnalysisPool as jest.Mock;
+
+function portfolioOf(symbols: string[]): Portfolio {
+  return {
+    id: 'batch',
+    name: 'Batch',
+    holdings: symbols.map(symbol => ({
+      symbol,
+      quantity: 1,
+      averagePrice: 1,
+      addedAt: '2024-01-01T00:00:00.000Z',
+    })),
+    createdAt: '2024-01-01T00:00:00.000Z',
+    updatedAt: '2024-01-01T00:00:00.000Z',
+  };
+}
+
+// Fetches that resolve when the test says so, keyed by symbol
+function heldFetches() {
+  const waiting = new Map<string, () => void>();
+  mockGetHistoricalColumns.mockImplementation(
+    (symbol: string) =>
+      new Promise(resolve => {
+        waiting.set(symbol, () => resolve({ columns: allocateColumns(3), cached: false }));
+      })
+  );
+  return waiting;
+}
+
+const flush = () => new Promise(resolve => setImmediate(resolve));
+
+describe('PortfolioService.batchAnalyze', () => {
+  beforeEach(() => {
+    mockGetHistoricalColumns.mockReset();
+    mockAnalyzeBatch.mockClear();
+    mockGetAnalysisPool.mockReturnValue(null);
+  });
+
+  it('should keep up to `concurrency` holdings in flight', async () => {
+    jest.spyOn(portfolioService, 'getPortfolio').mockResolvedValue(portfolioOf(['A', 'B', 'C', 'D']));
+    const waiting = heldFetches();
+    const progress: string[] = [];
+
+    const pending = portfolioService.batchAnalyze(
+      'batch',
+      '2024-01-01',
+      '2024-01-03',
+      (current, total, symbol) => progress.push(`${current}/${total} ${symbol}`),
+      { concurrency: 3 }
+    );
+    await flush();
+    expect(Array.from(waiting.keys())).toEqual(['A', 'B', 'C']);
+
+    // A slow first holding does not hold up the rest
+    waiting.get('C')?.();
+    await flush();
+    expect(waiting.has('D')).toBe(true);
+
+    for (const symbol of ['A', 'B', 'D']) waiting.get(symbol)?.();
+    const { results } = await pending;
+
+    expect(progress).toEqual(['1/4 A', '2/4 B', '3/4 C', '4/4 D']);
+    expect(results.map(result => result.symbol)).toEqual(['A', 'B', 'C', 'D']);
+    expect(results.every(result => result.success && result.data?.spanAvg === 2)).toBe(true);
+  });
+
+  it('should fall back to the default concurrency for an invalid value', async () => {
+    jest.spyOn(portfolioService, 'getPortfolio').mockResolvedValue(portfolioOf(['A', 'B', 'C']));
+    mockGetHistoricalColumns.mockResolvedValue({ columns: allocateColumns(3), cached: false });
+
+    for (const concurrency of [NaN, 0, 1.5]) {
+      const { results } = await portfolioService.batchAnalyze('batch', '2024-01-01', '2024-01-03', undefined, {
+        concurrency,
+      });
+      expect(Array.from(results, result => result?.symbol)).toEqual(['A', 'B', 'C']);
+    }
+  });
+
+  it('should analyze series that finish together in one native batch', async () => {
+    jest.spyOn(portfolioService, 'getPortfolio').mockResolvedValue(portfolioOf(['A', 'B', 'C']));
+    const waiting = heldFetches();
+
+    const pending = portfolioService.batchAnalyze('batch', '2024-01-01', '2024-01-03', undefined, {
+      concurrency: 3,
+    });
+    await flush();
+    for (const release of waiting.values()) release();
+    await pending;
+
+    const jobCounts = mockAnalyzeBatch.mock.calls.map(call => call.at(0).length);
+    expect(jobCounts.reduce((sum, count) => sum + count, 0)).toBe(3);
+    expect(jobCounts.length).toBeLessThan(3);
+  });
+
+  it('should record per-holding failures without failing the batch', async () => {
+    jest.spyOn(portfolioService, 'getPortfolio').mockResolvedValue(portfolioOf(['A', 'EMPTY', 'BAD']));
+    mockGetHistoricalColumns.mockImplementation(async (symbol: string) => {
+      if (symbol === 'BAD') throw new Error('Symbol not found');
+      return { columns: allocateColumns(symbol === 'EMPTY' ? 0 : 3), cached: false };
+    });
+
+    const { results } = await portfolioService.batchAnalyze('batch', '2024-01-01', '2024-01-03');
+
+    expect(results.map(result => result.error)).toEqual([
+      undefined,
+      'No data available',
+      'Symbol not found',
+    ]);
+  });
+
+  it('should stop starting holdings and reject once aborted', async () => {
+    jest.spyOn(portfolioService, 'getPortfolio').mockResolvedValue(portfolioOf(['A', 'B', 'C', 'D']));
+    const waiting = heldFetches();
+    const controller = new AbortController();
+
+    const pending = portfolioService.batchAnalyze('batch', '2024-01-01', '2024-01-03', undefined, {
+      concurrency: 2,
+      signal: controller.signal,
+    });
+    await flush();
+    controller.abort(new Error('Client went away'));
+
+    await expect(pending).rejects.toThrow('Client went away');
+
+    // In-flight fetches finish, but nothing new starts or gets analyzed
+    for (const release of waiting.values()) release();
+    await flush();
+    expect(Array.from(waiting.keys())).toEqual(['A', 'B']);
+    expect(mockAnalyzeBatch).not.toHaveBeenCalled();
+  });
+
+  it('should pass the signal to native analysis', async () => {
+    jest.spyOn(portfolioService, 'getPortfolio').mockResolvedValue(portfolioOf(['A']));
+    mockGetHistoricalColumns.mockResolvedValue({ columns: allocateColumns(3), cached: false });
+    const controller = new AbortController();
+
+    await portfolioService.batchAnalyze('batch', '2024-01-01', '2024-01-03', undefined, {
+      signal: controller.signal,
+    });
+
+    expect(mockAnalyzeBatch.mock.calls.at(0)?.at(1)).toEqual({ signal: controller.signal });
+  });
+
+  it('should run batches in the worker pool when there is one', async () => {
+    jest.spyOn(portfolioService, 'getPortfolio').mockResolvedValue(portfolioOf(['A', 'B']));
+    mockGetHistoricalColumns.mockResolvedValue({ columns: allocateColumns(3), cached: false });
+    const pool = {
+      analyzeBatch: jest.fn(async (jobs: Array<{ prices: Float64Array }>) =>
+        jobs.map(() => ({ computeTimeMs: 1, spans: new Int32Array(1), stats: { min: 1, max: 1, avg: 1, variance: 0 } }))
+      ),
+    };
+    mockGetAnalysisPool.mockReturnValue(pool);
+    const controller = new AbortController();
+
+    const { results } = await portfolioService.batchAnalyze('batch', '2024-01-01', '2024-01-03', undefined, {
+      signal: controller.signal,
+    });
+
+    expect(results.every(result => result.success)).toBe(true);
+    expect(pool.analyzeBatch.mock.calls.at(0)?.at(1)).toEqual({ signal: controller.signal });
+    expect(mockAnalyzeBatch).not.toHaveBeenCalled();
+  });
+});
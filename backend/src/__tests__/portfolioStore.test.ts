@@ -0,0 +1,176 @@
+/**
+ * Log-structured portfolio store unit tests
+ */
+
+import fs from 'fs';
+import os from 'os';
+import path from 'path';
+import { PortfolioStore } from '../services/portfolioStore';
+import { Portfolio, PortfolioHolding } from '../types';
+
+function emptyPortfolio(id: string, updatedAt = '2024-01-01T00:00:00.000Z'): Portfolio {
+  return { id, name: id, holdings: [], createdAt: updatedAt, updatedAt };
+}
+
+function holdings(count: number, quantity = 1): PortfolioHolding[] {
+  return Array.from({ length: count }, (_, i) => ({
+    symbol: `SYM${i}`,
+    quantity,
+    averagePrice: 100 + i,
+    addedAt: '2024-01-01T00:00:00.000Z',
+  }));
+}
+
+const logLines = (dir: string) =>
+  fs.readFileSync(path.join(dir, 'portfolios.log'), 'utf-8').split('\n').filter(Boolean);
+
+describe('PortfolioStore', () => {
+  let dir: string;
+
+  beforeEach(() => {
+    dir = fs.mkdtempSync(path.join(os.tmpdir(), 'dsa-portfolios-'));
+  });
+
+  afterEach(() => {
+    fs.rmSync(dir, { recursive: true, force: true });
+  });
+
+  it('should write a bulk holdings change as one record', async () => {
+    const store = new PortfolioStore(dir);
+    await store.put(emptyPortfolio('p1'));
+    await store.changeHoldings('p1', holdings(500), [], '2024-01-02T00:00:00.000Z');
+
+    expect(logLines(dir)).toHaveLength(2);
+    expect((await store.get('p1'))?.holdings).toHaveLength(500);
+  });
+
+  it('should rebuild the same state from the log', async () => {
+    const store = new PortfolioStore(dir);
+    await store.put(emptyPortfolio('p1'));
+    await store.put(emptyPortfolio('p2'));
+    await store.changeHoldings('p1', holdings(3), [], '2024-01-02T00:00:00.000Z');
+    await store.changeHoldings('p1', holdings(2, 5), ['sym2'], '2024-01-03T00:00:00.000Z');
+    await store.update('p1', { name: 'Renamed' }, '2024-01-04T00:00:00.000Z');
+    await store.delete('p2');
+
+    const reopened = new PortfolioStore(dir);
+    const portfolio = await reopened.get('p1');
+
+    expect(portfolio).toEqual(await store.get('p1'));
+    expect(portfolio?.name).toBe('Renamed');
+    expect(portfolio?.holdings.map(h => `${h.symbol}x${h.quantity}`)).toEqual(['SYM0x5', 'SYM1x5']);
+    expect(await reopened.get('p2')).toBeNull();
+  });
+
+  it('should not change portfolios already handed out', async () => {
+    const store = new PortfolioStore(dir);
+    await store.put(emptyPortfolio('p1'));
+    const before = await store.get('p1');
+
+    await store.changeHoldings('p1', holdings(1), [], '2024-01-02T00:00:00.000Z');
+
+    expect(before?.holdings).toHaveLength(0);
+    expect((await store.get('p1'))?.holdings).toHaveLength(1);
+  });
+
+  it('should batch records made while a write is in flight', async () => {
+    const store = new PortfolioStore(dir);
+    await store.load();
+    const appendFile = jest.spyOn(fs.promises, 'appendFile');
+
+    await Promise.all(
+      Array.from({ length: 20 }, (_, i) => store.put(emptyPortfolio(`p${i}`)))
+    );
+
+    expect(appendFile.mock.calls.length).toBeLessThan(20);
+    appendFile.mockRestore();
+    expect(logLines(dir)).toHaveLength(20);
+  });
+
+  it('should compact the log once it is mostly superseded records', async () => {
+    const store = new PortfolioStore(dir);
+    await store.put(emptyPortfolio('p1'));
+    for (let i = 0; i < 1100; i++) {
+      await store.update('p1', { description: `edit ${i}` }, '2024-01-02T00:00:00.000Z');
+    }
+
+    expect(logLines(dir).length).toBeLessThan(1100);
+    expect((await new PortfolioStore(dir).get('p1'))?.description).toBe('edit 1099');
+
+    await store.compact(true);
+    expect(logLines(dir)).toHaveLength(1);
+  });
+
+  it('should skip a partly written last record', async () => {
+    const store = new PortfolioStore(dir);
+    await store.put(emptyPortfolio('p1'));
+    fs.appendFileSync(path.join(dir, 'portfolios.log'), '{"op":"delete","id":"p');
+
+    expect(await new PortfolioStore(dir).get('p1')).not.toBeNull();
+  });
+
+  it('should keep records appended after a partly written one', async () => {
+    const store = new PortfolioStore(dir);
+    await store.put(emptyPortfolio('p1'));
+    fs.appendFileSync(path.join(dir, 'portfolios.log'), '{"op":"delete","id":"p');
+
+    const reopened = new PortfolioStore(dir);
+    await reopened.put(emptyPortfolio('p2'));
+
+    expect(logLines(dir)).toHaveLength(2);
+    expect((await new PortfolioStore(dir).list()).map(p => p.id).sort()).toEqual(['p1', 'p2']);
+  });
+
+  it('should rewrite a log with a damaged record', async () => {
+    const store = new PortfolioStore(dir);
+    await store.put(emptyPortfolio('p1'));
+    fs.appendFileSync(path.join(dir, 'portfolios.log'), '{"op":"delete","id":"p{"op":"put"}\n');
+
+    expect(await new PortfolioStore(dir).get('p1')).not.toBeNull();
+    expect(logLines(dir)).toHaveLength(1);
+  });
+
+  it('should not show a change whose write failed', async () => {
+    const store = new PortfolioStore(dir);
+    await store.put(emptyPortfolio('p1'));
+    const appendFile = jest
+      .spyOn(fs.promises, 'appendFile')
+      .mockRejectedValueOnce(new Error('disk full'));
+
+    await expect(store.update('p1', { name: 'Renamed' }, '2024-01-02T00:00:00.000Z')).rejects.toThrow(
+      'disk full'
+    );
+    appendFile.mockRestore();
+
+    expect((await store.get('p1'))?.name).toBe('p1');
+  });
+
+  it('should start on a fresh line after a failed write', async () => {
+    const store = new PortfolioStore(dir);
+    await store.put(emptyPortfolio('p1'));
+    const appendFile = jest.spyOn(fs.promises, 'appendFile').mockImplementationOnce(async file => {
+      fs.appendFileSync(file as string, '{"op":"put","portfo');
+      throw new Error('disk full');
+    });
+
+    await expect(store.put(emptyPortfolio('p2'))).rejects.toThrow('disk full');
+    appendFile.mockRestore();
+    await store.put(emptyPortfolio('p3'));
+
+    const ids = (await new PortfolioStore(dir).list()).map(p => p.id).sort();
+    expect(ids).toContain('p1');
+    expect(ids).toContain('p3');
+  });
+
+  it('should migrate per-portfolio JSON files', async () => {
+    for (const id of ['p1', 'p2']) {
+      fs.writeFileSync(path.join(dir, `${id}.json`), JSON.stringify(emptyPortfolio(id), null, 2));
+    }
+
+    const store = new PortfolioStore(dir);
+
+    expect((await store.list()).map(p => p.id).sort()).toEqual(['p1', 'p2']);
+    expect(fs.readdirSync(dir).filter(file => file.endsWith('.json'))).toHaveLength(0);
+    expect(logLines(dir)).toHaveLength(2);
+  });
+});
@@ -16,3 +16,5 @@ jest.mock('../utils/logger', () => ({
 // Set test environment variables
 process.env.NODE_ENV = 'test';
 process.env.DATA_PROVIDER = 'yahoo';
+// Analyses run on the main thread unless a test brings its own pool
+process.env.DSA_WORKER_THREADS = '0';
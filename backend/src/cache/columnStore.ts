@@ -0,0 +1,297 @@
+/**
+ * Columnar on-disk store for historical OHLCV data
+ *
+ * Keeps one native column store (libdsa) per symbol, covering one
+ * contiguous date range. A covered range is reloaded by mapping the column
+ * files: no JSON read or parse, and the close column can go straight to
+ * the native analysis functions. A request that overlaps or adjoins the
+ * stored range fetches only the missing edges and merges them in, so a
+ * daily rolling request fetches a day, not years.
+ *
+ * Only complete days are stored; today's rows are fetched per request.
+ * Ranges far from a symbol's stored history stay with the JSON FileCache.
+ */
+
+import fs from 'fs';
+import path from 'path';
+import { openColumnStore } from '../nativeBridge';
+import { OHLCVColumns } from '../types';
+import {
+  DAY_MS,
+  allocateColumns,
+  concatColumns,
+  fromEpochDay,
+  rowsThrough,
+  sliceColumns,
+  toEpochDay,
+  today,
+} from '../utils/ohlcv';
+import { logger } from '../utils/logger';
+
+// Also keeps symbols safe as directory names (no separators, no leading '.')
+const SYMBOL_PATTERN = /^[A-Z0-9][A-Z0-9.\-]{0,19}$/;
+
+// Provider fetch for an inclusive YYYY-MM-DD range
+export type RangeFetch = (startDate: string, endDate: string) => Promise<OHLCVColumns>;
+
+export interface StoredRange {
+  columns: OHLCVColumns;
+  fetched: boolean;  // true if any part came from the provider
+}
+
+// Native ColumnStoreHandle (see native/src/wrapper.ts): all columns,
+// dates included, are float64 and dates are epoch milliseconds
+type NativeColumns = Record<keyof OHLCVColumns, Float64Array>;
+
+interface NativeColumnStore {
+  readonly coverage: { start: number; end: number } | null;
+  append(columns: NativeColumns, rangeStart: number, rangeEnd: number): Promise<number>;
+  readRange(startDate: number, endDate: number): NativeColumns;
+  close(): void;
+}
+
+/**
+ * A native store seen in epoch days and OHLCVColumns
+ *
+ * Only the date column is converted; price columns pass through, so the
+ * close prices read are still the mapped column file.
+ */
+class ColumnStore {
+  private store: NativeColumnStore;
+
+  constructor(dir: string) {
+    this.store = openColumnStore(dir);
+  }
+
+  get coverage(): { start: number; end: number } | null {
+    const coverage = this.store.coverage;
+    return coverage && { start: coverage.start / DAY_MS, end: coverage.end / DAY_MS };
+  }
+
+  append(columns: OHLCVColumns, rangeStart: number, rangeEnd: number): Promise<number> {
+    const native = {
+      ...columns,
+      date: Float64Array.from(columns.date, day => day * DAY_MS),
+    };
+    return this.store.append(native, rangeStart * DAY_MS, rangeEnd * DAY_MS);
+  }
+
+  readRange(startDay: number, endDay: number): OHLCVColumns {
+    const native = this.store.readRange(startDay * DAY_MS, endDay * DAY_MS);
+    return {
+      ...native,
+      date: Int32Array.from(native.date, time => time / DAY_MS),
+    };
+  }
+
+  close(): void {
+    this.store.close();
+  }
+}
+
+function lastCompleteDay(): number {
+  return today() - 1;
+}
+
+export class HistoricalStore {
+  private rootDir: string;
+  private stores = new Map<string, ColumnStore>();
+  private locks = new Map<string, Promise<unknown>>();
+  private disabled = false;
+
+  constructor(rootDir: string = './cache/columns') {
+    this.rootDir = rootDir;
+  }
+
+  /**
+   * Rows for the range, fetching only what the store does not cover
+   *
+   * Missing days before the stored range are merged in by rewriting the
+   * store; missing days after it are appended. Returns null (without
+   * fetching) if the store cannot serve the range: no complete day in it,
+   * a gap wider than the range itself to the stored history, or no native
+   * module.
+   */
+  async load(
+    symbol: string,
+    startDate: string,
+    endDate: string,
+    fetch: RangeFetch
+  ): Promise<StoredRange | null> {
+    const start = toEpochDay(startDate);
+    const end = toEpochDay(endDate);
+    if (!(start <= Math.min(end, lastCompleteDay()))) return null;
+
+    // One load per symbol at a time: edges are fetched and merged once
+    const key = symbol.toUpperCase();
+    const previous = this.locks.get(key) ?? Promise.resolve();
+    const result = previous.then(() => this.loadLocked(key, start, end, fetch));
+    const settled = result.catch(() => undefined);
+    this.locks.set(key, settled);
+    settled.then(() => {
+      if (this.locks.get(key) === settled) this.locks.delete(key);
+    });
+    return result;
+  }
+
+  /**
+   * Close and delete every store
+   */
+  async purge(): Promise<void> {
+    for (const store of this.stores.values()) store.close();
+    this.stores.clear();
+    await fs.promises.rm(this.rootDir, { recursive: true, force: true });
+  }
+
+  private async loadLocked(
+    key: string,
+    start: number,
+    end: number,
+    fetch: RangeFetch
+  ): Promise<StoredRange | null> {
+    const opened = this.open(key);
+    if (!opened) return null;
+
+    // Store failures fall back to the caller; provider failures propagate
+    const coverage = opened.coverage;
+    if (!coverage) {
+      const data = await fetch(fromEpochDay(start), fromEpochDay(end));
+      const unstored = await this.attempt(key, () => this.append(key, opened, start, end, data));
+      const columns = unstored && (await this.readWith(key, opened, start, end, unstored));
+      return { columns: columns || data, fetched: true };
+    }
+
+    // Fetching across a gap wider than the request costs more than it saves
+    const span = end - start;
+    if (coverage.start - end > span + 1 || start - coverage.end > span + 1) {
+      return null;
+    }
+
+    let store: ColumnStore | null = opened;
+    let unstored: OHLCVColumns | null = allocateColumns(0);
+    let fetched = false;
+    if (start < coverage.start) {
+      const head = await fetch(fromEpochDay(start), fromEpochDay(coverage.start - 1));
+      fetched = true;
+      store = await this.attempt(key, () => this.prepend(key, opened, start, head));
+    }
+    if (store && end > coverage.end) {
+      const tail = await fetch(fromEpochDay(coverage.end + 1), fromEpochDay(end));
+      const current: ColumnStore = store;
+      fetched = true;
+      unstored = await this.attempt(key, () => this.append(key, current, coverage.end, end, tail));
+    }
+    if (!store || !unstored) return null;
+
+    const columns = await this.readWith(key, store, start, end, unstored);
+    if (!columns) return null;
+    if (!fetched) {
+      logger.debug(`Column store hit for ${key} ${fromEpochDay(start)}..${fromEpochDay(end)}`);
+    }
+    return { columns, fetched };
+  }
+
+  /**
+   * Stored rows in [start, end] followed by rows too recent to store
+   */
+  private async readWith(
+    key: string,
+    store: ColumnStore,
+    start: number,
+    end: number,
+    unstored: OHLCVColumns
+  ): Promise<OHLCVColumns | null> {
+    const storedEnd = Math.min(end, store.coverage?.end ?? end);
+    const columns = await this.attempt(key, () => store.readRange(start, storedEnd));
+    return columns && concatColumns(columns, unstored);
+  }
+
+  /**
+   * Run a store operation; null (logged) if it throws or rejects
+   */
+  private async attempt<T>(key: string, operation: () => T | Promise<T>): Promise<T | null> {
+    try {
+      return await operation();
+    } catch (error) {
+      logger.warn(`Column store operation failed for ${key}:`, error);
+      return null;
+    }
+  }
+
+  /**
+   * Append fetched rows for [rangeStart, end]; returns the rows too recent
+   * to store
+   */
+  private async append(
+    key: string,
+    store: ColumnStore,
+    rangeStart: number,
+    end: number,
+    data: OHLCVColumns
+  ): Promise<OHLCVColumns> {
+    const storableEnd = Math.min(end, lastCompleteDay());
+    const appended = await store.append(data, rangeStart, storableEnd);
+    if (appended > 0) {
+      logger.debug(`Column store appended ${appended} rows for ${key}`);
+    }
+    return sliceColumns(data, rowsThrough(data.date, storableEnd));
+  }
+
+  /**
+   * Rewrite a store with `head` before its rows (stores are append-only)
+   */
+  private async prepend(
+    key: string,
+    store: ColumnStore,
+    rangeStart: number,
+    head: OHLCVColumns
+  ): Promise<ColumnStore | null> {
+    const coverage = store.coverage;
+    if (!coverage) return store;
+
+    const earlier = sliceColumns(head, 0, rowsThrough(head.date, coverage.start - 1));
+    const merged = concatColumns(earlier, store.readRange(coverage.start, coverage.end));
+
+    // Build beside the old store, then swap ('~' never appears in a symbol)
+    const dir = path.join(this.rootDir, key);
+    const rebuilt = `${dir}~rebuild`;
+    await fs.promises.rm(rebuilt, { recursive: true, force: true });
+    const fresh = new ColumnStore(rebuilt);
+    try {
+      await fresh.append(merged, rangeStart, coverage.end);
+    } finally {
+      fresh.close();
+    }
+
+    // Arrays already handed out keep their mappings of the old files
+    store.close();
+    this.stores.delete(key);
+    await fs.promises.rm(dir, { recursive: true, force: true });
+    await fs.promises.rename(rebuilt, dir);
+    logger.debug(`Column store for ${key} extended back to ${fromEpochDay(rangeStart)}`);
+    return this.open(key);
+  }
+
+  private open(key: string): ColumnStore | null {
+    const existing = this.stores.get(key);
+    if (existing || this.disabled || !SYMBOL_PATTERN.test(key)) {
+      return existing ?? null;
+    }
+
+    try {
+      fs.mkdirSync(this.rootDir, { recursive: true });
+      const store = new ColumnStore(path.join(this.rootDir, key));
+      this.stores.set(key, store);
+      return store;
+    } catch (error) {
+      if ((error as Error).message.includes('not compiled')) {
+        // No native module: JSON caching only
+        this.disabled = true;
+      }
+      logger.warn(`Column store unavailable for ${key}:`, error);
+      return null;
+    }
+  }
+}
+
+export const historicalStore = new HistoricalStore();
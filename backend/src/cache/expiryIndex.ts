@@ -0,0 +1,204 @@
+/**
+ * Expiry index for the file cache
+ *
+ * Tracks when each cache file expires so cleanup can go straight to the
+ * expired ones instead of reading and parsing every file. In memory it is
+ * a min-heap on expiry time; on disk it is an AppendLog manifest of
+ * "<expiresAt> <name>" lines (expiresAt 0 marks a removal) that is
+ * compacted during cleanup once it is mostly superseded records.
+ *
+ * A heap node whose expiry no longer matches the live entry (the file was
+ * rewritten or deleted since) is stale and skipped when popped.
+ */
+
+import { AppendLog } from '../utils/appendLog';
+import { logger } from '../utils/logger';
+
+export interface HeapNode {
+  expiresAt: number;
+  name: string;
+}
+
+// Rebuild the heap once it holds this many stale nodes beyond twice the live count
+const HEAP_SLACK = 1024;
+
+export class ExpiryIndex {
+  private manifest: AppendLog;
+  private live = new Map<string, number>();  // name -> expiresAt
+  private heap: HeapNode[] = [];
+
+  constructor(manifestPath: string) {
+    this.manifest = new AppendLog(manifestPath, 'cache expiry index');
+  }
+
+  /**
+   * Load the manifest; false if there is none (the caller rebuilds it)
+   */
+  async load(): Promise<boolean> {
+    let lines: string[] | null;
+    try {
+      lines = await this.manifest.read();
+    } catch (error) {
+      logger.warn('Failed to read cache expiry index:', error);
+      return false;
+    }
+    if (!lines) return false;
+
+    this.clear();
+    for (const line of lines) {
+      const separator = line.indexOf(' ');
+      if (separator <= 0) continue;
+      const expiresAt = Number(line.slice(0, separator));
+      if (!Number.isFinite(expiresAt)) continue;
+      this.apply(line.slice(separator + 1), expiresAt);
+    }
+    return true;
+  }
+
+  /**
+   * Record that `name` expires at `expiresAt`
+   */
+  add(name: string, expiresAt: number): Promise<void> {
+    this.apply(name, expiresAt);
+    return this.manifest.append(`${expiresAt} ${name}\n`);
+  }
+
+  /**
+   * Record an expiry in memory only; follow with compact(true) to persist
+   */
+  seed(name: string, expiresAt: number): void {
+    this.apply(name, expiresAt);
+  }
+
+  remove(name: string): Promise<void> {
+    if (!this.live.has(name)) return this.manifest.settled();
+    this.apply(name, 0);
+    return this.manifest.append(`0 ${name}\n`);
+  }
+
+  /**
+   * Names that expired before `now`, earliest first, with their expiry
+   *
+   * They stay indexed: the caller deletes the files, then passes the ones
+   * it deleted to removeExpired() and the ones it could not to retry().
+   */
+  takeExpired(now: number): HeapNode[] {
+    const expired: HeapNode[] = [];
+    const taken = new Set<string>();
+    while (this.heap.length > 0 && this.heap[0].expiresAt < now) {
+      const node = this.pop();
+      if (this.live.get(node.name) !== node.expiresAt) continue;  // Stale
+      if (taken.has(node.name)) continue;  // Indexed twice with one expiry
+      taken.add(node.name);
+      expired.push(node);
+    }
+    return expired;
+  }
+
+  /**
+   * Record the removal of taken entries, skipping any rewritten since
+   */
+  removeExpired(entries: HeapNode[]): Promise<void> {
+    let removals = '';
+    let count = 0;
+    for (const { name, expiresAt } of entries) {
+      if (this.live.get(name) !== expiresAt) continue;
+      this.live.delete(name);
+      removals += `0 ${name}\n`;
+      count++;
+    }
+    if (count === 0) return this.manifest.settled();
+    return this.manifest.append(removals, count);
+  }
+
+  /**
+   * Hand a taken entry back so the next takeExpired() returns it again
+   */
+  retry(entry: HeapNode): void {
+    if (this.live.get(entry.name) === entry.expiresAt) this.push(entry);
+  }
+
+  /**
+   * Rewrite the manifest from scratch if it is mostly superseded records
+   * (or unconditionally with `force`)
+   */
+  compact(force: boolean = false): Promise<void> {
+    if (!force && !this.manifest.needsCompaction(this.live.size)) return this.manifest.settled();
+
+    return this.manifest.rewrite(() => {
+      let text = '';
+      for (const [name, expiresAt] of this.live) text += `${expiresAt} ${name}\n`;
+      return { text, records: this.live.size };
+    });
+  }
+
+  /**
+   * Forget every entry and empty the manifest
+   */
+  reset(): Promise<void> {
+    this.clear();
+    return this.manifest.rewrite(() => ({ text: '', records: 0 }));
+  }
+
+  has(name: string): boolean {
+    return this.live.has(name);
+  }
+
+  get size(): number {
+    return this.live.size;
+  }
+
+  private clear(): void {
+    this.live.clear();
+    this.heap = [];
+  }
+
+  private apply(name: string, expiresAt: number): void {
+    if (expiresAt === 0) {
+      this.live.delete(name);
+      return;
+    }
+    this.live.set(name, expiresAt);
+    this.push({ expiresAt, name });
+
+    // Stale nodes only leave the heap when popped; rebuild if they dominate
+    if (this.heap.length > this.live.size * 2 + HEAP_SLACK) this.rebuildHeap();
+  }
+
+  private rebuildHeap(): void {
+    this.heap = [];
+    for (const [name, expiresAt] of this.live) this.push({ expiresAt, name });
+  }
+
+  private push(node: HeapNode): void {
+    const heap = this.heap;
+    let i = heap.length;
+    heap.push(node);
+    while (i > 0) {
+      const parent = (i - 1) >> 1;
+      if (heap[parent].expiresAt <= node.expiresAt) break;
+      heap[i] = heap[parent];
+      i = parent;
+    }
+    heap[i] = node;
+  }
+
+  private pop(): HeapNode {
+    const heap = this.heap;
+    const top = heap[0];
+    const last = heap.pop() as HeapNode;
+    if (heap.length === 0) return top;
+
+    let i = 0;
+    for (;;) {
+      let child = 2 * i + 1;
+      if (child >= heap.length) break;
+      if (child + 1 < heap.length && heap[child + 1].expiresAt < heap[child].expiresAt) child++;
+      if (heap[child].expiresAt >= last.expiresAt) break;
+      heap[i] = heap[child];
+      i = child;
+    }
+    heap[i] = last;
+    return top;
+  }
+}
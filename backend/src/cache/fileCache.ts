@@ -3,6 +3,10 @@
  * 
  * Stores cache entries as JSON files in the cache directory.
  * Automatically expires entries based on TTL.
+ *
+ * Expiry times are also kept in an index (see expiryIndex.ts) updated on
+ * set/delete, so clean() unlinks the expired files without reading the
+ * others. A cache directory without an index is scanned once to build it.
  */
 
 import fs from 'fs/promises';
@@ -10,19 +14,27 @@ import path from 'path';
 import crypto from 'crypto';
 import { CacheEntry } from '../types';
 import { logger } from '../utils/logger';
+import { ExpiryIndex } from './expiryIndex';
+
+// Not a .json name, so never listed as an entry
+const INDEX_FILE = 'expiry.idx';
 
 export class FileCache {
   private cacheDir: string;
   private defaultTTL: number; // milliseconds
+  private index: ExpiryIndex;
+  private indexReady: Promise<void> | null = null;
 
   constructor(cacheDir: string = './cache', defaultTTL: number = 3600000) {
     this.cacheDir = cacheDir;
     this.defaultTTL = defaultTTL; // Default 1 hour
+    this.index = new ExpiryIndex(path.join(cacheDir, INDEX_FILE));
   }
 
   async init(): Promise<void> {
     try {
       await fs.mkdir(this.cacheDir, { recursive: true });
+      await this.loadIndex();
       logger.info(`Cache directory initialized: ${this.cacheDir}`);
     } catch (error) {
       logger.error('Failed to initialize cache directory:', error);
@@ -34,9 +46,56 @@ export class FileCache {
     return crypto.createHash('sha256').update(key).digest('hex');
   }
 
+  private getFileName(key: string): string {
+    return `${this.generateKey(key)}.json`;
+  }
+
   private getFilePath(key: string): string {
-    const hashedKey = this.generateKey(key);
-    return path.join(this.cacheDir, `${hashedKey}.json`);
+    return path.join(this.cacheDir, this.getFileName(key));
+  }
+
+  // Entry files only; the directory may also hold other stores
+  private async listEntries(): Promise<string[]> {
+    const files = await fs.readdir(this.cacheDir);
+    return files.filter(file => file.endsWith('.json'));
+  }
+
+  private loadIndex(): Promise<void> {
+    if (!this.indexReady) {
+      this.indexReady = this.index.load().then(async found => {
+        if (!found) await this.rebuildIndex();
+      });
+    }
+    return this.indexReady;
+  }
+
+  /**
+   * Build the index by reading every entry (caches written before it existed)
+   */
+  private async rebuildIndex(): Promise<void> {
+    let files: string[];
+    try {
+      files = await this.listEntries();
+    } catch (error) {
+      if ((error as NodeJS.ErrnoException).code !== 'ENOENT') {
+        logger.warn('Failed to list cache entries for the expiry index:', error);
+      }
+      return;
+    }
+
+    for (const file of files) {
+      try {
+        const data = await fs.readFile(path.join(this.cacheDir, file), 'utf-8');
+        const entry: CacheEntry<unknown> = JSON.parse(data);
+        const expiresAt = entry.timestamp + entry.ttl;
+        if (expiresAt > 0) this.index.seed(file, expiresAt);
+      } catch (error) {
+        logger.warn(`Failed to index cache file ${file}:`, error);
+      }
+    }
+    // One write for the whole index instead of a line per file
+    await this.index.compact(true).catch(() => undefined);
+    logger.info(`Cache expiry index built for ${this.index.size} entries`);
   }
 
   async get<T>(key: string): Promise<T | null> {
@@ -75,6 +134,9 @@ export class FileCache {
     };
 
     try {
+      // Indexed first: an index record for a file never written is harmless
+      await this.loadIndex();
+      await this.index.add(this.getFileName(key), entry.timestamp + entry.ttl).catch(() => undefined);
       await fs.writeFile(filePath, JSON.stringify(entry), 'utf-8');
       logger.debug(`Cache set for key: ${key}`);
     } catch (error) {
@@ -92,16 +154,22 @@ export class FileCache {
     } catch (error) {
       if ((error as NodeJS.ErrnoException).code !== 'ENOENT') {
         logger.error('Error deleting cache:', error);
+        return;
       }
     }
+
+    await this.loadIndex();
+    await this.index.remove(this.getFileName(key)).catch(() => undefined);
   }
 
   async purge(): Promise<void> {
     try {
-      const files = await fs.readdir(this.cacheDir);
+      const files = await this.listEntries();
       await Promise.all(
         files.map(file => fs.unlink(path.join(this.cacheDir, file)))
       );
+      await this.loadIndex();
+      await this.index.reset();
       logger.info('Cache purged successfully');
     } catch (error) {
       logger.error('Error purging cache:', error);
@@ -111,23 +179,28 @@ export class FileCache {
 
   async clean(): Promise<void> {
     try {
-      const files = await fs.readdir(this.cacheDir);
-      const now = Date.now();
+      await this.loadIndex();
+      const expired = this.index.takeExpired(Date.now());
 
-      for (const file of files) {
-        const filePath = path.join(this.cacheDir, file);
+      // Removals are recorded only once the files are gone, so a crash or
+      // failed unlink leaves the entry indexed for the next clean()
+      const removed: typeof expired = [];
+      for (const entry of expired) {
         try {
-          const data = await fs.readFile(filePath, 'utf-8');
-          const entry: CacheEntry<unknown> = JSON.parse(data);
-
-          if (now - entry.timestamp > entry.ttl) {
-            await fs.unlink(filePath);
-            logger.debug(`Cleaned expired cache file: ${file}`);
-          }
+          await fs.unlink(path.join(this.cacheDir, entry.name));
+          logger.debug(`Cleaned expired cache file: ${entry.name}`);
         } catch (error) {
-          logger.warn(`Failed to clean cache file ${file}:`, error);
+          if ((error as NodeJS.ErrnoException).code !== 'ENOENT') {
+            logger.warn(`Failed to clean cache file ${entry.name}:`, error);
+            this.index.retry(entry);
+            continue;
+          }
         }
+        removed.push(entry);
       }
+
+      await this.index.removeExpired(removed);
+      await this.index.compact();
     } catch (error) {
       logger.error('Error cleaning cache:', error);
     }
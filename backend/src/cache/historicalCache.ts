@@ -0,0 +1,92 @@
+/**
+ * Tiered lookup for historical OHLCV data
+ *
+ * 1. Memory: decoded columns for hot symbols (no I/O at all)
+ * 2. Column store: complete days, mapped from disk without parsing; only
+ *    the edges of a range it partly covers are fetched
+ * 3. File cache: JSON columns for ranges the column store cannot hold
+ * 4. Data provider
+ *
+ * A miss fills the tiers above the one that answered. Concurrent misses
+ * for the same key share one lookup, so a burst of requests after expiry
+ * makes one provider call and one decode.
+ */
+
+import { cache } from './fileCache';
+import { historicalStore, RangeFetch } from './columnStore';
+import { historicalMemory } from './memoryCache';
+import { OHLCVColumns } from '../types';
+import { deserializeColumns, serializeColumns, SerializedColumns } from '../utils/ohlcv';
+import { logger } from '../utils/logger';
+
+// Lifetime of cached historical data
+export const HISTORICAL_TTL_MS = 3600000;
+
+export interface HistoricalColumns {
+  columns: OHLCVColumns;
+  cached: boolean;  // false if the provider was called
+}
+
+// Lookups past the memory tier, by cache key
+const inFlight = new Map<string, Promise<HistoricalColumns>>();
+
+export function getHistoricalColumns(
+  symbol: string,
+  startDate: string,
+  endDate: string,
+  fetch: RangeFetch
+): Promise<HistoricalColumns> {
+  const cacheKey = `historical:${symbol}:${startDate}:${endDate}`;
+  const remembered = historicalMemory.get(cacheKey);
+  if (remembered) {
+    return Promise.resolve({ columns: remembered, cached: true });
+  }
+
+  const pending = inFlight.get(cacheKey);
+  if (pending) {
+    logger.debug(`Joining in-flight lookup for ${cacheKey}`);
+    return pending;
+  }
+
+  const lookup = loadColumns(cacheKey, symbol, startDate, endDate, fetch).finally(() => {
+    inFlight.delete(cacheKey);
+  });
+  inFlight.set(cacheKey, lookup);
+  return lookup;
+}
+
+async function loadColumns(
+  cacheKey: string,
+  symbol: string,
+  startDate: string,
+  endDate: string,
+  fetch: RangeFetch
+): Promise<HistoricalColumns> {
+  const fetchRange: RangeFetch = (start, end) => {
+    logger.info(`Fetching historical data for ${symbol} from ${start} to ${end}`);
+    return fetch(start, end);
+  };
+
+  let columns: OHLCVColumns;
+  let cached = true;
+  const stored = await historicalStore.load(symbol, startDate, endDate, fetchRange);
+  if (stored) {
+    columns = stored.columns;
+    cached = !stored.fetched;
+  } else {
+    // Ranges the column store cannot hold are cached as JSON; entries in
+    // any other shape (older row-wise entries) count as misses
+    const decoded = deserializeColumns(await cache.get<SerializedColumns>(cacheKey));
+    if (decoded) {
+      logger.debug(`Using cached data for ${symbol}`);
+      columns = decoded;
+    } else {
+      columns = await fetchRange(startDate, endDate);
+      cached = false;
+      await cache.set(cacheKey, serializeColumns(columns), HISTORICAL_TTL_MS);
+    }
+  }
+
+  historicalMemory.set(cacheKey, columns, HISTORICAL_TTL_MS);
+  return { columns, cached };
+}
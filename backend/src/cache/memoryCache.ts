@@ -0,0 +1,134 @@
+/**
+ * In-process LRU cache with a byte budget and TTL
+ *
+ * Holds decoded values (typed arrays) so a hit costs a Map lookup: no file
+ * read, no JSON.parse and no typed array conversion. Expiry is checked on
+ * access, without I/O. Least recently used entries are evicted once the
+ * sizes of the held values exceed the budget.
+ */
+
+import { OHLCVColumns } from '../types';
+
+export interface MemoryCacheStats {
+  entries: number;
+  byteLength: number;
+  budget: number;
+  hits: number;
+  misses: number;
+  evictions: number;
+}
+
+interface MemoryEntry<T> {
+  value: T;
+  byteLength: number;
+  expiresAt: number;
+}
+
+export class MemoryCache<T> {
+  // Map iteration order is insertion order: least recently used first
+  private entries = new Map<string, MemoryEntry<T>>();
+  private sizeOf: (value: T) => number;
+  private budget: number; // bytes
+  private defaultTTL: number; // milliseconds
+  private byteLength = 0;
+  private hits = 0;
+  private misses = 0;
+  private evictions = 0;
+
+  constructor(sizeOf: (value: T) => number, budget: number, defaultTTL: number = 3600000) {
+    this.sizeOf = sizeOf;
+    this.budget = budget;
+    this.defaultTTL = defaultTTL; // Default 1 hour
+  }
+
+  get(key: string): T | null {
+    const entry = this.entries.get(key);
+    if (!entry || entry.expiresAt <= Date.now()) {
+      if (entry) this.remove(key, entry);
+      this.misses++;
+      return null;
+    }
+
+    // Move to the most recently used end
+    this.entries.delete(key);
+    this.entries.set(key, entry);
+    this.hits++;
+    return entry.value;
+  }
+
+  set(key: string, value: T, ttl?: number): void {
+    const previous = this.entries.get(key);
+    if (previous) this.remove(key, previous);
+
+    const byteLength = this.sizeOf(value);
+    if (byteLength > this.budget) return;  // Would evict everything else
+
+    this.entries.set(key, { value, byteLength, expiresAt: Date.now() + (ttl || this.defaultTTL) });
+    this.byteLength += byteLength;
+    this.evict();
+  }
+
+  delete(key: string): void {
+    const entry = this.entries.get(key);
+    if (entry) this.remove(key, entry);
+  }
+
+  clear(): void {
+    this.entries.clear();
+    this.byteLength = 0;
+  }
+
+  /**
+   * Change the byte budget, evicting immediately if over it
+   */
+  setBudget(bytes: number): void {
+    this.budget = bytes;
+    this.evict();
+  }
+
+  stats(): MemoryCacheStats {
+    return {
+      entries: this.entries.size,
+      byteLength: this.byteLength,
+      budget: this.budget,
+      hits: this.hits,
+      misses: this.misses,
+      evictions: this.evictions,
+    };
+  }
+
+  private remove(key: string, entry: MemoryEntry<T>): void {
+    this.entries.delete(key);
+    this.byteLength -= entry.byteLength;
+  }
+
+  private evict(): void {
+    for (const [key, entry] of this.entries) {
+      if (this.byteLength <= this.budget) break;
+      this.remove(key, entry);
+      this.evictions++;
+    }
+  }
+}
+
+/**
+ * Bytes held by a set of columns
+ */
+export function columnsByteLength(columns: Partial<OHLCVColumns>): number {
+  let bytes = 0;
+  for (const column of Object.values(columns)) {
+    bytes += column ? column.byteLength : 0;
+  }
+  return bytes;
+}
+
+// MEMORY_CACHE_MB, default 256 (about 4000 symbols of 5 years' daily data)
+function defaultBudget(): number {
+  const mb = parseInt(process.env.MEMORY_CACHE_MB || '', 10);
+  return (Number.isNaN(mb) || mb < 0 ? 256 : mb) * 1048576;
+}
+
+/**
+ * Decoded historical columns, keyed like the file cache
+ */
+export const historicalMemory = new MemoryCache<OHLCVColumns>(columnsByteLength, defaultBudget());
@@ -0,0 +1,108 @@
+/**
+ * Binary price bodies for analysis routes
+ *
+ * Accepts `Content-Type: application/octet-stream` bodies holding raw
+ * little-endian Float64 prices, or Float32 prices with `?dtype=float32`.
+ * The buffer is viewed as a typed array in place (no JSON parse, no
+ * per-element validation) and checked with the native finite scan. Float32
+ * bodies go straight to the float32 kernels. Other parameters (ql, qr,
+ * windowSize) come from the query string and are merged into req.body so
+ * the existing validators and handlers apply unchanged.
+ */
+
+import express, { Request, Response, NextFunction, RequestHandler } from 'express';
+import os from 'os';
+import { findInvalidPrice } from '../nativeBridge';
+import { PriceArray } from '../types';
+import { MAX_REQUEST_PRICES } from './validation';
+
+const IS_LITTLE_ENDIAN = os.endianness() === 'LE';
+
+// Element types selectable with ?dtype=
+const PRICE_TYPES = {
+  float64: Float64Array,
+  float32: Float32Array,
+} as const;
+
+export type PriceDtype = keyof typeof PRICE_TYPES;
+
+function badRequest(res: Response, message: string): void {
+  res.status(400).json({
+    error: 'Bad Request',
+    message,
+    timestamp: new Date().toISOString(),
+  });
+}
+
+/**
+ * View a little-endian Float64/Float32 buffer as a typed array
+ *
+ * Zero-copy when the buffer is element-aligned on a little-endian host;
+ * otherwise the bytes are copied (and swapped on big-endian hosts).
+ */
+export function toPriceArray(buf: Buffer, dtype: PriceDtype = 'float64'): PriceArray {
+  const bytesPerPrice = PRICE_TYPES[dtype].BYTES_PER_ELEMENT;
+  const view = (source: Buffer): PriceArray => {
+    const count = source.byteLength / bytesPerPrice;
+    return dtype === 'float32'
+      ? new Float32Array(source.buffer, source.byteOffset, count)
+      : new Float64Array(source.buffer, source.byteOffset, count);
+  };
+
+  if (IS_LITTLE_ENDIAN && buf.byteOffset % bytesPerPrice === 0) {
+    return view(buf);
+  }
+
+  const copy = Buffer.from(buf);
+  if (!IS_LITTLE_ENDIAN) {
+    if (bytesPerPrice === 8) copy.swap64();
+    else copy.swap32();
+  }
+  return view(copy);
+}
+
+const toPricesBody: RequestHandler = (req: Request, res: Response, next: NextFunction) => {
+  if (!Buffer.isBuffer(req.body)) {
+    next();
+    return;
+  }
+
+  const dtype = (req.query.dtype ?? 'float64') as string;
+  if (!Object.prototype.hasOwnProperty.call(PRICE_TYPES, dtype)) {
+    badRequest(res, 'dtype must be float64 or float32');
+    return;
+  }
+
+  const buf = req.body as Buffer;
+  const bytesPerPrice = PRICE_TYPES[dtype as PriceDtype].BYTES_PER_ELEMENT;
+  if (buf.byteLength === 0 || buf.byteLength % bytesPerPrice !== 0) {
+    badRequest(res, `Binary body must be a non-empty sequence of little-endian ${dtype} values`);
+    return;
+  }
+  // Same cap as a JSON prices array
+  if (buf.byteLength / bytesPerPrice > MAX_REQUEST_PRICES) {
+    badRequest(res, `Binary body exceeds ${MAX_REQUEST_PRICES} prices`);
+    return;
+  }
+
+  const prices = toPriceArray(buf, dtype as PriceDtype);
+  const badIndex = findInvalidPrice(prices);
+  if (badIndex >= 0) {
+    badRequest(res, `Invalid price at index ${badIndex} (NaN or infinite)`);
+    return;
+  }
+
+  req.body = { ...req.query, prices };
+  next();
+};
+
+/**
+ * Router middleware: parse octet-stream bodies into { ...query, prices }
+ */
+export const binaryPricesBody: RequestHandler[] = [
+  express.raw({
+    type: 'application/octet-stream',
+    limit: MAX_REQUEST_PRICES * Float64Array.BYTES_PER_ELEMENT,
+  }),
+  toPricesBody,
+];
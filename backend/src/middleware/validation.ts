@@ -95,13 +95,22 @@ export const windowSizeValidation: ValidationChain = body('windowSize')
   .isInt({ min: 1, max: 1000 })
   .withMessage('windowSize must be between 1 and 1000');
 
+/**
+ * Most prices one request may carry, as a JSON array or a binary body
+ */
+export const MAX_REQUEST_PRICES = 100_000;
+
 /**
  * Validate prices array (if provided directly)
+ * 
+ * Binary bodies arrive as an already-validated Float64Array/Float32Array
+ * (see binaryPrices.ts) and skip the per-element checks.
  */
 export const pricesArrayValidation: ValidationChain = body('prices')
   .optional()
-  .isArray({ min: 1, max: 100000 })
-  .withMessage('prices must be an array with 1 to 100,000 elements')
+  .if((prices: unknown) => !ArrayBuffer.isView(prices))
+  .isArray({ min: 1, max: MAX_REQUEST_PRICES })
+  .withMessage(`prices must be an array with 1 to ${MAX_REQUEST_PRICES.toLocaleString('en-US')} elements`)
   .custom((prices: number[]) => {
     if (!prices.every(p => typeof p === 'number' && !isNaN(p) && isFinite(p))) {
       throw new Error('All prices must be valid numbers');
@@ -16,10 +16,48 @@ try {
   mod = require('../native/src/wrapper');
 }
 
+// Worker pool module, resolved the same way
+let poolMod: any;
+try {
+  // eslint-disable-next-line @typescript-eslint/no-var-requires
+  poolMod = require('../native/dist/workerPool');
+} catch (_err) {
+  // eslint-disable-next-line @typescript-eslint/no-var-requires
+  poolMod = require('../native/src/workerPool');
+}
+
 export const {
   calculateStockSpan,
   withSegmentTree,
   querySegmentTree,
   withSlidingWindow,
   getWindowResult,
-} = mod;
\ No newline at end of file
+  serializeWindowResult,
+  iterateWindowChunks,
+  analyzeSlidingWindow,
+  freeWindowResult,
+  analyzeSeries,
+  findInvalidPrice,
+  getNativeDiagnostics,
+  getNativeStats,
+  registerSeries,
+  releaseSeries,
+  getSeriesInfo,
+  querySeriesRange,
+  openColumnStore,
+  parseChartColumns,
+  analyzeBatch,
+  WINDOW_PATTERNS,
+} = mod;
+
+export const { getWorkerPool, closeWorkerPool } = poolMod;
+
+/**
+ * The worker pool that runs heavy analyses off the main thread, or null
+ * when DSA_WORKER_THREADS=0 keeps them on it or its workers cannot start
+ */
+export function getAnalysisPool(): any | null {
+  if (process.env.DSA_WORKER_THREADS?.trim() === '0') return null;
+  const pool = getWorkerPool();
+  return pool.failed ? null : pool;
+}
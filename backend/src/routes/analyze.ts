@@ -12,15 +12,22 @@ import {
   pricesArrayValidation,
   handleValidationErrors,
 } from '../middleware/validation';
-import { body } from 'express-validator';
+import { binaryPricesBody } from '../middleware/binaryPrices';
+import { body, query } from 'express-validator';
 import { logger } from '../utils/logger';
+import { pipeline } from 'stream/promises';
 
 const router = Router();
 
+// application/octet-stream: raw little-endian Float64 prices, other
+// parameters in the query string
+router.use(binaryPricesBody);
+
 /**
  * POST /api/analyze/span
  * Calculate stock span analysis
  * Body: { symbol?, startDate?, endDate?, prices? }
+ *   or octet-stream Float64 prices
  */
 router.post(
   '/span',
@@ -65,6 +72,7 @@ router.post(
  * POST /api/analyze/range
  * Perform range query using segment tree
  * Body: { symbol?, startDate?, endDate?, ql, qr, prices? }
+ *   or octet-stream Float64 prices with ?ql=&qr=
  */
 router.post(
   '/range',
@@ -110,7 +118,15 @@ router.post(
 /**
  * POST /api/analyze/window
  * Perform sliding window analysis
- * Body: { symbol?, startDate?, endDate?, windowSize, prices? }
+ * Body: { symbol?, startDate?, endDate?, windowSize, prices?, format? }
+ *   or octet-stream Float64 prices with ?windowSize=
+ * 
+ * Windows are serialized natively and sent as-is. format=ndjson (body or
+ * query) returns only the windows, one JSON object per line.
+ * 
+ * stream=true (body or query) streams just the windows (JSON array or
+ * NDJSON) chunk by chunk with backpressure; the window count and size are
+ * sent as X-Window-Count / X-Window-Size headers.
  */
 router.post(
   '/window',
@@ -120,10 +136,16 @@ router.post(
   dateRangeValidation('body'),
   windowSizeValidation,
   pricesArrayValidation,
+  body('format').optional().isIn(['json', 'ndjson']).withMessage("format must be 'json' or 'ndjson'"),
+  query('format').optional().isIn(['json', 'ndjson']).withMessage("format must be 'json' or 'ndjson'"),
+  body('stream').optional().isBoolean().withMessage('stream must be a boolean'),
+  query('stream').optional().isBoolean().withMessage('stream must be a boolean'),
   handleValidationErrors,
   async (req: Request, res: Response) => {
     try {
       const { symbol, startDate, endDate, windowSize, prices } = req.body;
+      const format = (req.body.format ?? req.query.format ?? 'json') as 'json' | 'ndjson';
+      const stream = String(req.body.stream ?? req.query.stream) === 'true';
 
       if (!prices && (!symbol || !startDate || !endDate)) {
         res.status(400).json({
@@ -134,17 +156,56 @@ router.post(
         return;
       }
 
-      logger.info('Window analysis request:', { symbol, windowSize });
+      logger.info('Window analysis request:', { symbol, windowSize, format, stream });
+
+      if (stream) {
+        const result = await analysisService.streamWindows(
+          symbol,
+          startDate,
+          endDate,
+          parseInt(windowSize),
+          prices,
+          format
+        );
+
+        res.type(format === 'ndjson' ? 'application/x-ndjson' : 'application/json');
+        res.setHeader('X-Window-Count', String(result.windowCount));
+        res.setHeader('X-Window-Size', String(result.windowSize));
+
+        try {
+          await pipeline(result.stream, res);
+        } catch (error) {
+          // Client went away mid-stream; the native result is already freed
+          logger.warn('Window stream aborted:', (error as Error).message);
+        }
+        return;
+      }
 
-      const result = await analysisService.analyzeWindow(
+      const result = await analysisService.analyzeWindowEncoded(
         symbol,
         startDate,
         endDate,
         parseInt(windowSize),
-        prices
+        prices,
+        format
       );
 
-      res.json(result);
+      if (format === 'ndjson') {
+        res.type('application/x-ndjson').send(result.windows);
+        return;
+      }
+
+      // Same shape as res.json(WindowAnalysisResponse), with the native
+      // windows buffer spliced in instead of re-stringified
+      const head = JSON.stringify({
+        symbol: result.symbol,
+        windowSize: result.windowSize,
+        processingTimeMs: result.processingTimeMs,
+      });
+      res.type('application/json');
+      res.write(head.slice(0, -1) + ',"windows":');
+      res.write(result.windows);
+      res.end('}');
     } catch (error) {
       logger.error('Window analysis error:', error);
       throw error;
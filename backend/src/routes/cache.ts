@@ -4,6 +4,8 @@
 
 import { Router, Request, Response } from 'express';
 import { cache } from '../cache/fileCache';
+import { historicalStore } from '../cache/columnStore';
+import { historicalMemory } from '../cache/memoryCache';
 import { logger } from '../utils/logger';
 
 const router = Router();
@@ -14,7 +16,9 @@ const router = Router();
  */
 router.post('/purge', async (_req: Request, res: Response) => {
   try {
+    historicalMemory.clear();
     await cache.purge();
+    await historicalStore.purge();
     logger.info('Cache purged successfully');
     res.json({
       message: 'Cache purged successfully',
@@ -44,4 +48,15 @@ router.post('/clean', async (_req: Request, res: Response) => {
   }
 });
 
+/**
+ * GET /api/cache/stats
+ * In-memory tier occupancy and hit/miss counters
+ */
+router.get('/stats', (_req: Request, res: Response) => {
+  res.json({
+    memory: historicalMemory.stats(),
+    timestamp: new Date().toISOString(),
+  });
+});
+
 export default router;
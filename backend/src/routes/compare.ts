@@ -11,6 +11,8 @@ import {
 } from '../middleware/validation';
 import { analysisService } from '../services/analysisService';
 import { createDataProvider } from '../services/dataProvider';
+import { getHistoricalColumns } from '../cache/historicalCache';
+import { fromEpochDay } from '../utils/ohlcv';
 import { logger } from '../utils/logger';
 
 const router = Router();
@@ -37,20 +39,24 @@ router.post(
       const results = await Promise.all(
         symbols.map(async (symbol: string) => {
           try {
-            const data = await dataProvider.fetchHistoricalData(
-              symbol,
-              startDate,
-              endDate
+            const { columns } = await getHistoricalColumns(symbol, startDate, endDate, (start, end) =>
+              dataProvider.fetchHistoricalData(symbol, start, end)
             );
 
+            // Rows only for the response, straight from the columns
+            const data: { date: string; close: number; volume: number }[] = new Array(columns.date.length);
+            for (let i = 0; i < data.length; i++) {
+              data[i] = {
+                date: fromEpochDay(columns.date[i]),
+                close: columns.close[i],
+                volume: columns.volume[i],
+              };
+            }
+
             return {
               symbol,
               success: true,
-              data: data.map(d => ({
-                date: d.date,
-                close: d.close,
-                volume: d.volume,
-              })),
+              data,
             };
           } catch (error) {
             logger.error(`Error fetching data for ${symbol}:`, error);
@@ -0,0 +1,28 @@
+/**
+ * Prometheus metrics route
+ */
+
+import { Router, Request, Response } from 'express';
+import { getNativeStats } from '../nativeBridge';
+import { formatNativeMetrics, NativeStatsSnapshot } from '../utils/metrics';
+
+const router = Router();
+
+/**
+ * GET /metrics
+ * Native call counters and latency histograms in Prometheus text format.
+ * Counters stay at zero unless collection is enabled with DSA_STATS=1.
+ */
+router.get('/', (_req: Request, res: Response) => {
+  let stats: NativeStatsSnapshot | null;
+  try {
+    stats = getNativeStats();
+  } catch {
+    // Native module not compiled
+    stats = null;
+  }
+
+  res.type('text/plain; version=0.0.4').send(formatNativeMetrics(stats));
+});
+
+export default router;
@@ -271,19 +271,31 @@ router.post(
   dateRangeValidation('body'),
   handleValidationErrors,
   async (req: Request, res: Response) => {
+    const controller = new AbortController();
     try {
       const { id } = req.params;
       const { startDate, endDate } = req.body;
 
       logger.info(`Starting batch analysis for portfolio ${id}`);
 
-      const result = await portfolioService.batchAnalyze(id, startDate, endDate);
+      // Stop working for a client that has gone away
+      res.on('close', () => {
+        if (!res.writableFinished) controller.abort();
+      });
+
+      const result = await portfolioService.batchAnalyze(id, startDate, endDate, undefined, {
+        signal: controller.signal,
+      });
 
       res.json({
         portfolioId: id,
         ...result,
       });
     } catch (error) {
+      if (controller.signal.aborted) {
+        logger.info(`Batch analysis for portfolio ${req.params.id} cancelled`);
+        return;
+      }
       logger.error('Error in batch analysis:', error);
       throw error;
     }
@@ -4,7 +4,7 @@
 
 import { Router, Request, Response } from 'express';
 import { createDataProvider } from '../services/dataProvider';
-import { cache } from '../cache/fileCache';
+import { getHistoricalColumns } from '../cache/historicalCache';
 import {
   symbolValidation,
   dateValidation,
@@ -12,6 +12,7 @@ import {
   handleValidationErrors,
 } from '../middleware/validation';
 import { HistoricalDataResponse } from '../types';
+import { toRows } from '../utils/ohlcv';
 import { logger } from '../utils/logger';
 
 const router = Router();
@@ -33,28 +34,20 @@ router.get(
       const { symbol } = req.params;
       const { startDate, endDate } = req.query as { startDate: string; endDate: string };
 
-      const cacheKey = `historical:${symbol}:${startDate}:${endDate}`;
-      const cached = await cache.get<HistoricalDataResponse>(cacheKey);
-
+      const { columns, cached } = await getHistoricalColumns(symbol, startDate, endDate, (start, end) =>
+        dataProvider.fetchHistoricalData(symbol, start, end)
+      );
       if (cached) {
         logger.info(`Cache hit for ${symbol} historical data`);
-        res.json({ ...cached, cached: true });
-        return;
       }
 
-      logger.info(`Fetching historical data for ${symbol}`);
-      const data = await dataProvider.fetchHistoricalData(symbol, startDate, endDate);
-
       const response: HistoricalDataResponse = {
         symbol,
-        data,
+        data: toRows(columns),
         source: process.env.DATA_PROVIDER || 'yahoo',
-        cached: false,
+        cached,
       };
 
-      // Cache for 1 hour
-      await cache.set(cacheKey, response, 3600000);
-
       res.json(response);
     } catch (error) {
       logger.error('Historical data fetch error:', error);
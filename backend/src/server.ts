@@ -18,7 +18,9 @@ import analyzeRoutes from './routes/analyze';
 import portfolioRoutes from './routes/portfolio';
 import cacheRoutes from './routes/cache';
 import compareRoutes from './routes/compare';
+import metricsRoutes from './routes/metrics';
 import { portfolioService } from './services/portfolioService';
+import { getNativeDiagnostics } from './nativeBridge';
 
 const app: Application = express();
 const PORT = process.env.PORT || 3001;
@@ -62,6 +64,9 @@ app.get('/health', (_req, res) => {
   });
 });
 
+// Prometheus scrape endpoint (outside the /api rate limit)
+app.use('/metrics', metricsRoutes);
+
 // API routes
 app.use('/api/stocks', stocksRoutes);
 app.use('/api/analyze', analyzeRoutes);
@@ -97,8 +102,8 @@ async function startServer() {
 
     // Check native module availability
     try {
-      require('./native/dist/wrapper');
-      logger.info('Native analysis module loaded successfully');
+      const { isa } = getNativeDiagnostics();
+      logger.info(`Native analysis module loaded successfully (kernels: ${isa})`);
     } catch (error) {
       logger.warn('Native module not available. Compile with: cd native && npm run build');
     }
@@ -8,51 +8,204 @@ import {
   querySegmentTree,
   withSlidingWindow,
   getWindowResult,
+  serializeWindowResult,
+  iterateWindowChunks,
+  analyzeSlidingWindow,
+  freeWindowResult,
+  registerSeries,
+  releaseSeries,
+  getSeriesInfo,
+  querySeriesRange,
+  getAnalysisPool,
 } from '../nativeBridge';
+import { Readable } from 'stream';
 import { createDataProvider, DataProviderError } from './dataProvider';
-import { cache } from '../cache/fileCache';
+import { getHistoricalColumns, HISTORICAL_TTL_MS } from '../cache/historicalCache';
 import {
-  OHLCVData,
   SpanAnalysisResponse,
   RangeAnalysisResponse,
   WindowAnalysisResponse,
   WindowStats,
+  EncodedWindowAnalysis,
+  WindowAnalysisStream,
+  PriceArray,
+  PriceSource,
 } from '../types';
 import { logger } from '../utils/logger';
 
+// Windows encoded per streamed chunk (~0.6 MB of JSON)
+const STREAM_CHUNK_WINDOWS = 8192;
+
+// How often expired series are freed when no analysis starts or ends
+const SERIES_SWEEP_MS = 60000;
+
+// SERIES_CACHE_MB, default 64: native copies of closes analyzed by id
+function defaultSeriesBudget(): number {
+  const mb = parseInt(process.env.SERIES_CACHE_MB || '', 10);
+  return (Number.isNaN(mb) || mb < 0 ? 64 : mb) * 1048576;
+}
+
+// A symbol's closes held natively, analyzed by id
+interface RegisteredSeries {
+  id: number;
+  length: number;
+  byteLength: number;
+  expiresAt: number;
+  users: number;  // analyses running on the series; it stays registered
+}
+
+// Analysis input and its length (series ids carry no length)
+interface ResolvedPrices {
+  prices: PriceSource;
+  length: number;
+}
+
 export class AnalysisService {
   private dataProvider = createDataProvider();
+  // Map iteration order is insertion order: least recently used first
+  private series = new Map<string, RegisteredSeries>();
+  private seriesBytes = 0;
+  private seriesBudget: number; // bytes
+
+  constructor(seriesBudget: number = defaultSeriesBudget()) {
+    this.seriesBudget = seriesBudget;
+    setInterval(() => this.releaseExpiredSeries(Date.now()), SERIES_SWEEP_MS).unref();
+  }
+
+  /**
+   * Close prices for a symbol, from the first cache tier that holds them
+   */
+  private async getClosePrices(
+    symbol: string,
+    startDate: string,
+    endDate: string
+  ): Promise<Float64Array> {
+    const { columns } = await getHistoricalColumns(symbol, startDate, endDate, (start, end) =>
+      this.dataProvider.fetchHistoricalData(symbol, start, end)
+    );
+    return columns.close;
+  }
+
+  /**
+   * Directly supplied prices as a typed array (binary bodies pass through)
+   */
+  private toPriceArray(directPrices: number[] | PriceArray): PriceArray {
+    return ArrayBuffer.isView(directPrices) ? directPrices : new Float64Array(directPrices);
+  }
 
   /**
-   * Fetch historical data with caching
+   * The symbol's closes as a native series, registered on first use
+   * 
+   * Later requests for the same symbol and dates analyze the registered
+   * series by id: no cache read, JSON decode or typed array upload. The
+   * series is re-registered with fresh data once the cache entry expires.
+   * The caller becomes one of its users and must call releaseUser().
+   * Series not in use are freed, least recently used first, once their
+   * native copies exceed SERIES_CACHE_MB.
    */
-  private async getHistoricalData(
+  private async acquireSeries(
     symbol: string,
     startDate: string,
     endDate: string
-  ): Promise<OHLCVData[]> {
-    const cacheKey = `historical:${symbol}:${startDate}:${endDate}`;
-    const cached = await cache.get<OHLCVData[]>(cacheKey);
+  ): Promise<RegisteredSeries> {
+    this.releaseExpiredSeries(Date.now());
+
+    const key = `historical:${symbol}:${startDate}:${endDate}`;
+    const registered = this.series.get(key);
+    if (registered && registered.expiresAt > Date.now()) {
+      // Move to the most recently used end
+      this.series.delete(key);
+      this.series.set(key, registered);
+      registered.users++;
+      return registered;
+    }
+
+    const closes = await this.getClosePrices(symbol, startDate, endDate);
+    if (closes.length === 0) {
+      throw new DataProviderError('No data available for the specified period');
+    }
 
-    if (cached) {
-      logger.debug(`Using cached data for ${symbol}`);
-      return cached;
+    // Re-registering a key replaces its values under the same id and adds
+    // a reference, so drop the one held for the previous values. The entry
+    // is updated in place: analyses still running on it stay counted.
+    const id: number = registerSeries(key, closes);
+    const byteLength: number = getSeriesInfo(id)?.byteLength ?? closes.byteLength;
+    const expiresAt = Date.now() + HISTORICAL_TTL_MS;
+    let entry = this.series.get(key);
+    if (entry) {
+      releaseSeries(entry.id);
+      this.seriesBytes -= entry.byteLength;
+      this.series.delete(key);
+      Object.assign(entry, { id, length: closes.length, byteLength, expiresAt });
+    } else {
+      entry = { id, length: closes.length, byteLength, expiresAt, users: 0 };
     }
+    this.series.set(key, entry);
+    this.seriesBytes += byteLength;
+    entry.users++;
+    this.evictSeries();
+    return entry;
+  }
+
+  /**
+   * End one analysis on a series acquired with acquireSeries()
+   */
+  private releaseUser(entry: RegisteredSeries): void {
+    entry.users--;
+    this.releaseExpiredSeries(Date.now());
+    this.evictSeries();
+  }
 
-    logger.info(`Fetching historical data for ${symbol} from ${startDate} to ${endDate}`);
-    const data = await this.dataProvider.fetchHistoricalData(symbol, startDate, endDate);
+  /**
+   * Free native series whose data has expired and that no analysis is using
+   */
+  private releaseExpiredSeries(now: number): void {
+    for (const [key, entry] of this.series) {
+      if (entry.expiresAt <= now && entry.users === 0) this.dropSeries(key, entry);
+    }
+  }
 
-    // Cache for 1 hour
-    await cache.set(cacheKey, data, 3600000);
+  /**
+   * Free least recently used series not in use until within the budget
+   */
+  private evictSeries(): void {
+    for (const [key, entry] of this.series) {
+      if (this.seriesBytes <= this.seriesBudget) break;
+      if (entry.users === 0) this.dropSeries(key, entry);
+    }
+  }
 
-    return data;
+  private dropSeries(key: string, entry: RegisteredSeries): void {
+    releaseSeries(entry.id);
+    this.series.delete(key);
+    this.seriesBytes -= entry.byteLength;
   }
 
   /**
-   * Extract close prices from OHLCV data
+   * Run `analyze` on the analysis input: direct prices, else the symbol's
+   * series, which stays registered until `analyze` settles
    */
-  private extractClosePrices(data: OHLCVData[]): Float64Array {
-    return new Float64Array(data.map(d => d.close));
+  private async withPrices<T>(
+    symbol: string | undefined,
+    startDate: string | undefined,
+    endDate: string | undefined,
+    directPrices: number[] | PriceArray | undefined,
+    analyze: (input: ResolvedPrices) => Promise<T>
+  ): Promise<T> {
+    if (directPrices && directPrices.length > 0) {
+      const prices = this.toPriceArray(directPrices);
+      return analyze({ prices, length: prices.length });
+    }
+    if (!(symbol && startDate && endDate)) {
+      throw new Error('Either provide symbol with dates or direct prices array');
+    }
+
+    const entry = await this.acquireSeries(symbol, startDate, endDate);
+    try {
+      return await analyze({ prices: entry.id, length: entry.length });
+    } finally {
+      this.releaseUser(entry);
+    }
   }
 
   /**
@@ -62,28 +215,17 @@ export class AnalysisService {
     symbol: string | undefined,
     startDate: string | undefined,
     endDate: string | undefined,
-    directPrices?: number[]
+    directPrices?: number[] | PriceArray
   ): Promise<SpanAnalysisResponse> {
     const startTime = Date.now();
 
-    let prices: Float64Array;
-
-    if (directPrices && directPrices.length > 0) {
-      // Use directly provided prices
-      prices = new Float64Array(directPrices);
-    } else if (symbol && startDate && endDate) {
-      // Fetch from provider
-      const historicalData = await this.getHistoricalData(symbol, startDate, endDate);
-      if (historicalData.length === 0) {
-        throw new DataProviderError('No data available for the specified period');
+    // In the worker pool when there is one
+    const spansArray: Int32Array = await this.withPrices(
+      symbol, startDate, endDate, directPrices, ({ prices }) => {
+        const pool = getAnalysisPool();
+        return pool ? pool.calculateStockSpan(prices) : calculateStockSpan(prices);
       }
-      prices = this.extractClosePrices(historicalData);
-    } else {
-      throw new Error('Either provide symbol with dates or direct prices array');
-    }
-
-    // Call native function
-    const spansArray = await calculateStockSpan(prices);
+    );
     const spans = Array.from(spansArray);
 
     const processingTimeMs = Date.now() - startTime;
@@ -106,33 +248,30 @@ export class AnalysisService {
     endDate: string | undefined,
     ql: number,
     qr: number,
-    directPrices?: number[]
+    directPrices?: number[] | PriceArray
   ): Promise<RangeAnalysisResponse> {
     const startTime = Date.now();
 
-    let prices: Float64Array;
-
-    if (directPrices && directPrices.length > 0) {
-      prices = new Float64Array(directPrices);
-    } else if (symbol && startDate && endDate) {
-      const historicalData = await this.getHistoricalData(symbol, startDate, endDate);
-      if (historicalData.length === 0) {
-        throw new DataProviderError('No data available for the specified period');
+    const stats = await this.withPrices(
+      symbol, startDate, endDate, directPrices, async ({ prices, length }) => {
+        // Validate range bounds
+        if (ql < 0 || qr >= length || ql > qr) {
+          throw new Error(`Invalid range: ql=${ql}, qr=${qr}, length=${length}`);
+        }
+
+        // Registered series hit the native tree cache; direct prices get a
+        // one-off tree with auto-cleanup, built in the worker pool if any
+        if (typeof prices === 'number') {
+          return querySeriesRange(prices, ql, qr);
+        }
+        const pool = getAnalysisPool();
+        return pool
+          ? pool.queryRange(prices, ql, qr)
+          : withSegmentTree(prices, async (tree) => {
+              return await querySegmentTree(tree, ql, qr);
+            });
       }
-      prices = this.extractClosePrices(historicalData);
-    } else {
-      throw new Error('Either provide symbol with dates or direct prices array');
-    }
-
-    // Validate range bounds
-    if (ql < 0 || qr >= prices.length || ql > qr) {
-      throw new Error(`Invalid range: ql=${ql}, qr=${qr}, length=${prices.length}`);
-    }
-
-    // Use segment tree with auto-cleanup
-    const stats = await withSegmentTree(prices, async (tree) => {
-      return await querySegmentTree(tree, ql, qr);
-    });
+    );
 
     const processingTimeMs = Date.now() - startTime;
 
@@ -154,57 +293,143 @@ export class AnalysisService {
     startDate: string | undefined,
     endDate: string | undefined,
     windowSize: number,
-    directPrices?: number[]
+    directPrices?: number[] | PriceArray
   ): Promise<WindowAnalysisResponse> {
     const startTime = Date.now();
 
-    let prices: Float64Array;
-
-    if (directPrices && directPrices.length > 0) {
-      prices = new Float64Array(directPrices);
-    } else if (symbol && startDate && endDate) {
-      const historicalData = await this.getHistoricalData(symbol, startDate, endDate);
-      if (historicalData.length === 0) {
-        throw new DataProviderError('No data available for the specified period');
+    const windows = await this.withPrices(
+      symbol, startDate, endDate, directPrices, async ({ prices, length }) => {
+        // Validate window size
+        if (windowSize <= 0 || windowSize > length) {
+          throw new Error(
+            `Invalid window size: ${windowSize} (must be 1 to ${length})`
+          );
+        }
+
+        const numWindows = length - windowSize + 1;
+        const results: WindowStats[] = [];
+
+        // Use sliding window with auto-cleanup
+        await withSlidingWindow(prices, windowSize, async (handle) => {
+          for (let i = 0; i < numWindows; i++) {
+            const result = await getWindowResult(handle, i);
+            results.push({
+              index: i,
+              ...result,
+            });
+          }
+        });
+        return results;
       }
-      prices = this.extractClosePrices(historicalData);
-    } else {
-      throw new Error('Either provide symbol with dates or direct prices array');
-    }
+    );
 
-    // Validate window size
-    if (windowSize <= 0 || windowSize > prices.length) {
-      throw new Error(
-        `Invalid window size: ${windowSize} (must be 1 to ${prices.length})`
-      );
-    }
+    const processingTimeMs = Date.now() - startTime;
 
-    const numWindows = prices.length - windowSize + 1;
-    const windows: WindowStats[] = [];
+    logger.info(`Window analysis completed in ${processingTimeMs}ms`);
 
-    // Use sliding window with auto-cleanup
-    await withSlidingWindow(prices, windowSize, async (handle) => {
-      for (let i = 0; i < numWindows; i++) {
-        const result = await getWindowResult(handle, i);
-        windows.push({
-          index: i,
-          ...result,
-        });
+    return {
+      symbol,
+      windowSize,
+      windows,
+      processingTimeMs,
+    };
+  }
+
+  /**
+   * Perform sliding window analysis, returning the windows pre-serialized
+   * 
+   * Same windows as analyzeWindow, but encoded natively as a JSON array or
+   * NDJSON Buffer so no per-window JS objects are created. The route sends
+   * the Buffer as-is. Analysis and encoding run in the worker pool when
+   * there is one.
+   */
+  async analyzeWindowEncoded(
+    symbol: string | undefined,
+    startDate: string | undefined,
+    endDate: string | undefined,
+    windowSize: number,
+    directPrices?: number[] | PriceArray,
+    format: 'json' | 'ndjson' = 'json'
+  ): Promise<EncodedWindowAnalysis> {
+    const startTime = Date.now();
+
+    const windows: Buffer = await this.withPrices(
+      symbol, startDate, endDate, directPrices, async ({ prices, length }) => {
+        if (windowSize <= 0 || windowSize > length) {
+          throw new Error(
+            `Invalid window size: ${windowSize} (must be 1 to ${length})`
+          );
+        }
+
+        const pool = getAnalysisPool();
+        return pool
+          ? pool.serializeWindows(prices, windowSize, format)
+          : withSlidingWindow(prices, windowSize, (handle) =>
+              serializeWindowResult(handle, format)
+            );
       }
-    });
+    );
 
     const processingTimeMs = Date.now() - startTime;
 
-    logger.info(`Window analysis completed in ${processingTimeMs}ms`);
+    logger.info(`Window analysis (${format}) completed in ${processingTimeMs}ms`);
 
     return {
       symbol,
       windowSize,
+      format,
       windows,
       processingTimeMs,
     };
   }
 
+  /**
+   * Perform sliding window analysis as a stream of encoded chunks
+   * 
+   * The windows are computed up front, but encoded one chunk at a time as
+   * the returned stream is read, so the response never holds more than a
+   * chunk of text. The native result is freed when the stream ends or is
+   * destroyed.
+   */
+  async streamWindows(
+    symbol: string | undefined,
+    startDate: string | undefined,
+    endDate: string | undefined,
+    windowSize: number,
+    directPrices?: number[] | PriceArray,
+    format: 'json' | 'ndjson' = 'json'
+  ): Promise<WindowAnalysisStream> {
+    // The windows are computed before a registered series is let go
+    const handle = await this.withPrices(
+      symbol, startDate, endDate, directPrices, async ({ prices, length }) => {
+        if (windowSize <= 0 || windowSize > length) {
+          throw new Error(
+            `Invalid window size: ${windowSize} (must be 1 to ${length})`
+          );
+        }
+
+        return analyzeSlidingWindow(prices, windowSize);
+      }
+    );
+    const windowCount = handle.count;
+
+    async function* chunks(): AsyncGenerator<Buffer> {
+      try {
+        yield* iterateWindowChunks(handle, format, STREAM_CHUNK_WINDOWS);
+      } finally {
+        await freeWindowResult(handle);
+      }
+    }
+
+    return {
+      symbol,
+      windowSize,
+      format,
+      windowCount,
+      stream: Readable.from(chunks(), { objectMode: false }),
+    };
+  }
+
   /**
    * Search for stock symbols
    */
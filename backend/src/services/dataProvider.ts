@@ -4,8 +4,10 @@
  */
 
 import axios, { AxiosInstance } from 'axios';
-import { OHLCVData, DataProviderConfig } from '../types';
+import { OHLCVColumns, DataProviderConfig } from '../types';
+import { allocateColumns, rowsThrough, sliceColumns, toEpochDay } from '../utils/ohlcv';
 import { logger } from '../utils/logger';
+import { parseChartColumns } from '../nativeBridge';
 
 export class DataProviderError extends Error {
   constructor(message: string, public code?: string) {
@@ -27,11 +29,14 @@ export abstract class DataProvider {
     });
   }
 
+  /**
+   * Daily OHLCV columns for an inclusive YYYY-MM-DD range, oldest first
+   */
   abstract fetchHistoricalData(
     symbol: string,
     startDate: string,
     endDate: string
-  ): Promise<OHLCVData[]>;
+  ): Promise<OHLCVColumns>;
 
   abstract searchSymbol(query: string): Promise<string[]>;
 }
@@ -40,6 +45,8 @@ export abstract class DataProvider {
  * Yahoo Finance provider (free, no API key required)
  */
 export class YahooFinanceProvider extends DataProvider {
+  private nativeParser = true;
+
   constructor() {
     super({
       provider: 'yahoo',
@@ -51,48 +58,28 @@ export class YahooFinanceProvider extends DataProvider {
     symbol: string,
     startDate: string,
     endDate: string
-  ): Promise<OHLCVData[]> {
+  ): Promise<OHLCVColumns> {
     try {
+      // period2 is exclusive and daily bars are stamped at the session
+      // open, so the range must run to the end of endDate to include it
       const start = Math.floor(new Date(startDate).getTime() / 1000);
-      const end = Math.floor(new Date(endDate).getTime() / 1000);
+      const end = Math.floor(new Date(endDate).getTime() / 1000) + 86400;
 
-      const response = await this.client.get('/v8/finance/chart/' + symbol, {
+      // Raw bytes: the native parser reads them without building JS objects
+      const response = await this.client.get<ArrayBuffer>('/v8/finance/chart/' + symbol, {
         params: {
           period1: start,
           period2: end,
           interval: '1d',
           events: 'history',
         },
+        responseType: 'arraybuffer',
       });
 
-      const result = response.data?.chart?.result?.[0];
-      if (!result || !result.timestamp) {
-        throw new DataProviderError('Invalid response from Yahoo Finance');
-      }
-
-      const timestamps = result.timestamp;
-      const quotes = result.indicators?.quote?.[0];
-
-      if (!quotes) {
-        throw new DataProviderError('No quote data available');
-      }
-
-      const data: OHLCVData[] = [];
-      for (let i = 0; i < timestamps.length; i++) {
-        // Skip null entries
-        if (quotes.close[i] === null) continue;
-
-        data.push({
-          date: new Date(timestamps[i] * 1000).toISOString().split('T')[0],
-          open: quotes.open[i] ?? quotes.close[i],
-          high: quotes.high[i] ?? quotes.close[i],
-          low: quotes.low[i] ?? quotes.close[i],
-          close: quotes.close[i],
-          volume: quotes.volume[i] ?? 0,
-        });
-      }
-
-      return data;
+      const data = this.parseChart(Buffer.from(response.data));
+      const first = rowsThrough(data.date, toEpochDay(startDate) - 1);
+      const last = rowsThrough(data.date, toEpochDay(endDate));
+      return first === 0 && last === data.date.length ? data : sliceColumns(data, first, last);
     } catch (error) {
       if (axios.isAxiosError(error)) {
         logger.error(`Yahoo Finance API error: ${error.message}`);
@@ -105,6 +92,58 @@ export class YahooFinanceProvider extends DataProvider {
     }
   }
 
+  private parseChart(body: Buffer): OHLCVColumns {
+    if (this.nativeParser) {
+      try {
+        return parseChartColumns(body);
+      } catch (error) {
+        if (!(error as Error).message.includes('not compiled')) {
+          logger.debug('Native chart parse failed:', error);
+          throw new DataProviderError('Invalid response from Yahoo Finance');
+        }
+        // No native module: parse in JS from now on
+        this.nativeParser = false;
+      }
+    }
+
+    let parsed;
+    try {
+      parsed = JSON.parse(body.toString('utf-8'));
+    } catch {
+      throw new DataProviderError('Invalid response from Yahoo Finance');
+    }
+
+    const result = parsed?.chart?.result?.[0];
+    if (!result || !result.timestamp) {
+      throw new DataProviderError('Invalid response from Yahoo Finance');
+    }
+
+    const timestamps = result.timestamp;
+    const quotes = result.indicators?.quote?.[0];
+
+    if (!quotes) {
+      throw new DataProviderError('No quote data available');
+    }
+
+    // Filled straight from the response's parallel arrays
+    const data = allocateColumns(timestamps.length);
+    let rows = 0;
+    for (let i = 0; i < timestamps.length; i++) {
+      // Skip null entries
+      if (quotes.close[i] === null) continue;
+
+      data.date[rows] = Math.floor(timestamps[i] / 86400);
+      data.open[rows] = quotes.open[i] ?? quotes.close[i];
+      data.high[rows] = quotes.high[i] ?? quotes.close[i];
+      data.low[rows] = quotes.low[i] ?? quotes.close[i];
+      data.close[rows] = quotes.close[i];
+      data.volume[rows] = quotes.volume[i] ?? 0;
+      rows++;
+    }
+
+    return rows === timestamps.length ? data : sliceColumns(data, 0, rows);
+  }
+
   async searchSymbol(query: string): Promise<string[]> {
     try {
       const response = await this.client.get('/v1/finance/search', {
@@ -146,7 +185,7 @@ export class NSEProvider extends DataProvider {
     symbol: string,
     startDate: string,
     endDate: string
-  ): Promise<OHLCVData[]> {
+  ): Promise<OHLCVColumns> {
     // Note: NSE API implementation depends on specific provider/subscription
     // This is a placeholder that would need actual NSE API integration
     throw new DataProviderError(
@@ -1,26 +1,101 @@
 /**
  * Portfolio service with file-based persistence
- * Stores portfolios as JSON files in configured directory
+ * Stores portfolios in a log-structured store in the configured directory
  */
 
-import fs from 'fs/promises';
-import path from 'path';
 import { Portfolio, PortfolioHolding } from '../types';
 import { logger } from '../utils/logger';
 import { createDataProvider } from './dataProvider';
-import {
-  calculateStockSpan,
-  withSegmentTree,
-  querySegmentTree,
-} from '../native/dist/wrapper';
+import { PortfolioStore } from './portfolioStore';
+import { getHistoricalColumns } from '../cache/historicalCache';
+import { analyzeBatch, getAnalysisPool } from '../nativeBridge';
 
 const PORTFOLIOS_DIR = process.env.PORTFOLIOS_DIR || './data/portfolios';
 const dataProvider = createDataProvider();
+const store = new PortfolioStore(PORTFOLIOS_DIR);
+
+// BATCH_CONCURRENCY, default 8: holdings fetched and analyzed at once
+function defaultConcurrency(): number {
+  const limit = parseInt(process.env.BATCH_CONCURRENCY || '', 10);
+  return Number.isNaN(limit) || limit < 1 ? 8 : limit;
+}
+
+export interface BatchAnalyzeOptions {
+  /** Holdings in flight at once (default, or if not an integer >= 1: BATCH_CONCURRENCY) */
+  concurrency?: number;
+  /** Abort the analysis (see batchAnalyze) */
+  signal?: AbortSignal;
+}
+
+export interface HoldingAnalysis {
+  symbol: string;
+  success: boolean;
+  data?: {
+    spanAvg: number;
+    rangeStats: { min: number; max: number; avg: number; variance: number };
+  };
+  error?: string;
+  processingTimeMs: number;
+}
+
+// The parts of a native BatchResult used here
+interface NativeBatchResult {
+  computeTimeMs: number;
+  error?: string;
+  spans?: Int32Array;
+  stats?: { min: number; max: number; avg: number; variance: number };
+}
+
+/**
+ * Feeds fetched series to the native batch analyzer while other fetches
+ * continue: one batch runs at a time and the next takes every series that
+ * arrived meanwhile, so compute overlaps I/O without a call per holding.
+ * Batches run in the worker pool when there is one.
+ */
+class AnalysisQueue {
+  private pending: Array<{
+    prices: Float64Array;
+    resolve: (result: NativeBatchResult) => void;
+    reject: (error: unknown) => void;
+  }> = [];
+  private running = false;
+  private signal?: AbortSignal;
+
+  constructor(signal?: AbortSignal) {
+    this.signal = signal;
+  }
+
+  analyze(prices: Float64Array): Promise<NativeBatchResult> {
+    return new Promise((resolve, reject) => {
+      this.pending.push({ prices, resolve, reject });
+      if (!this.running) void this.drain();
+    });
+  }
+
+  private async drain(): Promise<void> {
+    this.running = true;
+    while (this.pending.length > 0) {
+      const batch = this.pending;
+      this.pending = [];
+      try {
+        const jobs = batch.map(({ prices }) => ({ prices, span: true, stats: true }));
+        const pool = getAnalysisPool();
+        const results: NativeBatchResult[] = pool
+          ? await pool.analyzeBatch(jobs, { signal: this.signal })
+          : await analyzeBatch(jobs, { signal: this.signal });
+        batch.forEach((entry, j) => entry.resolve(results[j]));
+      } catch (error) {
+        batch.forEach(entry => entry.reject(error));
+      }
+    }
+    this.running = false;
+  }
+}
 
 export class PortfolioService {
   async init(): Promise<void> {
     try {
-      await fs.mkdir(PORTFOLIOS_DIR, { recursive: true });
+      await store.load();
       logger.info(`Portfolios directory initialized: ${PORTFOLIOS_DIR}`);
     } catch (error) {
       logger.error('Failed to initialize portfolios directory:', error);
@@ -28,27 +103,13 @@ export class PortfolioService {
     }
   }
 
-  private getPortfolioPath(id: string): string {
-    return path.join(PORTFOLIOS_DIR, `${id}.json`);
-  }
-
   async listPortfolios(): Promise<Portfolio[]> {
     try {
-      const files = await fs.readdir(PORTFOLIOS_DIR);
-      const jsonFiles = files.filter(f => f.endsWith('.json'));
-
-      const portfolios = await Promise.all(
-        jsonFiles.map(async (file) => {
-          const content = await fs.readFile(
-            path.join(PORTFOLIOS_DIR, file),
-            'utf-8'
-          );
-          return JSON.parse(content) as Portfolio;
-        })
-      );
+      const portfolios = await store.list();
 
-      return portfolios.sort((a, b) => 
-        new Date(b.updatedAt).getTime() - new Date(a.updatedAt).getTime()
+      // ISO timestamps sort chronologically as strings
+      return portfolios.sort((a, b) =>
+        a.updatedAt < b.updatedAt ? 1 : a.updatedAt > b.updatedAt ? -1 : 0
       );
     } catch (error) {
       logger.error('Error listing portfolios:', error);
@@ -57,15 +118,7 @@ export class PortfolioService {
   }
 
   async getPortfolio(id: string): Promise<Portfolio | null> {
-    try {
-      const content = await fs.readFile(this.getPortfolioPath(id), 'utf-8');
-      return JSON.parse(content);
-    } catch (error) {
-      if ((error as NodeJS.ErrnoException).code === 'ENOENT') {
-        return null;
-      }
-      throw error;
-    }
+    return store.get(id);
   }
 
   async createPortfolio(data: {
@@ -82,11 +135,7 @@ export class PortfolioService {
       updatedAt: new Date().toISOString(),
     };
 
-    await fs.writeFile(
-      this.getPortfolioPath(id),
-      JSON.stringify(portfolio, null, 2),
-      'utf-8'
-    );
+    await store.put(portfolio);
 
     logger.info(`Portfolio created: ${id}`);
     return portfolio;
@@ -96,72 +145,32 @@ export class PortfolioService {
     id: string,
     data: { name?: string; description?: string }
   ): Promise<Portfolio | null> {
-    const portfolio = await this.getPortfolio(id);
-    if (!portfolio) return null;
-
-    if (data.name !== undefined) portfolio.name = data.name;
-    if (data.description !== undefined) portfolio.description = data.description;
-    portfolio.updatedAt = new Date().toISOString();
-
-    await fs.writeFile(
-      this.getPortfolioPath(id),
-      JSON.stringify(portfolio, null, 2),
-      'utf-8'
+    const portfolio = await store.update(
+      id,
+      { name: data.name, description: data.description },
+      new Date().toISOString()
     );
+    if (!portfolio) return null;
 
     logger.info(`Portfolio updated: ${id}`);
     return portfolio;
   }
 
   async deletePortfolio(id: string): Promise<boolean> {
-    try {
-      await fs.unlink(this.getPortfolioPath(id));
+    const deleted = await store.delete(id);
+    if (deleted) {
       logger.info(`Portfolio deleted: ${id}`);
-      return true;
-    } catch (error) {
-      if ((error as NodeJS.ErrnoException).code === 'ENOENT') {
-        return false;
-      }
-      throw error;
     }
+    return deleted;
   }
 
   async addHolding(
     portfolioId: string,
     holding: Omit<PortfolioHolding, 'addedAt'>
   ): Promise<Portfolio | null> {
-    const portfolio = await this.getPortfolio(portfolioId);
+    const portfolio = await this.upsertHoldings(portfolioId, [holding]);
     if (!portfolio) return null;
 
-    // Check if holding already exists
-    const existingIndex = portfolio.holdings.findIndex(
-      h => h.symbol.toUpperCase() === holding.symbol.toUpperCase()
-    );
-
-    if (existingIndex >= 0) {
-      // Update existing holding
-      portfolio.holdings[existingIndex] = {
-        ...portfolio.holdings[existingIndex],
-        quantity: holding.quantity,
-        averagePrice: holding.averagePrice,
-      };
-    } else {
-      // Add new holding
-      portfolio.holdings.push({
-        ...holding,
-        symbol: holding.symbol.toUpperCase(),
-        addedAt: new Date().toISOString(),
-      });
-    }
-
-    portfolio.updatedAt = new Date().toISOString();
-
-    await fs.writeFile(
-      this.getPortfolioPath(portfolioId),
-      JSON.stringify(portfolio, null, 2),
-      'utf-8'
-    );
-
     logger.info(`Holding added to portfolio ${portfolioId}: ${holding.symbol}`);
     return portfolio;
   }
@@ -170,19 +179,13 @@ export class PortfolioService {
     portfolioId: string,
     symbol: string
   ): Promise<Portfolio | null> {
-    const portfolio = await this.getPortfolio(portfolioId);
-    if (!portfolio) return null;
-
-    portfolio.holdings = portfolio.holdings.filter(
-      h => h.symbol.toUpperCase() !== symbol.toUpperCase()
-    );
-    portfolio.updatedAt = new Date().toISOString();
-
-    await fs.writeFile(
-      this.getPortfolioPath(portfolioId),
-      JSON.stringify(portfolio, null, 2),
-      'utf-8'
+    const portfolio = await store.changeHoldings(
+      portfolioId,
+      [],
+      [symbol],
+      new Date().toISOString()
     );
+    if (!portfolio) return null;
 
     logger.info(`Holding removed from portfolio ${portfolioId}: ${symbol}`);
     return portfolio;
@@ -232,110 +235,183 @@ export class PortfolioService {
       });
     }
 
-    // Add all holdings
-    for (const holding of importedHoldings) {
-      await this.addHolding(portfolioId, holding);
-    }
-
-    const updatedPortfolio = await this.getPortfolio(portfolioId);
+    // All holdings in one store record
+    const updatedPortfolio = await this.upsertHoldings(portfolioId, importedHoldings);
     logger.info(`Imported ${importedHoldings.length} holdings to portfolio ${portfolioId}`);
     return updatedPortfolio;
   }
 
+  /**
+   * Add holdings or update the quantity and average price of existing ones
+   * (matched by symbol, case-insensitive; later entries win), in one write
+   */
+  private async upsertHoldings(
+    portfolioId: string,
+    holdings: Omit<PortfolioHolding, 'addedAt'>[]
+  ): Promise<Portfolio | null> {
+    const portfolio = await this.getPortfolio(portfolioId);
+    if (!portfolio) return null;
+
+    const now = new Date().toISOString();
+    const existing = new Map<string, PortfolioHolding>();
+    for (const holding of portfolio.holdings) {
+      existing.set(holding.symbol.toUpperCase(), holding);
+    }
+
+    const merged = new Map<string, PortfolioHolding>();
+    for (const holding of holdings) {
+      const key = holding.symbol.toUpperCase();
+      const current = merged.get(key) ?? existing.get(key);
+      merged.set(
+        key,
+        current
+          ? // Update existing holding
+            { ...current, quantity: holding.quantity, averagePrice: holding.averagePrice }
+          : // Add new holding
+            { ...holding, symbol: key, addedAt: now }
+      );
+    }
+
+    return store.changeHoldings(portfolioId, Array.from(merged.values()), [], now);
+  }
+
   /**
    * Batch analyze all holdings in a portfolio
+   *
+   * Up to `concurrency` holdings are in flight at once, so total time
+   * approaches that of the slowest holding rather than the sum. onProgress
+   * reports each holding as it starts, in portfolio order. Aborting
+   * `signal` stops new holdings from starting, skips queued native work
+   * and rejects with the abort reason; fetches already running complete in
+   * the background (their results still reach the cache).
    */
   async batchAnalyze(
     portfolioId: string,
     startDate: string,
     endDate: string,
-    onProgress?: (current: number, total: number, symbol: string) => void
+    onProgress?: (current: number, total: number, symbol: string) => void,
+    options: BatchAnalyzeOptions = {}
   ): Promise<{
-    results: Array<{
-      symbol: string;
-      success: boolean;
-      data?: {
-        spanAvg: number;
-        rangeStats: { min: number; max: number; avg: number; variance: number };
-      };
-      error?: string;
-      processingTimeMs: number;
-    }>;
+    results: HoldingAnalysis[];
     totalTimeMs: number;
   }> {
+    const { signal } = options;
+    signal?.throwIfAborted();
+
     const portfolio = await this.getPortfolio(portfolioId);
     if (!portfolio) {
       throw new Error('Portfolio not found');
     }
+    signal?.throwIfAborted();
 
     const startTime = Date.now();
-    const results: Array<{
-      symbol: string;
-      success: boolean;
-      data?: {
-        spanAvg: number;
-        rangeStats: { min: number; max: number; avg: number; variance: number };
-      };
-      error?: string;
-      processingTimeMs: number;
-    }> = [];
+    const holdings = portfolio.holdings;
+    const results: HoldingAnalysis[] = new Array(holdings.length);
+    const analysis = new AnalysisQueue(signal);
 
-    for (let i = 0; i < portfolio.holdings.length; i++) {
-      const holding = portfolio.holdings[i];
+    const analyzeHolding = async (i: number): Promise<void> => {
+      const { symbol } = holdings[i];
       const symbolStartTime = Date.now();
 
       if (onProgress) {
-        onProgress(i + 1, portfolio.holdings.length, holding.symbol);
+        onProgress(i + 1, holdings.length, symbol);
       }
 
+      let prices: Float64Array;
       try {
-        // Fetch historical data
-        const historicalData = await dataProvider.fetchHistoricalData(
-          holding.symbol,
-          startDate,
-          endDate
+        const { columns } = await getHistoricalColumns(symbol, startDate, endDate, (start, end) =>
+          dataProvider.fetchHistoricalData(symbol, start, end)
         );
-
-        if (historicalData.length === 0) {
-          results.push({
-            symbol: holding.symbol,
-            success: false,
-            error: 'No data available',
-            processingTimeMs: Date.now() - symbolStartTime,
-          });
-          continue;
-        }
-
-        // Extract close prices
-        const prices = new Float64Array(historicalData.map(d => d.close));
-
-        // Calculate span
-        const spans = await calculateStockSpan(prices);
-        const spanAvg = Array.from(spans).reduce((a, b) => a + b, 0) / spans.length;
-
-        // Query range stats
-        const rangeStats = await withSegmentTree(prices, async (tree) => {
-          return await querySegmentTree(tree, 0, prices.length - 1);
-        });
-
-        results.push({
-          symbol: holding.symbol,
-          success: true,
-          data: {
-            spanAvg,
-            rangeStats,
-          },
-          processingTimeMs: Date.now() - symbolStartTime,
-        });
+        prices = columns.close;
       } catch (error) {
-        logger.error(`Error analyzing ${holding.symbol}:`, error);
-        results.push({
-          symbol: holding.symbol,
+        logger.error(`Error fetching ${symbol}:`, error);
+        results[i] = {
+          symbol,
           success: false,
           error: (error as Error).message,
           processingTimeMs: Date.now() - symbolStartTime,
-        });
+        };
+        return;
+      }
+
+      if (prices.length === 0) {
+        results[i] = {
+          symbol,
+          success: false,
+          error: 'No data available',
+          processingTimeMs: Date.now() - symbolStartTime,
+        };
+        return;
+      }
+      if (signal?.aborted) return;
+
+      const fetchTimeMs = Date.now() - symbolStartTime;
+      let result: NativeBatchResult;
+      try {
+        result = await analysis.analyze(prices);
+      } catch (error) {
+        if (signal?.aborted) return;
+        result = { error: (error as Error).message, computeTimeMs: 0 };
+      }
+      const processingTimeMs = fetchTimeMs + result.computeTimeMs;
+
+      if (result.error || !result.spans || !result.stats) {
+        logger.error(`Error analyzing ${symbol}: ${result.error}`);
+        results[i] = {
+          symbol,
+          success: false,
+          error: result.error || 'Analysis failed',
+          processingTimeMs,
+        };
+        return;
       }
+
+      let spanSum = 0;
+      for (let k = 0; k < result.spans.length; k++) {
+        spanSum += result.spans[k];
+      }
+
+      results[i] = {
+        symbol,
+        success: true,
+        data: {
+          spanAvg: spanSum / result.spans.length,
+          rangeStats: result.stats,
+        },
+        processingTimeMs,
+      };
+    };
+
+    // Each lane takes the next holding in order until none are left
+    let next = 0;
+    const lane = async (): Promise<void> => {
+      while (next < holdings.length && !signal?.aborted) {
+        await analyzeHolding(next++);
+      }
+    };
+    // Anything but a positive integer (NaN, 0, 2.5) gets the default
+    const requested = options.concurrency;
+    const width = requested !== undefined && Number.isInteger(requested) && requested >= 1
+      ? requested
+      : defaultConcurrency();
+    const limit = Math.min(width, holdings.length);
+    const lanes = Promise.all(Array.from({ length: Math.max(limit, 1) }, lane));
+
+    if (signal) {
+      // Settle as soon as the signal aborts, without waiting on fetches
+      let onAbort = () => {};
+      const aborted = new Promise<never>((_resolve, reject) => {
+        onAbort = () => reject(signal.reason);
+        signal.addEventListener('abort', onAbort, { once: true });
+      });
+      try {
+        await Promise.race([lanes, aborted]);
+      } finally {
+        signal.removeEventListener('abort', onAbort);
+      }
+      signal.throwIfAborted();
+    } else {
+      await lanes;
     }
 
     const totalTimeMs = Date.now() - startTime;
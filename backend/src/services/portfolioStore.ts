@@ -0,0 +1,242 @@
+/**
+ * Log-structured portfolio store
+ *
+ * Every portfolio is held in memory, indexed by id, so reads and listings
+ * touch no files. On disk the store is an AppendLog of change records (one
+ * JSON object per line): a change costs one short line no matter how large
+ * the portfolio is, and a bulk import is a single record. Once the log is
+ * mostly superseded records it is rewritten as one record per portfolio.
+ *
+ * Stored portfolios are replaced rather than mutated on change, so objects
+ * handed out never change underneath the caller; treat them as read-only.
+ */
+
+import fs from 'fs/promises';
+import path from 'path';
+import { Portfolio, PortfolioHolding } from '../types';
+import { AppendLog } from '../utils/appendLog';
+import { logger } from '../utils/logger';
+
+const LOG_FILE = 'portfolios.log';
+
+type LogRecord =
+  | { op: 'put'; portfolio: Portfolio }
+  | { op: 'update'; id: string; name?: string; description?: string; updatedAt: string }
+  | {
+      op: 'holdings';
+      id: string;
+      set: PortfolioHolding[];  // Replace same symbol (any case) or append
+      remove: string[];         // Symbols, any case
+      updatedAt: string;
+    }
+  | { op: 'delete'; id: string };
+
+export class PortfolioStore {
+  private dir: string;
+  private log: AppendLog;
+  private portfolios = new Map<string, Portfolio>();
+  private loading: Promise<void> | null = null;
+  private compacting = false;
+
+  constructor(dir: string) {
+    this.dir = dir;
+    this.log = new AppendLog(path.join(dir, LOG_FILE), 'portfolio log');
+  }
+
+  /**
+   * Read the log (once); a directory of per-portfolio JSON files from
+   * before the log is migrated into it
+   */
+  load(): Promise<void> {
+    if (!this.loading) {
+      this.loading = this.readLog().catch(error => {
+        this.loading = null;
+        throw error;
+      });
+    }
+    return this.loading;
+  }
+
+  async list(): Promise<Portfolio[]> {
+    await this.load();
+    return Array.from(this.portfolios.values());
+  }
+
+  async get(id: string): Promise<Portfolio | null> {
+    await this.load();
+    return this.portfolios.get(id) ?? null;
+  }
+
+  /**
+   * Store a whole portfolio, replacing any with the same id
+   */
+  async put(portfolio: Portfolio): Promise<void> {
+    await this.load();
+    await this.commit({ op: 'put', portfolio });
+  }
+
+  /**
+   * Change name and/or description; null if there is no such portfolio
+   */
+  async update(
+    id: string,
+    fields: { name?: string; description?: string },
+    updatedAt: string
+  ): Promise<Portfolio | null> {
+    await this.load();
+    if (!this.portfolios.has(id)) return null;
+    await this.commit({ op: 'update', id, ...fields, updatedAt });
+    return this.portfolios.get(id) ?? null;
+  }
+
+  /**
+   * Upsert holdings by symbol (case-insensitive, later entries win) and
+   * remove others, as one record; null if there is no such portfolio
+   */
+  async changeHoldings(
+    id: string,
+    set: PortfolioHolding[],
+    remove: string[],
+    updatedAt: string
+  ): Promise<Portfolio | null> {
+    await this.load();
+    if (!this.portfolios.has(id)) return null;
+    await this.commit({ op: 'holdings', id, set, remove, updatedAt });
+    return this.portfolios.get(id) ?? null;
+  }
+
+  async delete(id: string): Promise<boolean> {
+    await this.load();
+    if (!this.portfolios.has(id)) return false;
+    await this.commit({ op: 'delete', id });
+    return true;
+  }
+
+  /**
+   * Rewrite the log as one record per portfolio if it is mostly
+   * superseded records (or unconditionally with `force`)
+   */
+  compact(force: boolean = false): Promise<void> {
+    if (!force && !this.log.needsCompaction(this.portfolios.size)) return this.log.settled();
+
+    // Changes are applied once written, so the snapshot holds exactly the
+    // records written before it; batches queued behind it follow it
+    return this.log.rewrite(() => {
+      let text = '';
+      for (const portfolio of this.portfolios.values()) {
+        text += JSON.stringify({ op: 'put', portfolio }) + '\n';
+      }
+      return { text, records: this.portfolios.size };
+    });
+  }
+
+  private async readLog(): Promise<void> {
+    await fs.mkdir(this.dir, { recursive: true });
+
+    const lines = await this.log.read();
+    if (!lines) {
+      await this.migrate();
+      return;
+    }
+
+    this.portfolios.clear();
+    let skipped = 0;
+    for (let i = 0; i < lines.length; i++) {
+      if (!lines[i]) continue;
+      let record: LogRecord;
+      try {
+        record = JSON.parse(lines[i]);
+      } catch {
+        logger.warn(`Skipping unreadable portfolio log record at line ${i + 1}`);
+        skipped++;
+        continue;
+      }
+      this.apply(record);
+    }
+
+    // Rewrite without the damaged lines, so they are not read again
+    if (skipped > 0) await this.compact(true);
+  }
+
+  // Per-portfolio <id>.json files predate the log
+  private async migrate(): Promise<void> {
+    let files: string[];
+    try {
+      files = (await fs.readdir(this.dir)).filter(file => file.endsWith('.json'));
+    } catch (error) {
+      if ((error as NodeJS.ErrnoException).code === 'ENOENT') return;
+      throw error;
+    }
+    if (files.length === 0) return;
+
+    for (const file of files) {
+      const content = await fs.readFile(path.join(this.dir, file), 'utf-8');
+      const portfolio = JSON.parse(content) as Portfolio;
+      this.portfolios.set(portfolio.id, portfolio);
+    }
+    await this.compact(true);
+    await Promise.all(files.map(file => fs.unlink(path.join(this.dir, file))));
+    logger.info(`Migrated ${files.length} portfolio files to ${LOG_FILE}`);
+  }
+
+  // Applied once written: a failed write leaves no trace in memory either
+  private commit(record: LogRecord): Promise<void> {
+    const written = this.log.append(JSON.stringify(record) + '\n', 1, () => this.apply(record));
+
+    if (!this.compacting && this.log.needsCompaction(this.portfolios.size)) {
+      this.compacting = true;
+      // Failures are logged by the log; the next commit retries
+      this.compact()
+        .catch(() => undefined)
+        .then(() => {
+          this.compacting = false;
+        });
+    }
+    return written;
+  }
+
+  private apply(record: LogRecord): void {
+    switch (record.op) {
+      case 'put':
+        this.portfolios.set(record.portfolio.id, record.portfolio);
+        break;
+
+      case 'update': {
+        const current = this.portfolios.get(record.id);
+        if (!current) break;
+        const next = { ...current, updatedAt: record.updatedAt };
+        if (record.name !== undefined) next.name = record.name;
+        if (record.description !== undefined) next.description = record.description;
+        this.portfolios.set(record.id, next);
+        break;
+      }
+
+      case 'holdings': {
+        const current = this.portfolios.get(record.id);
+        if (!current) break;
+
+        const removed = new Set(record.remove.map(symbol => symbol.toUpperCase()));
+        const holdings = current.holdings.filter(h => !removed.has(h.symbol.toUpperCase()));
+        const positions = new Map<string, number>();
+        holdings.forEach((h, i) => positions.set(h.symbol.toUpperCase(), i));
+        for (const holding of record.set) {
+          const key = holding.symbol.toUpperCase();
+          const position = positions.get(key);
+          if (position === undefined) {
+            positions.set(key, holdings.length);
+            holdings.push(holding);
+          } else {
+            holdings[position] = holding;
+          }
+        }
+
+        this.portfolios.set(record.id, { ...current, holdings, updatedAt: record.updatedAt });
+        break;
+      }
+
+      case 'delete':
+        this.portfolios.delete(record.id);
+        break;
+    }
+  }
+}
@@ -2,6 +2,14 @@
  * Shared type definitions for DSA backend
  */
 
+import type { Readable } from 'stream';
+
+// Typed price input; Float32Array runs the float32 native kernels
+export type PriceArray = Float64Array | Float32Array;
+
+// Prices, or the id of a series registered with the native module
+export type PriceSource = PriceArray | number;
+
 export interface OHLCVData {
   date: string;
   open: number;
@@ -11,6 +19,16 @@ export interface OHLCVData {
   volume: number;
 }
 
+// OHLCV rows stored column-wise; dates are days since 1970-01-01 (UTC)
+export interface OHLCVColumns {
+  date: Int32Array;
+  open: Float64Array;
+  high: Float64Array;
+  low: Float64Array;
+  close: Float64Array;
+  volume: Float64Array;
+}
+
 export interface HistoricalDataRequest {
   symbol: string;
   startDate: string; // YYYY-MM-DD
@@ -86,6 +104,28 @@ export interface WindowAnalysisResponse {
   processingTimeMs: number;
 }
 
+/**
+ * Window analysis with `windows` already encoded as JSON array / NDJSON text
+ */
+export interface EncodedWindowAnalysis {
+  symbol?: string;
+  windowSize: number;
+  format: 'json' | 'ndjson';
+  windows: Buffer;
+  processingTimeMs: number;
+}
+
+/**
+ * Window analysis whose encoded windows are produced by a byte stream
+ */
+export interface WindowAnalysisStream {
+  symbol?: string;
+  windowSize: number;
+  format: 'json' | 'ndjson';
+  windowCount: number;
+  stream: Readable;
+}
+
 export interface Portfolio {
   id: string;
   name: string;
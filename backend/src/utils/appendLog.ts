@@ -0,0 +1,144 @@
+/**
+ * Append-only log file of one-line records
+ *
+ * Shared by the stores that keep their state in memory and persist it as
+ * a log of changes (portfolio store, file cache expiry index). Writes run
+ * one at a time, so a rewrite never races an append; lines appended while
+ * a write is in flight go out together in the next one. Once the log is
+ * mostly superseded records the owner rewrites it from its in-memory
+ * state.
+ */
+
+import fs from 'fs/promises';
+import { logger } from './logger';
+
+// Rewrite once the log holds this many records beyond twice the live count
+const COMPACT_SLACK = 1024;
+
+export class AppendLog {
+  private filePath: string;
+  private description: string;
+  private writes: Promise<void> = Promise.resolve();
+  private pending: {
+    text: string;
+    records: number;
+    callbacks: Array<() => void>;
+    written: Promise<void>;
+  } | null = null;
+  private lines = 0;
+  private torn = false;  // a failed append may have left a partial line
+
+  /**
+   * @param description - What the log holds, for error messages
+   */
+  constructor(filePath: string, description: string) {
+    this.filePath = filePath;
+    this.description = description;
+  }
+
+  /**
+   * Records in the log, including superseded ones
+   */
+  get records(): number {
+    return this.lines;
+  }
+
+  /**
+   * Lines of the log, or null if there is none
+   *
+   * A partial last line (an append cut short by a crash) is cut off the
+   * file, so the next append does not run on from it.
+   */
+  async read(): Promise<string[] | null> {
+    let data: Buffer;
+    try {
+      data = await fs.readFile(this.filePath);
+    } catch (error) {
+      if ((error as NodeJS.ErrnoException).code === 'ENOENT') return null;
+      throw error;
+    }
+
+    const end = data.lastIndexOf(0x0a) + 1;
+    if (end < data.length) {
+      logger.warn(`Dropping partly written last record of ${this.description}`);
+      await fs.truncate(this.filePath, end);
+    }
+
+    const lines = end > 0 ? data.toString('utf-8', 0, end - 1).split('\n') : [];
+    this.lines = lines.length;
+    return lines;
+  }
+
+  /**
+   * Append `count` records (complete lines); joins the write waiting to
+   * start, if any. `onWritten` runs once they are written, in append
+   * order and before the returned promise resolves; not if the write fails.
+   */
+  append(text: string, count: number = 1, onWritten?: () => void): Promise<void> {
+    if (this.pending) {
+      this.pending.text += text;
+      this.pending.records += count;
+      if (onWritten) this.pending.callbacks.push(onWritten);
+      return this.pending.written;
+    }
+
+    const batch = {
+      text,
+      records: count,
+      callbacks: onWritten ? [onWritten] : [],
+      written: Promise.resolve(),
+    };
+    this.pending = batch;
+    batch.written = this.enqueue(async () => {
+      if (this.pending === batch) this.pending = null;
+      // An empty line ends whatever a failed append left; readers skip both
+      const text = this.torn ? '\n' + batch.text : batch.text;
+      this.torn = true;
+      await fs.appendFile(this.filePath, text, 'utf-8');
+      this.torn = false;
+      this.lines += batch.records;
+      for (const callback of batch.callbacks) callback();
+    });
+    return batch.written;
+  }
+
+  /**
+   * True once superseded records outnumber the `live` ones enough to
+   * rewrite the log
+   */
+  needsCompaction(live: number): boolean {
+    return this.lines > live * 2 + COMPACT_SLACK;
+  }
+
+  /**
+   * Replace the log with the records `build` returns. `build` runs when
+   * the rewrite's turn comes, after every write queued before it.
+   */
+  rewrite(build: () => { text: string; records: number }): Promise<void> {
+    return this.enqueue(async () => {
+      const { text, records } = build();
+
+      // Write beside the log, then swap, so a crash leaves one intact
+      const temporary = `${this.filePath}.tmp`;
+      await fs.writeFile(temporary, text, 'utf-8');
+      await fs.rename(temporary, this.filePath);
+      this.lines = records;
+      this.torn = false;
+    });
+  }
+
+  /**
+   * Resolves (never rejects) once the writes queued so far are done
+   */
+  settled(): Promise<void> {
+    return this.writes;
+  }
+
+  private enqueue(write: () => Promise<void>): Promise<void> {
+    const result = this.writes.then(write);
+    this.writes = result.catch(error => {
+      logger.error(`Failed to write ${this.description}:`, error);
+    });
+    return result;
+  }
+}
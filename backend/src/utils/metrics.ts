@@ -0,0 +1,84 @@
+/**
+ * Prometheus text exposition of native (libdsa) call statistics
+ */
+
+// Structural copy of the native NativeStats type (nativeBridge is untyped)
+export interface NativeStatsSnapshot {
+  enabled: boolean;
+  bucketBoundsNs: ArrayLike<number>;
+  functions: Record<
+    string,
+    {
+      calls: number;
+      errors: number;
+      elements: number;
+      bytesAllocated: number;
+      totalNs: number;
+      histogram: ArrayLike<number>;
+    }
+  >;
+}
+
+const COUNTERS = [
+  ['calls', 'dsa_native_calls_total', 'libdsa calls'],
+  ['errors', 'dsa_native_errors_total', 'libdsa calls that returned an error'],
+  ['elements', 'dsa_native_elements_total', 'Input elements (prices, rows or bytes) passed to libdsa'],
+  ['bytesAllocated', 'dsa_native_allocated_bytes_total', 'Memory returned by libdsa calls'],
+] as const;
+
+const HISTOGRAM = 'dsa_native_call_duration_seconds';
+
+// libdsa keeps 4 buckets per power of two; every second power is plenty here
+function isExportedBound(ns: number): boolean {
+  const log = Math.log2(ns);
+  return Number.isInteger(log) && log % 2 === 0;
+}
+
+/**
+ * Format native call statistics, or `dsa_native_up 0` when the addon is
+ * not available
+ *
+ * Histogram buckets are cumulative at 64 ns, 256 ns, 1 us, ... 68.7 s
+ * (native bucket bounds are exclusive; the 1 ns difference is ignored).
+ */
+export function formatNativeMetrics(stats: NativeStatsSnapshot | null): string {
+  const lines: string[] = [
+    '# HELP dsa_native_up Whether the native analysis module is loaded',
+    '# TYPE dsa_native_up gauge',
+    `dsa_native_up ${stats ? 1 : 0}`,
+  ];
+  if (!stats) return lines.join('\n') + '\n';
+
+  lines.push(
+    '# HELP dsa_native_stats_enabled Whether libdsa call statistics are being collected',
+    '# TYPE dsa_native_stats_enabled gauge',
+    `dsa_native_stats_enabled ${stats.enabled ? 1 : 0}`
+  );
+
+  const functions = Object.entries(stats.functions);
+  for (const [field, name, help] of COUNTERS) {
+    lines.push(`# HELP ${name} ${help}`, `# TYPE ${name} counter`);
+    for (const [fn, counters] of functions) {
+      lines.push(`${name}{function="${fn}"} ${counters[field]}`);
+    }
+  }
+
+  lines.push(`# HELP ${HISTOGRAM} libdsa call latency`, `# TYPE ${HISTOGRAM} histogram`);
+  const bounds = stats.bucketBoundsNs;
+  for (const [fn, counters] of functions) {
+    let cumulative = 0;
+    for (let b = 0; b < bounds.length; b++) {
+      cumulative += counters.histogram[b];
+      if (isExportedBound(bounds[b])) {
+        lines.push(`${HISTOGRAM}_bucket{function="${fn}",le="${bounds[b] / 1e9}"} ${cumulative}`);
+      }
+    }
+    lines.push(
+      `${HISTOGRAM}_bucket{function="${fn}",le="+Inf"} ${cumulative}`,
+      `${HISTOGRAM}_sum{function="${fn}"} ${counters.totalNs / 1e9}`,
+      `${HISTOGRAM}_count{function="${fn}"} ${cumulative}`
+    );
+  }
+
+  return lines.join('\n') + '\n';
+}
@@ -0,0 +1,137 @@
+/**
+ * Columnar OHLCV helpers
+ *
+ * OHLCVColumns is the backend's representation of price history from the
+ * data provider through every cache tier to the native bindings; the close
+ * column is handed to the addon as is. Rows (OHLCVData) are built only for
+ * JSON responses.
+ */
+
+import { OHLCVData, OHLCVColumns } from '../types';
+
+export const DAY_MS = 86400000;
+
+/**
+ * Days since 1970-01-01 (UTC) for a YYYY-MM-DD date (time part ignored)
+ */
+export function toEpochDay(date: string): number {
+  return Math.floor(Date.parse(date.slice(0, 10)) / DAY_MS);
+}
+
+/**
+ * YYYY-MM-DD for days since 1970-01-01
+ */
+export function fromEpochDay(day: number): string {
+  return new Date(day * DAY_MS).toISOString().slice(0, 10);
+}
+
+/**
+ * The current UTC day, as days since 1970-01-01
+ */
+export function today(): number {
+  return Math.floor(Date.now() / DAY_MS);
+}
+
+export function allocateColumns(rows: number): OHLCVColumns {
+  return {
+    date: new Int32Array(rows),
+    open: new Float64Array(rows),
+    high: new Float64Array(rows),
+    low: new Float64Array(rows),
+    close: new Float64Array(rows),
+    volume: new Float64Array(rows),
+  };
+}
+
+/**
+ * Copy of rows [begin, end)
+ */
+export function sliceColumns(columns: OHLCVColumns, begin: number, end?: number): OHLCVColumns {
+  return {
+    date: columns.date.slice(begin, end),
+    open: columns.open.slice(begin, end),
+    high: columns.high.slice(begin, end),
+    low: columns.low.slice(begin, end),
+    close: columns.close.slice(begin, end),
+    volume: columns.volume.slice(begin, end),
+  };
+}
+
+/**
+ * Rows of `a` followed by those of `b` (either is returned as is if the
+ * other is empty)
+ */
+export function concatColumns(a: OHLCVColumns, b: OHLCVColumns): OHLCVColumns {
+  if (b.date.length === 0) return a;
+  if (a.date.length === 0) return b;
+
+  const joined = allocateColumns(a.date.length + b.date.length);
+  for (const name of Object.keys(joined) as (keyof OHLCVColumns)[]) {
+    joined[name].set(a[name]);
+    joined[name].set(b[name], a[name].length);
+  }
+  return joined;
+}
+
+/**
+ * Index of the first row dated after `day` (dates are ascending)
+ */
+export function rowsThrough(dates: Int32Array, day: number): number {
+  let lo = 0;
+  let hi = dates.length;
+  while (lo < hi) {
+    const mid = (lo + hi) >>> 1;
+    if (dates[mid] <= day) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * Columns as rows, for JSON responses
+ */
+export function toRows(columns: OHLCVColumns): OHLCVData[] {
+  const rows: OHLCVData[] = new Array(columns.date.length);
+  for (let i = 0; i < rows.length; i++) {
+    rows[i] = {
+      date: fromEpochDay(columns.date[i]),
+      open: columns.open[i],
+      high: columns.high[i],
+      low: columns.low[i],
+      close: columns.close[i],
+      volume: columns.volume[i],
+    };
+  }
+  return rows;
+}
+
+// JSON form of OHLCVColumns (typed arrays do not survive JSON.stringify)
+export type SerializedColumns = Record<keyof OHLCVColumns, number[]>;
+
+export function serializeColumns(columns: OHLCVColumns): SerializedColumns {
+  return {
+    date: Array.from(columns.date),
+    open: Array.from(columns.open),
+    high: Array.from(columns.high),
+    low: Array.from(columns.low),
+    close: Array.from(columns.close),
+    volume: Array.from(columns.volume),
+  };
+}
+
+/**
+ * Columns from their JSON form; null if `value` is not one
+ */
+export function deserializeColumns(value: unknown): OHLCVColumns | null {
+  const serialized = value as Partial<SerializedColumns> | null;
+  if (!serialized || !Array.isArray(serialized.date)) return null;
+
+  const rows = serialized.date.length;
+  const columns = allocateColumns(rows);
+  for (const name of Object.keys(columns) as (keyof OHLCVColumns)[]) {
+    const values = serialized[name];
+    if (!Array.isArray(values) || values.length !== rows) return null;
+    columns[name].set(values);
+  }
+  return columns;
+}
@@ -0,0 +1,662 @@
+/**
+ * Benchmark suite for Dynamic Stock Analyzer C modules.
+ *
+ * Times stock span, fused series analysis, segment tree build, tree
+ * queries (random and batch) and sliding windows over a range of input
+ * sizes. Prices are a seeded random walk generated in memory, so runs are
+ * repeatable and need no data files.
+ *
+ * Every case runs in its own child process, so the reported peak RSS
+ * belongs to that case alone (input included). A case is repeated until
+ * it has been timed for --min-time in total (at least 5 repetitions);
+ * p50/p99 are over repetitions and ns/element and ops/sec come from p50.
+ *
+ * Usage:
+ *   ./bench/bench [options]
+ *
+ * Options:
+ *   --sizes N,N,...    Input sizes (default 1000,10000,100000,1000000,10000000)
+ *   --windows W,W,...  Sliding window sizes (default 10,50,200)
+ *   --queries Q        Tree queries per repetition (default 100000)
+ *   --filter TEXT      Only cases whose name contains TEXT
+ *   --isa NAME         Kernel variant to use (see cpu_dispatch.h)
+ *   --min-time MS      Timed milliseconds per case (default 200)
+ *   --quick            Sizes up to 1M and 50 ms per case
+ *   --out FILE         Write JSON results to FILE (default: stdout)
+ *   --baseline FILE    Compare ns/element with the JSON of an earlier run
+ *   --threshold PCT    Slowdown that counts as a regression (default 10)
+ *
+ * Output: one JSON object; "results" holds one case per line:
+ *   {"name": "window", "n": 1000000, "param": 50, "reps": 41,
+ *    "p50_ns": ..., "p99_ns": ..., "ns_per_elem": ..., "ops_per_sec": ...,
+ *    "peak_rss_kb": ...}
+ * `param` is the window size, or the queries per repetition for tree
+ * queries (0 otherwise). ops_per_sec counts elements, or queries for the
+ * tree query cases. Progress and a summary table go to stderr.
+ *
+ * Exit status: 0 on success, 1 if a case failed or the arguments are
+ * invalid, 2 if --baseline found a regression.
+ *
+ * POSIX only (fork/wait4).
+ */
+
+#define _DEFAULT_SOURCE
+#define _DARWIN_C_SOURCE
+
+#include "stock_span.h"
+#include "segment_tree.h"
+#include "sliding_window.h"
+#include "series_analysis.h"
+#include "cpu_dispatch.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_SIZES 16
+#define MAX_WINDOWS 16
+#define MIN_REPS 5
+#define MAX_REPS 10000
+#define BATCH_QUERY_WIDTH 250  // About one trading year per range
+#define SEED 0x5DEECE66DULL
+#define ERR_BUF_SIZE 256
+
+typedef enum {
+    CASE_SPAN = 0,
+    CASE_SERIES,
+    CASE_TREE_BUILD,
+    CASE_TREE_RANDOM,
+    CASE_TREE_BATCH,
+    CASE_WINDOW,
+    CASE_KIND_COUNT
+} CaseKind;
+
+static const char *const CASE_NAMES[CASE_KIND_COUNT] = {
+    "span", "series", "tree_build", "tree_query_random", "tree_query_batch", "window",
+};
+
+typedef struct {
+    CaseKind kind;
+    size_t n;
+    size_t param;
+} BenchCase;
+
+// Written by the child process through a pipe
+typedef struct {
+    int error;                  // 0, or the libdsa error code
+    size_t reps;
+    size_t items;               // Elements or queries per repetition
+    double p50_ns;
+    double p99_ns;
+    char message[ERR_BUF_SIZE];
+} CaseTiming;
+
+typedef struct {
+    size_t sizes[MAX_SIZES];
+    size_t num_sizes;
+    size_t windows[MAX_WINDOWS];
+    size_t num_windows;
+    size_t queries;
+    const char *filter;
+    const char *isa;
+    double min_time_ms;
+    const char *out_path;
+    const char *baseline_path;
+    double threshold_pct;
+} Options;
+
+// Keeps results observable so no call is optimized out
+static volatile double sink;
+
+static double nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// xorshift64*: fast, seeded, identical on every platform
+static uint64_t nextRandom(uint64_t *state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+static double nextUnit(uint64_t *state) {
+    return (double)(nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Random walk starting at 100 with +-1% daily moves, floored at 1
+ */
+static double *generatePrices(size_t n) {
+    double *prices = malloc(n * sizeof(double));
+    if (!prices) return NULL;
+
+    uint64_t state = SEED;
+    double price = 100.0;
+    for (size_t i = 0; i < n; i++) {
+        price *= 1.0 + (nextUnit(&state) - 0.5) * 0.02;
+        if (price < 1.0) price = 1.0;
+        prices[i] = price;
+    }
+    return prices;
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted samples
+static double percentile(const double *sorted, size_t count, double pct) {
+    size_t rank = (size_t)(pct / 100.0 * (double)count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+/**
+ * Per-case inputs built before timing starts
+ */
+typedef struct {
+    const double *prices;
+    void *tree;
+    size_t *ql;
+    size_t *qr;
+    int *spans;
+} CaseState;
+
+static int prepareCase(const BenchCase *c, CaseState *st, char *err) {
+    size_t n = c->n;
+
+    if (c->kind == CASE_SERIES) {
+        st->spans = malloc(n * sizeof(int));
+        if (!st->spans) return -3;
+    }
+
+    if (c->kind == CASE_TREE_RANDOM || c->kind == CASE_TREE_BATCH) {
+        int rc = buildSegmentTree(st->prices, n, &st->tree, err, ERR_BUF_SIZE);
+        if (rc != 0) return rc;
+
+        st->ql = malloc(c->param * sizeof(size_t));
+        st->qr = malloc(c->param * sizeof(size_t));
+        if (!st->ql || !st->qr) return -3;
+
+        uint64_t state = SEED ^ n;
+        size_t width = n < BATCH_QUERY_WIDTH ? n : BATCH_QUERY_WIDTH;
+        for (size_t i = 0; i < c->param; i++) {
+            if (c->kind == CASE_TREE_RANDOM) {
+                size_t a = (size_t)(nextRandom(&state) % n);
+                size_t b = (size_t)(nextRandom(&state) % n);
+                st->ql[i] = a < b ? a : b;
+                st->qr[i] = a < b ? b : a;
+            } else {
+                // Ascending fixed-width ranges, as batch jobs submit them
+                st->ql[i] = (size_t)((double)i * (double)(n - width) / (double)c->param);
+                st->qr[i] = st->ql[i] + width - 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void releaseCase(CaseState *st) {
+    freeSegmentTree(st->tree);
+    free(st->ql);
+    free(st->qr);
+    free(st->spans);
+}
+
+/**
+ * One timed repetition; outputs the library allocates are freed untimed
+ */
+static int runOnce(const BenchCase *c, CaseState *st, double *out_ns, char *err) {
+    size_t n = c->n;
+    int rc = 0;
+    double start = nowNs();
+
+    switch (c->kind) {
+        case CASE_SPAN: {
+            int *spans = NULL;
+            rc = calculateStockSpan(st->prices, n, &spans, err, ERR_BUF_SIZE);
+            *out_ns = nowNs() - start;
+            if (rc == 0) sink = spans[n - 1];
+            free(spans);
+            return rc;
+        }
+
+        case CASE_SERIES: {
+            SeriesStats stats;
+            rc = analyzeSeries(st->prices, n, 0, st->spans, &stats, NULL, NULL, NULL, NULL,
+                               err, ERR_BUF_SIZE);
+            *out_ns = nowNs() - start;
+            sink = stats.avg;
+            return rc;
+        }
+
+        case CASE_TREE_BUILD: {
+            void *tree = NULL;
+            rc = buildSegmentTree(st->prices, n, &tree, err, ERR_BUF_SIZE);
+            *out_ns = nowNs() - start;
+            freeSegmentTree(tree);
+            return rc;
+        }
+
+        case CASE_TREE_RANDOM:
+        case CASE_TREE_BATCH: {
+            double acc = 0.0;
+            for (size_t i = 0; i < c->param && rc == 0; i++) {
+                double min, max, avg;
+                rc = querySegmentTree(st->tree, st->ql[i], st->qr[i], &min, &max, &avg, NULL,
+                                      err, ERR_BUF_SIZE);
+                acc += max - min + avg;
+            }
+            *out_ns = nowNs() - start;
+            sink = acc;
+            return rc;
+        }
+
+        case CASE_WINDOW: {
+            void *result = NULL;
+            rc = analyzeSlidingWindow(st->prices, n, c->param, &result, err, ERR_BUF_SIZE);
+            *out_ns = nowNs() - start;
+            sink = (double)getWindowResultCount(result);
+            freeWindowResult(result);
+            return rc;
+        }
+
+        default:
+            *out_ns = 0;
+            return -2;
+    }
+}
+
+/**
+ * Run one case to completion (in the child process)
+ */
+static void timeCase(const BenchCase *c, double min_time_ms, CaseTiming *out) {
+    memset(out, 0, sizeof(*out));
+    out->items = (c->kind == CASE_TREE_RANDOM || c->kind == CASE_TREE_BATCH) ? c->param : c->n;
+
+    double *samples = malloc(MAX_REPS * sizeof(double));
+    double *prices = generatePrices(c->n);
+    CaseState st;
+    memset(&st, 0, sizeof(st));
+    st.prices = prices;
+
+    if (!samples || !prices) {
+        out->error = -3;
+        snprintf(out->message, sizeof(out->message), "Memory allocation failed");
+    } else {
+        out->error = prepareCase(c, &st, out->message);
+        if (out->error == -3 && !out->message[0]) {
+            snprintf(out->message, sizeof(out->message), "Memory allocation failed");
+        }
+    }
+
+    double total = 0.0;
+    while (out->error == 0 && out->reps < MAX_REPS &&
+           (out->reps < MIN_REPS || total < min_time_ms * 1e6)) {
+        double ns = 0.0;
+        out->error = runOnce(c, &st, &ns, out->message);
+        samples[out->reps++] = ns;
+        total += ns;
+    }
+
+    if (out->error == 0) {
+        qsort(samples, out->reps, sizeof(double), compareDoubles);
+        out->p50_ns = percentile(samples, out->reps, 50.0);
+        out->p99_ns = percentile(samples, out->reps, 99.0);
+    }
+
+    releaseCase(&st);
+    free(prices);
+    free(samples);
+}
+
+/**
+ * Run a case in a child process; returns its peak RSS in KB (or -1)
+ */
+static long runIsolated(const BenchCase *c, double min_time_ms, CaseTiming *out) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        memset(out, 0, sizeof(*out));
+        out->error = -5;
+        snprintf(out->message, sizeof(out->message), "pipe: %s", strerror(errno));
+        return -1;
+    }
+
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        CaseTiming timing;
+        timeCase(c, min_time_ms, &timing);
+        ssize_t written = write(fds[1], &timing, sizeof(timing));
+        _exit(written == (ssize_t)sizeof(timing) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    memset(out, 0, sizeof(*out));
+    if (pid < 0) {
+        close(fds[0]);
+        out->error = -5;
+        snprintf(out->message, sizeof(out->message), "fork: %s", strerror(errno));
+        return -1;
+    }
+
+    size_t got = 0;
+    while (got < sizeof(*out)) {
+        ssize_t r = read(fds[0], (char *)out + got, sizeof(*out) - got);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) break;
+        got += (size_t)r;
+    }
+    close(fds[0]);
+
+    int status = 0;
+    struct rusage usage;
+    memset(&usage, 0, sizeof(usage));
+    while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {
+    }
+
+    if (got != sizeof(*out)) {
+        memset(out, 0, sizeof(*out));
+        out->error = -5;
+        snprintf(out->message, sizeof(out->message), "Case process died (status %d)", status);
+    }
+
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;  // Bytes on macOS
+#else
+    return usage.ru_maxrss;         // Kilobytes on Linux and the BSDs
+#endif
+}
+
+static int parseSizeList(const char *text, size_t *out, size_t max, size_t *out_count) {
+    size_t count = 0;
+    const char *p = text;
+    while (*p) {
+        char *end;
+        errno = 0;
+        unsigned long long value = strtoull(p, &end, 10);
+        if (end == p || errno != 0 || value == 0 || count == max) return -1;
+        out[count++] = (size_t)value;
+        p = end;
+        if (*p == ',') p++;
+        else if (*p) return -1;
+    }
+    *out_count = count;
+    return count > 0 ? 0 : -1;
+}
+
+static void printUsage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [--sizes N,...] [--windows W,...] [--queries Q] [--filter TEXT]\n"
+            "          [--isa NAME] [--min-time MS] [--quick] [--out FILE]\n"
+            "          [--baseline FILE] [--threshold PCT]\n",
+            prog);
+}
+
+static int parseOptions(int argc, char **argv, Options *opts) {
+    static const size_t default_sizes[] = {1000, 10000, 100000, 1000000, 10000000};
+    static const size_t default_windows[] = {10, 50, 200};
+
+    memset(opts, 0, sizeof(*opts));
+    memcpy(opts->sizes, default_sizes, sizeof(default_sizes));
+    opts->num_sizes = sizeof(default_sizes) / sizeof(default_sizes[0]);
+    memcpy(opts->windows, default_windows, sizeof(default_windows));
+    opts->num_windows = sizeof(default_windows) / sizeof(default_windows[0]);
+    opts->queries = 100000;
+    opts->min_time_ms = 200.0;
+    opts->threshold_pct = 10.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--quick") == 0) {
+            opts->num_sizes = 4;  // Up to 1M
+            opts->min_time_ms = 50.0;
+            continue;
+        }
+        if (!value) {
+            fprintf(stderr, "ERROR: Unknown option or missing value: %s\n", arg);
+            return -1;
+        }
+        i++;
+
+        int ok = 1;
+        if (strcmp(arg, "--sizes") == 0) {
+            ok = parseSizeList(value, opts->sizes, MAX_SIZES, &opts->num_sizes) == 0;
+        } else if (strcmp(arg, "--windows") == 0) {
+            ok = parseSizeList(value, opts->windows, MAX_WINDOWS, &opts->num_windows) == 0;
+        } else if (strcmp(arg, "--queries") == 0) {
+            size_t count;
+            ok = parseSizeList(value, &opts->queries, 1, &count) == 0;
+        } else if (strcmp(arg, "--filter") == 0) {
+            opts->filter = value;
+        } else if (strcmp(arg, "--isa") == 0) {
+            opts->isa = value;
+        } else if (strcmp(arg, "--min-time") == 0) {
+            opts->min_time_ms = strtod(value, NULL);
+            ok = opts->min_time_ms > 0;
+        } else if (strcmp(arg, "--out") == 0) {
+            opts->out_path = value;
+        } else if (strcmp(arg, "--baseline") == 0) {
+            opts->baseline_path = value;
+        } else if (strcmp(arg, "--threshold") == 0) {
+            opts->threshold_pct = strtod(value, NULL);
+            ok = opts->threshold_pct >= 0;
+        } else {
+            fprintf(stderr, "ERROR: Unknown option: %s\n", arg);
+            return -1;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "ERROR: Invalid value for %s: %s\n", arg, value);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Every case for the options, in output order
+ */
+static size_t buildCases(const Options *opts, BenchCase *cases, size_t max) {
+    size_t count = 0;
+    for (int kind = 0; kind < CASE_KIND_COUNT; kind++) {
+        if (opts->filter && !strstr(CASE_NAMES[kind], opts->filter)) continue;
+
+        for (size_t s = 0; s < opts->num_sizes; s++) {
+            size_t n = opts->sizes[s];
+            if (kind == CASE_WINDOW) {
+                for (size_t w = 0; w < opts->num_windows; w++) {
+                    if (opts->windows[w] > n || count == max) continue;
+                    cases[count++] = (BenchCase){CASE_WINDOW, n, opts->windows[w]};
+                }
+            } else if (count < max) {
+                size_t param = (kind == CASE_TREE_RANDOM || kind == CASE_TREE_BATCH)
+                                   ? opts->queries : 0;
+                cases[count++] = (BenchCase){(CaseKind)kind, n, param};
+            }
+        }
+    }
+    return count;
+}
+
+// ---- Baseline comparison ----
+
+typedef struct {
+    char name[32];
+    size_t n;
+    size_t param;
+    double ns_per_elem;
+} BaselineEntry;
+
+/**
+ * Read the result lines of an earlier run's JSON output
+ */
+static size_t readBaseline(const char *path, BaselineEntry **out_entries) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "ERROR: Cannot open baseline: %s\n", path);
+        return 0;
+    }
+
+    BaselineEntry *entries = NULL;
+    size_t count = 0, cap = 0;
+    char line[1024];
+    while (fgets(line, sizeof(line), fp)) {
+        const char *name = strstr(line, "\"name\": \"");
+        const char *n = strstr(line, "\"n\": ");
+        const char *param = strstr(line, "\"param\": ");
+        const char *nspe = strstr(line, "\"ns_per_elem\": ");
+        if (!name || !n || !param || !nspe) continue;
+
+        if (count == cap) {
+            cap = cap ? cap * 2 : 64;
+            BaselineEntry *grown = realloc(entries, cap * sizeof(BaselineEntry));
+            if (!grown) break;
+            entries = grown;
+        }
+        BaselineEntry *e = &entries[count];
+        if (sscanf(name, "\"name\": \"%31[^\"]\"", e->name) != 1) continue;
+        e->n = (size_t)strtoull(n + 5, NULL, 10);
+        e->param = (size_t)strtoull(param + 9, NULL, 10);
+        e->ns_per_elem = strtod(nspe + 15, NULL);
+        count++;
+    }
+    fclose(fp);
+
+    *out_entries = entries;
+    return count;
+}
+
+static const BaselineEntry *findBaseline(const BaselineEntry *entries, size_t count,
+                                         const BenchCase *c) {
+    for (size_t i = 0; i < count; i++) {
+        if (entries[i].n == c->n && entries[i].param == c->param &&
+            strcmp(entries[i].name, CASE_NAMES[c->kind]) == 0) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    Options opts;
+    if (parseOptions(argc, argv, &opts) != 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (opts.isa && setActiveIsa(opts.isa) != 0) {
+        fprintf(stderr, "ERROR: Kernel variant not supported here: %s\n", opts.isa);
+        return 1;
+    }
+
+    BaselineEntry *baseline = NULL;
+    size_t baseline_count = 0;
+    if (opts.baseline_path) {
+        baseline_count = readBaseline(opts.baseline_path, &baseline);
+        if (baseline_count == 0) {
+            fprintf(stderr, "ERROR: No results found in baseline: %s\n", opts.baseline_path);
+            return 1;
+        }
+    }
+
+    size_t max_cases = CASE_KIND_COUNT * MAX_SIZES * MAX_WINDOWS;
+    BenchCase *cases = malloc(max_cases * sizeof(BenchCase));
+    if (!cases) {
+        fprintf(stderr, "ERROR: Memory allocation failed\n");
+        return 1;
+    }
+    size_t num_cases = buildCases(&opts, cases, max_cases);
+
+    FILE *out = stdout;
+    if (opts.out_path) {
+        out = fopen(opts.out_path, "w");
+        if (!out) {
+            fprintf(stderr, "ERROR: Cannot write %s\n", opts.out_path);
+            free(cases);
+            return 1;
+        }
+    }
+
+    fprintf(stderr, "Dynamic Stock Analyzer - Benchmarks (%s kernels, %zu cases)\n",
+            getActiveIsa(), num_cases);
+    fprintf(stderr, "%-18s %10s %6s %10s %12s %11s %11s %9s", "case", "n", "param",
+            "ns/elem", "ops/sec", "p50", "p99", "rss");
+    fprintf(stderr, baseline ? " %8s\n" : "\n", "vs base");
+
+    fprintf(out, "{\n  \"isa\": \"%s\",\n  \"min_time_ms\": %.0f,\n  \"results\": [\n",
+            getActiveIsa(), opts.min_time_ms);
+
+    int failures = 0, regressions = 0;
+    size_t written = 0;
+    for (size_t i = 0; i < num_cases; i++) {
+        const BenchCase *c = &cases[i];
+        CaseTiming t;
+        long rss_kb = runIsolated(c, opts.min_time_ms, &t);
+
+        if (t.error != 0) {
+            fprintf(stderr, "%-18s %10zu %6zu  FAILED (%d): %s\n", CASE_NAMES[c->kind], c->n,
+                    c->param, t.error, t.message);
+            failures++;
+            continue;
+        }
+
+        double ns_per_elem = t.p50_ns / (double)t.items;
+        double ops_per_sec = (double)t.items / t.p50_ns * 1e9;
+
+        fprintf(stderr, "%-18s %10zu %6zu %10.3f %12.4g %9.3fms %9.3fms %7ldMB",
+                CASE_NAMES[c->kind], c->n, c->param, ns_per_elem, ops_per_sec,
+                t.p50_ns / 1e6, t.p99_ns / 1e6, rss_kb / 1024);
+        if (baseline) {
+            const BaselineEntry *base = findBaseline(baseline, baseline_count, c);
+            if (!base || base->ns_per_elem <= 0) {
+                fprintf(stderr, " %8s", "new");
+            } else {
+                double change = (ns_per_elem / base->ns_per_elem - 1.0) * 100.0;
+                int regressed = change > opts.threshold_pct;
+                regressions += regressed;
+                fprintf(stderr, " %+7.1f%%%s", change, regressed ? " REGRESSION" : "");
+            }
+        }
+        fprintf(stderr, "\n");
+
+        fprintf(out,
+                "%s    {\"name\": \"%s\", \"n\": %zu, \"param\": %zu, \"reps\": %zu, "
+                "\"p50_ns\": %.1f, \"p99_ns\": %.1f, \"ns_per_elem\": %.4f, "
+                "\"ops_per_sec\": %.1f, \"peak_rss_kb\": %ld}",
+                written++ > 0 ? ",\n" : "", CASE_NAMES[c->kind], c->n, c->param,
+                t.reps, t.p50_ns, t.p99_ns, ns_per_elem, ops_per_sec, rss_kb);
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout) fclose(out);
+    free(cases);
+    free(baseline);
+
+    if (failures > 0) {
+        fprintf(stderr, "\n%d case(s) failed\n", failures);
+        return 1;
+    }
+    if (regressions > 0) {
+        fprintf(stderr, "\n%d case(s) slower than baseline by more than %.0f%%\n",
+                regressions, opts.threshold_pct);
+        return 2;
+    }
+    return 0;
+}
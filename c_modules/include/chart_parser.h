@@ -0,0 +1,97 @@
+#ifndef CHART_PARSER_H
+#define CHART_PARSER_H
+
+#include <stddef.h>
+
+/**
+ * Parser for Yahoo Finance v8 chart responses.
+ *
+ * Extracts chart.result[0].timestamp and the open/high/low/close/volume
+ * arrays of chart.result[0].indicators.quote[0] from the raw response
+ * bytes straight into double columns. Nothing else is materialized: other
+ * members (meta, adjclose, events, ...) are skipped without being decoded.
+ * String skipping uses SSE2 where available, and runs of eight digits are
+ * converted with one SWAR multiply sequence on little-endian targets.
+ *
+ * null entries become NaN and set the field's bit in the row's null mask
+ * (JSON numbers are never NaN, so the two always agree). A quote array
+ * shorter than the timestamp array, or missing altogether, counts as null
+ * for the remaining rows.
+ *
+ * Numbers are correctly rounded: a decimal whose digits fit in 53 bits and
+ * whose exponent is within +-22 is converted inline with one exact
+ * multiply or divide, and on x86 (not Windows) up to 19 digits go through
+ * x87 extended precision with a check for the one case where rounding
+ * twice differs. Anything else goes through strtod() (the process must
+ * use the "C" numeric locale, as Node does).
+ *
+ * Thread-safety: Safe to call from multiple threads on different inputs.
+ *
+ * Error codes (all functions returning int):
+ *   -1: NULL pointer argument
+ *   -2: More than 10,000,000 rows
+ *   -3: Memory allocation failure
+ *   -4: Malformed JSON, no chart result, or a quote array longer than the
+ *       timestamp array (message gives the byte offset)
+ */
+
+typedef enum {
+    CHART_TIMESTAMP = 0,    // Seconds since 1970-01-01 UTC
+    CHART_OPEN,
+    CHART_HIGH,
+    CHART_LOW,
+    CHART_CLOSE,
+    CHART_VOLUME,
+    CHART_FIELD_COUNT
+} ChartField;
+
+typedef struct {
+    size_t rows;
+    double *values[CHART_FIELD_COUNT];  // rows values each, NaN where null
+    unsigned char *nulls;               // Per row: bit (1 << field) if null
+} ChartColumns;
+
+/**
+ * Parse a chart response.
+ *
+ * Time complexity: O(length)
+ *
+ * @param json Response bytes (need not be NUL-terminated)
+ * @param length Number of bytes
+ * @param out_chart Receives the columns; free with freeChartColumns()
+ * @param err_buf Buffer for error messages (can be NULL)
+ * @param err_buf_len Size of error buffer
+ *
+ * @return 0 on success, -1/-2/-3/-4 on failure (*out_chart is then NULL)
+ *
+ * Example usage:
+ *   ChartColumns *chart = NULL;
+ *   char err[256];
+ *   if (parseChartColumns(body, body_len, &chart, err, sizeof(err)) == 0) {
+ *       size_t rows = compactChartRows(chart);
+ *       // ... read chart->values[CHART_CLOSE][0 .. rows) ...
+ *       freeChartColumns(chart);
+ *   }
+ */
+int parseChartColumns(const char *json, size_t length, ChartColumns **out_chart,
+                      char *err_buf, size_t err_buf_len);
+
+/**
+ * Drop rows without a timestamp or close and fill the remaining gaps in
+ * place: a null open, high or low takes the close, a null volume is 0.
+ * Null masks move with their rows, so filled values can still be told
+ * apart. This is the backend provider's row policy.
+ *
+ * Time complexity: O(rows)
+ *
+ * @param chart Parsed columns (can be NULL)
+ * @return Rows left (chart->rows is updated)
+ */
+size_t compactChartRows(ChartColumns *chart);
+
+/**
+ * Free parsed columns. Safe to call with NULL.
+ */
+void freeChartColumns(ChartColumns *chart);
+
+#endif // CHART_PARSER_H
@@ -0,0 +1,187 @@
+#ifndef COLUMN_STORE_H
+#define COLUMN_STORE_H
+
+#include <stddef.h>
+
+/**
+ * Append-only columnar store for one symbol's daily OHLCV history.
+ *
+ * A store is a directory of fixed-width column files (date, open, high,
+ * low, close, volume; one double per row), a sparse date index holding
+ * every 256th date, and a small header with the committed row count and
+ * the date range the rows are known to cover. Dates are any increasing
+ * double key (the backend uses epoch milliseconds).
+ *
+ * Reads map the column files: mapColumnRange() returns a pointer into the
+ * page cache, with no parsing or copying. Mappings are private, so a write
+ * through one (e.g. from JS) touches a copy of the page, never the file.
+ * A mapping stays valid until released, even after later appends or after
+ * the store is closed. Where mmap is unavailable (Windows), mappings fall
+ * back to a heap copy of the column.
+ *
+ * Crash safety: rows are written before the header is updated, so a torn
+ * append leaves the previous row count in effect and the stray bytes are
+ * overwritten by the next append.
+ *
+ * Thread-safety: NOT thread-safe. Serialize all calls on a store handle,
+ * and have at most one open handle per directory per process. Releasing
+ * a mapping is safe from any thread.
+ *
+ * Error codes (all functions returning int):
+ *   -1: NULL pointer argument
+ *   -2: Invalid range, length or column
+ *   -3: Memory allocation failure
+ *   -4: Invalid value (non-finite, or dates not strictly increasing)
+ *   -5: I/O error (message includes the file)
+ */
+
+typedef enum {
+    COLUMN_DATE = 0,
+    COLUMN_OPEN,
+    COLUMN_HIGH,
+    COLUMN_LOW,
+    COLUMN_CLOSE,
+    COLUMN_VOLUME,
+    COLUMN_COUNT
+} ColumnId;
+
+/**
+ * Open a store directory, creating it (but not its parents) if missing.
+ *
+ * @param dir Store directory (must not be NULL)
+ * @param out_store Receives the store handle; close with closeColumnStore()
+ * @param err_buf Buffer for error messages (can be NULL)
+ * @param err_buf_len Size of error buffer
+ *
+ * @return 0 on success, -1/-3/-5 on failure (-5 also for a corrupt header)
+ *
+ * Example usage:
+ *   void *store = NULL;
+ *   char err[256];
+ *   if (openColumnStore("cache/columns/AAPL", &store, err, sizeof(err)) == 0) {
+ *       size_t first, count;
+ *       findColumnDateRange(store, start, end, &first, &count);
+ *       const double *close;
+ *       void *mapping;
+ *       mapColumnRange(store, COLUMN_CLOSE, first, count, &close, &mapping, err, sizeof(err));
+ *       // ... read close[0 .. count) ...
+ *       releaseColumnMapping(mapping);
+ *       closeColumnStore(store);
+ *   }
+ */
+int openColumnStore(const char *dir, void **out_store, char *err_buf, size_t err_buf_len);
+
+/**
+ * Append the complete data for the date range [range_start, range_end].
+ *
+ * `columns` holds COLUMN_COUNT arrays of `rows` values, ordered by
+ * ColumnId, with dates strictly increasing. Rows dated at or before the
+ * last stored row, or after range_end, are skipped, so overlapping
+ * fetches can be appended as-is. The range must not start after the end
+ * of the stored coverage; afterwards the coverage extends to range_end.
+ * Rows cannot be prepended: the first append fixes the coverage start.
+ * The column files are synced to disk before the header that commits
+ * them is written (and synced), so the call blocks on the disk.
+ *
+ * Time complexity: O(rows)
+ *
+ * @param store Store handle (must not be NULL)
+ * @param columns COLUMN_COUNT column arrays (none NULL unless rows is 0)
+ * @param rows Number of rows in each array
+ * @param range_start First date the rows cover
+ * @param range_end Last date the rows cover (>= range_start)
+ * @param out_appended Receives the number of rows written (can be NULL)
+ * @param err_buf Buffer for error messages (can be NULL)
+ * @param err_buf_len Size of error buffer
+ *
+ * @return 0 on success, non-zero on failure:
+ *   -1: NULL store or column
+ *   -2: Invalid range, range leaves a gap after the coverage, or the
+ *       store would exceed 10,000,000 rows
+ *   -4: Non-finite value or dates not strictly increasing
+ *   -5: Write failed (the store keeps its previous contents)
+ */
+int appendColumnRows(void *store, const double *const columns[COLUMN_COUNT], size_t rows,
+                     double range_start, double range_end, size_t *out_appended,
+                     char *err_buf, size_t err_buf_len);
+
+/**
+ * Number of committed rows.
+ *
+ * @param store Store handle (can be NULL)
+ * @return Row count, or 0 for a NULL handle
+ */
+size_t getColumnStoreRows(const void *store);
+
+/**
+ * Date range the stored rows cover.
+ *
+ * @param store Store handle (can be NULL)
+ * @param out_start Receives the first covered date (can be NULL)
+ * @param out_end Receives the last covered date (can be NULL)
+ * @return 1 if the store covers a range, 0 if nothing was appended yet
+ */
+int getColumnStoreCoverage(const void *store, double *out_start, double *out_end);
+
+/**
+ * Locate the rows dated within [start_date, end_date].
+ *
+ * Binary search over the sparse index, then within one 256-row block of
+ * the mapped date column.
+ *
+ * Time complexity: O(log n)
+ *
+ * @param store Store handle (must not be NULL)
+ * @param start_date First date wanted (inclusive)
+ * @param end_date Last date wanted (inclusive)
+ * @param out_first Receives the first matching row (must not be NULL)
+ * @param out_count Receives the number of matching rows (must not be NULL)
+ * @param err_buf Buffer for error messages (can be NULL)
+ * @param err_buf_len Size of error buffer
+ *
+ * @return 0 on success (count 0 if nothing matches), -1/-3/-5 on failure
+ */
+int findColumnDateRange(void *store, double start_date, double end_date,
+                        size_t *out_first, size_t *out_count,
+                        char *err_buf, size_t err_buf_len);
+
+/**
+ * Map rows [first, first + count) of one column.
+ *
+ * Time complexity: O(1) (O(n) when a mapping must be extended after an
+ * append, or on the heap-copy fallback)
+ *
+ * @param store Store handle (must not be NULL)
+ * @param column Column to map
+ * @param first First row
+ * @param count Number of rows (0 yields NULL values and a NULL mapping)
+ * @param out_values Receives a read-only pointer to the first row
+ * @param out_mapping Receives a mapping reference; release it with
+ *                    releaseColumnMapping() when done with the values
+ * @param err_buf Buffer for error messages (can be NULL)
+ * @param err_buf_len Size of error buffer
+ *
+ * @return 0 on success, non-zero on failure:
+ *   -1: NULL pointer argument
+ *   -2: Invalid column or rows out of range
+ *   -3: Memory allocation failure
+ *   -5: Mapping failed
+ */
+int mapColumnRange(void *store, ColumnId column, size_t first, size_t count,
+                   const double **out_values, void **out_mapping,
+                   char *err_buf, size_t err_buf_len);
+
+/**
+ * Release a mapping reference from mapColumnRange().
+ *
+ * Thread-safety: Safe to call from any thread. Safe to call with NULL.
+ */
+void releaseColumnMapping(void *mapping);
+
+/**
+ * Close a store. Mappings still held stay valid until released.
+ * Safe to call with NULL handle.
+ */
+void closeColumnStore(void *store);
+
+#endif // COLUMN_STORE_H
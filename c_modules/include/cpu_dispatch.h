@@ -0,0 +1,55 @@
+#ifndef CPU_DISPATCH_H
+#define CPU_DISPATCH_H
+
+/**
+ * Runtime selection of the SIMD kernels behind the analysis functions.
+ *
+ * The hot loops (price validation, stock span, segment tree build, sliding
+ * window scan) are compiled once per instruction set. On x86-64 the library
+ * carries "sse2" (baseline), "avx2" and "avx512" builds; elsewhere it
+ * carries a single "generic" build. When libdsa is loaded the best variant
+ * the CPU and OS support is selected, once. All variants produce
+ * bit-identical results, so the choice only affects speed.
+ *
+ * Environment:
+ *   DSA_ISA=<name>  Use the named variant instead of the best one, if it is
+ *                   supported (e.g. DSA_ISA=sse2 to compare against the
+ *                   baseline). Unknown or unsupported names are ignored.
+ */
+
+/**
+ * Name of the kernel variant in use.
+ *
+ * Thread-safety: Safe to call from multiple threads.
+ *
+ * @return Static string: "avx512", "avx2", "sse2" or "generic". Never NULL.
+ *
+ * Example usage:
+ *   printf("libdsa kernels: %s\n", getActiveIsa());
+ */
+const char *getActiveIsa(void);
+
+/**
+ * Check whether a kernel variant is built in and runs on this CPU.
+ *
+ * @param isa Variant name as returned by getActiveIsa()
+ *
+ * @return 1 if supported, 0 otherwise (including NULL or unknown names)
+ */
+int isIsaSupported(const char *isa);
+
+/**
+ * Switch to another kernel variant.
+ *
+ * Intended for tests and benchmarks that compare variants. Not synchronized
+ * with running analyses: call it before starting work, not concurrently.
+ *
+ * @param isa Variant name; must satisfy isIsaSupported()
+ *
+ * @return 0 on success, non-zero error code on failure:
+ *   -1: NULL name
+ *   -2: Unknown or unsupported variant (the active variant is unchanged)
+ */
+int setActiveIsa(const char *isa);
+
+#endif // CPU_DISPATCH_H
@@ -0,0 +1,129 @@
+#ifndef DSA_STATS_H
+#define DSA_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Per-function call statistics for libdsa.
+ *
+ * When enabled, every analysis entry point counts its calls, failures,
+ * input elements and the bytes it hands back to the caller, and records
+ * its latency in a log-linear histogram. Counters are process-wide and
+ * updated with relaxed atomic adds, so any number of threads may run
+ * analyses while statistics are read.
+ *
+ * Collection is off by default. While off, an entry point pays one
+ * relaxed atomic load and reads no clock.
+ *
+ * Float32 variants count under the same function as their double
+ * counterparts. Calls made by libdsa itself (e.g. price validation inside
+ * calculateStockSpan) are not counted separately.
+ *
+ * Environment:
+ *   DSA_STATS=1  Enable collection when the library is loaded (GCC/Clang
+ *                builds; elsewhere call setDsaStatsEnabled).
+ */
+
+/**
+ * Instrumented entry points
+ */
+typedef enum {
+    DSA_STAT_STOCK_SPAN = 0,      // calculateStockSpan[F32]; elements = prices
+    DSA_STAT_TREE_BUILD = 1,      // buildSegmentTree[F32]; elements = prices
+    DSA_STAT_TREE_QUERY = 2,      // querySegmentTree; elements = range length
+    DSA_STAT_SLIDING_WINDOW = 3,  // analyzeSlidingWindow[F32]; elements = prices
+    DSA_STAT_SERIES = 4,          // analyzeSeries; elements = prices
+    DSA_STAT_CHART_PARSE = 5,     // parseChartColumns; elements = input bytes
+    DSA_STAT_COLUMN_APPEND = 6,   // appendColumnRows; elements = rows
+    DSA_STAT_COLUMN_MAP = 7,      // mapColumnRange; elements = rows
+    DSA_STAT_COUNT = 8
+} DsaStatFunction;
+
+/**
+ * Latency histogram layout: bucket 0 holds calls under 64 ns, then each
+ * power of two up to 2^37 ns (~137 s) is split into 4 equal buckets
+ * (at most 25% wide), and the last bucket holds everything slower.
+ */
+#define DSA_STAT_BUCKETS 126
+
+/**
+ * Counters for one entry point (since load or the last reset)
+ */
+typedef struct {
+    uint64_t calls;
+    uint64_t errors;           // Calls that returned a non-zero error code
+    uint64_t elements;         // Sum of input sizes (see DsaStatFunction)
+    uint64_t bytes_allocated;  // Memory returned to callers by successful calls
+    uint64_t total_ns;         // Sum of call latencies
+    uint64_t histogram[DSA_STAT_BUCKETS];
+} DsaFunctionStats;
+
+typedef struct {
+    int enabled;
+    DsaFunctionStats functions[DSA_STAT_COUNT];
+} DsaStats;
+
+/**
+ * Turn collection on or off. Counters are kept while off.
+ *
+ * Thread-safety: Safe to call at any time; calls already running when
+ * collection is switched on are not counted.
+ *
+ * @param enabled Non-zero to collect
+ */
+void setDsaStatsEnabled(int enabled);
+
+/**
+ * @return 1 if collection is on, 0 otherwise
+ */
+int isDsaStatsEnabled(void);
+
+/**
+ * Copy every counter into `out`.
+ *
+ * Counters are read one by one while calls may still be recording, so a
+ * function's fields can disagree by the calls that were in flight.
+ *
+ * Time complexity: O(DSA_STAT_COUNT * DSA_STAT_BUCKETS)
+ *
+ * @param out Receives the statistics (must not be NULL)
+ *
+ * @return 0 on success, -1 if out is NULL
+ *
+ * Example usage:
+ *   DsaStats stats;
+ *   setDsaStatsEnabled(1);
+ *   // ... run analyses ...
+ *   getDsaStats(&stats);
+ *   const DsaFunctionStats *span = &stats.functions[DSA_STAT_STOCK_SPAN];
+ *   printf("%s: %llu calls, %.1f us avg\n", getDsaStatName(DSA_STAT_STOCK_SPAN),
+ *          (unsigned long long)span->calls,
+ *          span->calls ? span->total_ns / 1e3 / span->calls : 0.0);
+ */
+int getDsaStats(DsaStats *out);
+
+/**
+ * Zero every counter.
+ *
+ * Thread-safety: Safe to call at any time; calls in flight may be counted
+ * before or after the reset.
+ */
+void resetDsaStats(void);
+
+/**
+ * Name of an instrumented function, e.g. "stock_span".
+ *
+ * @return Static string, or NULL if fn is out of range
+ */
+const char *getDsaStatName(int fn);
+
+/**
+ * Exclusive upper bound of a histogram bucket in nanoseconds.
+ *
+ * @return Bound of bucket `bucket`; UINT64_MAX for the last bucket and
+ *         for out-of-range indices
+ */
+uint64_t getDsaStatBucketBound(size_t bucket);
+
+#endif // DSA_STATS_H
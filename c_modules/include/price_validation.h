@@ -0,0 +1,42 @@
+#ifndef PRICE_VALIDATION_H
+#define PRICE_VALIDATION_H
+
+#include <stddef.h>
+
+/**
+ * Check that every price is finite (not NaN or infinite).
+ * 
+ * Shared input check for all analysis functions. Scans fixed-size blocks
+ * with no data-dependent branches inside a block, so compilers vectorize it
+ * at -O3 (SSE2/AVX2/NEON); a block containing a bad value is rescanned to
+ * find its first index. Relies on IEEE-754 semantics: do not build with
+ * -ffast-math.
+ * 
+ * Time complexity: O(n)
+ * Thread-safety: Reentrant. Safe to call from multiple threads.
+ * 
+ * @param prices Input array of stock prices (must not be NULL unless length is 0)
+ * @param length Number of elements in prices array
+ * @param out_bad_index Receives the index of the first non-finite price on
+ *                      failure (can be NULL)
+ * 
+ * @return 0 if all prices are finite, non-zero error code otherwise:
+ *   -1: NULL prices with non-zero length
+ *   -4: Invalid price value (NaN or infinite)
+ * 
+ * Example usage:
+ *   size_t bad;
+ *   if (validatePrices(prices, n, &bad) == -4) {
+ *       fprintf(stderr, "price %zu is not finite\n", bad);
+ *   }
+ */
+int validatePrices(const double *prices, size_t length, size_t *out_bad_index);
+
+/**
+ * Check that every float32 price is finite.
+ * 
+ * Same contract and return codes as validatePrices().
+ */
+int validatePricesF32(const float *prices, size_t length, size_t *out_bad_index);
+
+#endif // PRICE_VALIDATION_H
@@ -43,6 +43,17 @@
 int buildSegmentTree(const double *prices, size_t length, void **out_tree_handle,
                      char *err_buf, size_t err_buf_len);
 
+/**
+ * Build a segment tree from float32 prices.
+ * 
+ * Same contract and error codes as buildSegmentTree(). Nodes store min/max
+ * as float and sums in double (32 bytes per node instead of 40); query
+ * results equal buildSegmentTree() on the same values widened to double.
+ * The handle works with every other segment tree function.
+ */
+int buildSegmentTreeF32(const float *prices, size_t length, void **out_tree_handle,
+                        char *err_buf, size_t err_buf_len);
+
 /**
  * Query segment tree for range statistics.
  * 
@@ -71,6 +82,28 @@ int querySegmentTree(void *tree_handle, size_t ql, size_t qr,
                      double *out_min, double *out_max, double *out_avg,
                      double *out_variance, char *err_buf, size_t err_buf_len);
 
+/**
+ * Get the number of price elements a tree was built over.
+ * 
+ * Time complexity: O(1)
+ * Thread-safety: Safe for concurrent calls if tree is not being freed.
+ * 
+ * @param tree_handle Tree handle from buildSegmentTree (can be NULL)
+ * @return Element count, or 0 for a NULL handle
+ */
+size_t getSegmentTreeLength(const void *tree_handle);
+
+/**
+ * Get the native memory held by a tree, in bytes.
+ * 
+ * Used by language bindings to report external memory to their garbage
+ * collector. Time complexity: O(1)
+ * 
+ * @param tree_handle Tree handle from buildSegmentTree (can be NULL)
+ * @return Bytes allocated for the tree, or 0 for a NULL handle
+ */
+size_t getSegmentTreeMemoryUsage(const void *tree_handle);
+
 /**
  * Free segment tree resources.
  * 
@@ -0,0 +1,70 @@
+#ifndef SERIES_ANALYSIS_H
+#define SERIES_ANALYSIS_H
+
+#include <stddef.h>
+
+/**
+ * Whole-series statistics (population variance, as in querySegmentTree)
+ */
+typedef struct {
+    double min;
+    double max;
+    double avg;
+    double variance;
+} SeriesStats;
+
+/**
+ * Fused per-series analysis: stock span, whole-series statistics and
+ * optional sliding windows in a single pass over the prices.
+ * 
+ * Equivalent to calling calculateStockSpan, querySegmentTree(0, length-1)
+ * on a freshly built tree and analyzeSlidingWindow followed by
+ * copyWindowResults, but validates the input once, reads each price once
+ * and builds no tree. The span stack and both window deques share one
+ * scratch allocation.
+ * 
+ * Window results are bit-identical to analyzeSlidingWindow. Statistics
+ * match querySegmentTree up to floating-point summation order.
+ * 
+ * Time complexity: O(n)
+ * Space complexity: O(n + windowSize) scratch, freed before returning
+ * 
+ * Memory ownership: All outputs are caller-allocated. Nothing to free.
+ * Thread-safety: Reentrant. Safe to call from multiple threads.
+ * 
+ * @param prices Input array of stock prices (must not be NULL)
+ * @param length Number of elements in prices array (must be > 0)
+ * @param windowSize Window size for the window outputs (0 = skip windows;
+ *                   otherwise must be <= length)
+ * @param out_spans Array of length elements for spans (can be NULL to skip)
+ * @param out_stats Receives whole-series statistics (can be NULL to skip)
+ * @param out_win_max Array of (length - windowSize + 1) window maxima (can be NULL)
+ * @param out_win_min Array of (length - windowSize + 1) window minima (can be NULL)
+ * @param out_win_avg Array of (length - windowSize + 1) window averages (can be NULL)
+ * @param out_win_pattern Array of (length - windowSize + 1) WindowPattern codes (can be NULL)
+ * @param err_buf Buffer for error messages (can be NULL)
+ * @param err_buf_len Size of error buffer
+ * 
+ * @return 0 on success, non-zero error code on failure:
+ *   -1: NULL prices
+ *   -2: Invalid length or window size
+ *   -3: Memory allocation failure
+ *   -4: Invalid price value (NaN or infinite)
+ * 
+ * Example usage:
+ *   SeriesStats stats;
+ *   int *spans = malloc(n * sizeof(int));
+ *   char err[256];
+ *   if (analyzeSeries(prices, n, 0, spans, &stats, NULL, NULL, NULL, NULL,
+ *                     err, sizeof(err)) == 0) {
+ *       // Use spans[0..n-1] and stats
+ *   }
+ *   free(spans);
+ */
+int analyzeSeries(const double *prices, size_t length, size_t windowSize,
+                  int *out_spans, SeriesStats *out_stats,
+                  double *out_win_max, double *out_win_min, double *out_win_avg,
+                  unsigned char *out_win_pattern,
+                  char *err_buf, size_t err_buf_len);
+
+#endif // SERIES_ANALYSIS_H
@@ -3,6 +3,16 @@
 
 #include <stddef.h>
 
+/**
+ * Pattern codes stored per window (see getWindowResult for definitions).
+ */
+typedef enum {
+    WINDOW_PATTERN_BULLISH = 0,
+    WINDOW_PATTERN_BEARISH = 1,
+    WINDOW_PATTERN_VOLATILE = 2,
+    WINDOW_PATTERN_STABLE = 3
+} WindowPattern;
+
 /**
  * Analyze price data using sliding windows to detect patterns.
  * 
@@ -46,6 +56,18 @@
 int analyzeSlidingWindow(const double *prices, size_t length, size_t windowSize,
                          void **out_window_result_handle, char *err_buf, size_t err_buf_len);
 
+/**
+ * Analyze float32 prices using sliding windows.
+ * 
+ * Same contract and error codes as analyzeSlidingWindow(). Window min/max
+ * are stored as float and averages as double (24 bytes per window instead
+ * of 32); sums accumulate in double, so results equal analyzeSlidingWindow()
+ * on the same values widened to double. The handle works with every other
+ * window result function.
+ */
+int analyzeSlidingWindowF32(const float *prices, size_t length, size_t windowSize,
+                            void **out_window_result_handle, char *err_buf, size_t err_buf_len);
+
 /**
  * Get results for a specific window position.
  * 
@@ -77,6 +99,61 @@ int getWindowResult(void *window_handle, size_t idx,
                     char *out_pattern, size_t out_pattern_len,
                     char *err_buf, size_t err_len);
 
+/**
+ * Copy a contiguous run of window results into columnar arrays.
+ * 
+ * Bulk alternative to calling getWindowResult per index. Patterns are
+ * written as WindowPattern codes; use windowPatternName() to map them.
+ * 
+ * Time complexity: O(count)
+ * Thread-safety: Safe for concurrent reads if handle is not being freed.
+ * 
+ * @param window_handle Result handle from analyzeSlidingWindow (must not be NULL)
+ * @param start First window index to copy
+ * @param count Number of windows to copy (start + count <= num_windows)
+ * @param out_max Array of count elements for max values (can be NULL)
+ * @param out_min Array of count elements for min values (can be NULL)
+ * @param out_avg Array of count elements for averages (can be NULL)
+ * @param out_pattern Array of count elements for pattern codes (can be NULL)
+ * @param err_buf Buffer for error messages (can be NULL)
+ * @param err_len Size of error buffer
+ * 
+ * @return 0 on success, non-zero on failure:
+ *   -1: NULL handle
+ *   -2: Range out of bounds
+ */
+int copyWindowResults(const void *window_handle, size_t start, size_t count,
+                      double *out_max, double *out_min, double *out_avg,
+                      unsigned char *out_pattern, char *err_buf, size_t err_len);
+
+/**
+ * Map a WindowPattern code to its name ("bullish", "bearish", ...).
+ * 
+ * @return Static string, or NULL for an unknown code
+ */
+const char *windowPatternName(int pattern);
+
+/**
+ * Get the number of windows held by a result handle.
+ * 
+ * Time complexity: O(1)
+ * 
+ * @param window_handle Result handle from analyzeSlidingWindow (can be NULL)
+ * @return Window count (length - windowSize + 1), or 0 for a NULL handle
+ */
+size_t getWindowResultCount(const void *window_handle);
+
+/**
+ * Get the native memory held by a result handle, in bytes.
+ * 
+ * Used by language bindings to report external memory to their garbage
+ * collector. Time complexity: O(1)
+ * 
+ * @param window_handle Result handle from analyzeSlidingWindow (can be NULL)
+ * @return Bytes allocated for the results, or 0 for a NULL handle
+ */
+size_t getWindowResultMemoryUsage(const void *window_handle);
+
 /**
  * Free sliding window result resources.
  * 
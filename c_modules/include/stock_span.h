@@ -39,4 +39,13 @@
 int calculateStockSpan(const double *prices, size_t length, int **out_spans, 
                        char *err_buf, size_t err_buf_len);
 
+/**
+ * Calculate stock span for float32 prices.
+ * 
+ * Same contract and error codes as calculateStockSpan(); reads half the
+ * input bytes.
+ */
+int calculateStockSpanF32(const float *prices, size_t length, int **out_spans,
+                          char *err_buf, size_t err_buf_len);
+
 #endif // STOCK_SPAN_H
@@ -0,0 +1,656 @@
+#include "chart_parser.h"
+#include "stats_internal.h"
+#include <float.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#  define CHART_SSE2 1
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  define CHART_SWAR 1
+#endif
+
+// x87 extended precision (64-bit mantissa), where the OS leaves it enabled
+#if LDBL_MANT_DIG == 64 && (defined(__x86_64__) || defined(__i386__)) && !defined(_WIN32)
+#  define CHART_EXTENDED 1
+#endif
+
+#define MAX_ARRAY_SIZE 10000000
+#define MAX_DEPTH 64
+#define MAX_NUMBER_LENGTH 64
+
+typedef struct {
+    const char *begin;
+    const char *p;
+    const char *end;
+    int depth;
+    char *err_buf;
+    size_t err_buf_len;
+} Scanner;
+
+// Growable column for one JSON number array
+typedef struct {
+    double *values;
+    size_t count;
+    size_t cap;
+    int present;
+} NumberArray;
+
+static void setError(char *err_buf, size_t err_buf_len, const char *msg) {
+    if (err_buf && err_buf_len > 0) {
+        strncpy(err_buf, msg, err_buf_len - 1);
+        err_buf[err_buf_len - 1] = '\0';
+    }
+}
+
+// Malformed input: message with the byte offset; always returns -4
+static int syntaxError(Scanner *s, const char *what) {
+    if (s->err_buf && s->err_buf_len > 0) {
+        snprintf(s->err_buf, s->err_buf_len, "%s at byte %zu", what,
+                 (size_t)(s->p - s->begin));
+    }
+    return -4;
+}
+
+static void skipSpace(Scanner *s) {
+    while (s->p < s->end &&
+           (*s->p == ' ' || *s->p == '\n' || *s->p == '\r' || *s->p == '\t')) {
+        s->p++;
+    }
+}
+
+// Consume `c` (after whitespace); 1 if it was there
+static int consume(Scanner *s, char c) {
+    skipSpace(s);
+    if (s->p < s->end && *s->p == c) {
+        s->p++;
+        return 1;
+    }
+    return 0;
+}
+
+// ============================================================================
+// Strings
+// ============================================================================
+
+// Offset of the first '"' or '\\' in p[0 .. n), or n
+static size_t findQuoteOrEscape(const char *p, size_t n) {
+    size_t i = 0;
+#ifdef CHART_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i escape = _mm_set1_epi8('\\');
+    for (; i + 16 <= n; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(p + i));
+        int hits = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                  _mm_cmpeq_epi8(chunk, escape)));
+        if (hits) return i + (size_t)__builtin_ctz((unsigned)hits);
+    }
+#endif
+    for (; i < n; i++) {
+        if (p[i] == '"' || p[i] == '\\') return i;
+    }
+    return n;
+}
+
+/*
+ * Skip a string at s->p (the opening quote). Sets *out_start and *out_len to
+ * the raw contents (escapes left as is) when those are non-NULL.
+ */
+static int scanString(Scanner *s, const char **out_start, size_t *out_len) {
+    if (s->p >= s->end || *s->p != '"') return syntaxError(s, "Expected string");
+    const char *start = ++s->p;
+
+    for (;;) {
+        s->p += findQuoteOrEscape(s->p, (size_t)(s->end - s->p));
+        if (s->p >= s->end) return syntaxError(s, "Unterminated string");
+        if (*s->p == '"') break;
+        if (s->p + 1 >= s->end) return syntaxError(s, "Unterminated string");
+        s->p += 2;  // Escape: the next byte cannot end the string
+    }
+
+    if (out_start) *out_start = start;
+    if (out_len) *out_len = (size_t)(s->p - start);
+    s->p++;
+    return 0;
+}
+
+// ============================================================================
+// Numbers
+// ============================================================================
+
+static int isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+#ifdef CHART_SWAR
+// 1 if all eight bytes at p are ASCII digits
+static int isEightDigits(const char *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return (((v & 0xF0F0F0F0F0F0F0F0ull) |
+             (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ==
+            0x3333333333333333ull);
+}
+
+// Value of eight ASCII digits at p (first digit most significant)
+static uint64_t parseEightDigits(const char *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    v -= 0x3030303030303030ull;
+    v = (v * 10) + (v >> 8);
+    return (((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+            (((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+}
+#endif
+
+/*
+ * Accumulate a run of digits into *mantissa, at most 19 significant
+ * digits; further digits only bump *dropped. Returns the digits consumed.
+ * *digits may overcount (never under), which only sends more numbers to
+ * the strtod() path.
+ */
+static size_t scanDigits(Scanner *s, uint64_t *mantissa, int *digits, int *dropped) {
+    const char *start = s->p;
+
+#ifdef CHART_SWAR
+    while (*digits + 8 <= 19 && s->end - s->p >= 8 && isEightDigits(s->p)) {
+        *mantissa = *mantissa * 100000000ull + parseEightDigits(s->p);
+        if (*mantissa != 0) *digits += 8;
+        s->p += 8;
+    }
+#endif
+    for (; s->p < s->end && isDigit(*s->p); s->p++) {
+        if (*digits < 19) {
+            *mantissa = *mantissa * 10 + (uint64_t)(*s->p - '0');
+            if (*mantissa != 0) (*digits)++;
+        } else {
+            (*dropped)++;
+        }
+    }
+    return (size_t)(s->p - start);
+}
+
+static const double EXACT_POWERS[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static int parseNumber(Scanner *s, double *out) {
+    const char *start = s->p;
+    int negative = 0;
+    if (s->p < s->end && *s->p == '-') {
+        negative = 1;
+        s->p++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;     // Digits in mantissa since its first non-zero one
+    int dropped = 0;    // Digits that did not fit in mantissa
+    if (scanDigits(s, &mantissa, &digits, &dropped) == 0) {
+        return syntaxError(s, "Expected number");
+    }
+    int exponent = dropped;
+
+    if (s->p < s->end && *s->p == '.') {
+        s->p++;
+        int fraction_dropped = 0;
+        size_t fraction = scanDigits(s, &mantissa, &digits, &fraction_dropped);
+        if (fraction == 0) return syntaxError(s, "Expected digits after '.'");
+        exponent -= (int)fraction - fraction_dropped;
+        dropped += fraction_dropped;
+    }
+
+    if (s->p < s->end && (*s->p == 'e' || *s->p == 'E')) {
+        s->p++;
+        int exp_negative = 0;
+        if (s->p < s->end && (*s->p == '+' || *s->p == '-')) {
+            exp_negative = *s->p == '-';
+            s->p++;
+        }
+        if (s->p >= s->end || !isDigit(*s->p)) return syntaxError(s, "Expected exponent");
+        int value = 0;
+        for (; s->p < s->end && isDigit(*s->p); s->p++) {
+            if (value < 100000) value = value * 10 + (*s->p - '0');
+        }
+        exponent += exp_negative ? -value : value;
+    }
+
+    // Exact when the mantissa and the power of ten are both exact doubles
+    if (dropped == 0 && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22) {
+        double value = (double)mantissa;
+        value = exponent < 0 ? value / EXACT_POWERS[-exponent] : value * EXACT_POWERS[exponent];
+        *out = negative ? -value : value;
+        return 0;
+    }
+
+#ifdef CHART_EXTENDED
+    /*
+     * Up to 19 digits (Yahoo's prices have 17): the mantissa and 10^27 are
+     * exact in extended precision, so x is correctly rounded to 64 bits.
+     * Rounding it again to double can only go wrong when x lands exactly
+     * halfway between two doubles; those few go to strtod().
+     */
+    if (dropped == 0 && exponent >= -27 && exponent <= 27) {
+        static const long double EXTENDED_POWERS[] = {
+            1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L, 1e12L, 1e13L,
+            1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L,
+            1e26L, 1e27L,
+        };
+        long double x = (long double)mantissa;
+        x = exponent < 0 ? x / EXTENDED_POWERS[-exponent] : x * EXTENDED_POWERS[exponent];
+        double value = (double)x;
+        long double neighbor = nextafter(value, x > value ? INFINITY : -INFINITY);
+        if (x == value || x != ((long double)value + neighbor) / 2) {
+            *out = negative ? -value : value;
+            return 0;
+        }
+    }
+#endif
+
+    // Correct rounding for the rest: strtod on a NUL-terminated copy
+    size_t length = (size_t)(s->p - start);
+    char local[MAX_NUMBER_LENGTH + 1];
+    char *copy = length <= MAX_NUMBER_LENGTH ? local : malloc(length + 1);
+    if (!copy) {
+        setError(s->err_buf, s->err_buf_len, "Memory allocation failed");
+        return -3;
+    }
+    memcpy(copy, start, length);
+    copy[length] = '\0';
+    *out = strtod(copy, NULL);
+    if (copy != local) free(copy);
+    return 0;
+}
+
+// ============================================================================
+// Structure
+// ============================================================================
+
+static int skipValue(Scanner *s);
+
+// Skip the rest of an object or array whose opening bracket was consumed
+static int skipContainer(Scanner *s, char close, int object) {
+    if (++s->depth > MAX_DEPTH) return syntaxError(s, "Nesting too deep");
+    if (consume(s, close)) {
+        s->depth--;
+        return 0;
+    }
+
+    for (;;) {
+        skipSpace(s);
+        if (object) {
+            int result = scanString(s, NULL, NULL);
+            if (result != 0) return result;
+            if (!consume(s, ':')) return syntaxError(s, "Expected ':'");
+        }
+        int result = skipValue(s);
+        if (result != 0) return result;
+        if (consume(s, ',')) continue;
+        if (consume(s, close)) break;
+        return syntaxError(s, object ? "Expected ',' or '}'" : "Expected ',' or ']'");
+    }
+    s->depth--;
+    return 0;
+}
+
+static int matchLiteral(Scanner *s, const char *literal) {
+    size_t n = strlen(literal);
+    if ((size_t)(s->end - s->p) < n || memcmp(s->p, literal, n) != 0) {
+        return syntaxError(s, "Unexpected token");
+    }
+    s->p += n;
+    return 0;
+}
+
+static int skipValue(Scanner *s) {
+    skipSpace(s);
+    if (s->p >= s->end) return syntaxError(s, "Unexpected end of input");
+
+    switch (*s->p) {
+        case '"':
+            return scanString(s, NULL, NULL);
+        case '{':
+            s->p++;
+            return skipContainer(s, '}', 1);
+        case '[':
+            s->p++;
+            return skipContainer(s, ']', 0);
+        case 't':
+            return matchLiteral(s, "true");
+        case 'f':
+            return matchLiteral(s, "false");
+        case 'n':
+            return matchLiteral(s, "null");
+        default: {
+            double ignored;
+            return parseNumber(s, &ignored);
+        }
+    }
+}
+
+/*
+ * Iterate the members of an object: call with *first = 1 after the value
+ * is known to start with '{'. Returns 1 with the raw key when a member
+ * follows (positioned at its value), 0 at the end, negative on error.
+ */
+static int nextMember(Scanner *s, int *first, const char **key, size_t *key_len) {
+    if (*first) {
+        *first = 0;
+        s->p++;  // '{'
+        if (++s->depth > MAX_DEPTH) return syntaxError(s, "Nesting too deep");
+        if (consume(s, '}')) {
+            s->depth--;
+            return 0;
+        }
+    } else if (!consume(s, ',')) {
+        if (consume(s, '}')) {
+            s->depth--;
+            return 0;
+        }
+        return syntaxError(s, "Expected ',' or '}'");
+    }
+
+    skipSpace(s);
+    int result = scanString(s, key, key_len);
+    if (result != 0) return result;
+    if (!consume(s, ':')) return syntaxError(s, "Expected ':'");
+    skipSpace(s);
+    return 1;
+}
+
+static int keyIs(const char *key, size_t key_len, const char *name) {
+    return strlen(name) == key_len && memcmp(key, name, key_len) == 0;
+}
+
+static int expectObject(Scanner *s) {
+    skipSpace(s);
+    return s->p < s->end && *s->p == '{' ? 0 : syntaxError(s, "Expected object");
+}
+
+/*
+ * Enter an array and position at its first element; returns 1 if there is
+ * one, 0 for an empty array (consumed), negative on error.
+ */
+static int enterFirstElement(Scanner *s) {
+    skipSpace(s);
+    if (s->p >= s->end || *s->p != '[') return syntaxError(s, "Expected array");
+    s->p++;
+    if (++s->depth > MAX_DEPTH) return syntaxError(s, "Nesting too deep");
+    if (consume(s, ']')) {
+        s->depth--;
+        return 0;
+    }
+    skipSpace(s);
+    return 1;
+}
+
+// After an array's first element: skip the rest, including the ']'
+static int leaveArray(Scanner *s) {
+    if (consume(s, ']')) {
+        s->depth--;
+        return 0;
+    }
+    if (!consume(s, ',')) return syntaxError(s, "Expected ',' or ']'");
+    s->depth--;
+    return skipContainer(s, ']', 0);
+}
+
+static int pushNumber(NumberArray *array, double value) {
+    if (array->count == array->cap) {
+        if (array->cap >= MAX_ARRAY_SIZE) return -2;
+        size_t cap = array->cap ? array->cap * 2 : 256;
+        if (cap > MAX_ARRAY_SIZE) cap = MAX_ARRAY_SIZE;
+        double *grown = realloc(array->values, cap * sizeof(double));
+        if (!grown) return -3;
+        array->values = grown;
+        array->cap = cap;
+    }
+    array->values[array->count++] = value;
+    return 0;
+}
+
+// Array of numbers and nulls into `array` (replacing earlier contents)
+static int parseNumberArray(Scanner *s, NumberArray *array) {
+    skipSpace(s);
+    if (s->p >= s->end || *s->p != '[') return syntaxError(s, "Expected array");
+    s->p++;
+    array->count = 0;
+    array->present = 1;
+    if (consume(s, ']')) return 0;
+
+    for (;;) {
+        skipSpace(s);
+        double value;
+        int result;
+        if (s->p < s->end && *s->p == 'n') {
+            result = matchLiteral(s, "null");
+            value = NAN;
+        } else {
+            result = parseNumber(s, &value);
+        }
+        if (result != 0) return result;
+
+        result = pushNumber(array, value);
+        if (result == -2) {
+            setError(s->err_buf, s->err_buf_len, "Chart has more than 10,000,000 rows");
+            return -2;
+        }
+        if (result == -3) {
+            setError(s->err_buf, s->err_buf_len, "Memory allocation failed");
+            return -3;
+        }
+
+        if (consume(s, ',')) continue;
+        if (consume(s, ']')) return 0;
+        return syntaxError(s, "Expected ',' or ']'");
+    }
+}
+
+// indicators.quote[0]: {open: [...], high: [...], ...}
+static int parseQuote(Scanner *s, NumberArray fields[CHART_FIELD_COUNT]) {
+    static const char *const NAMES[CHART_FIELD_COUNT] = {
+        NULL, "open", "high", "low", "close", "volume",
+    };
+
+    int result = expectObject(s);
+    int first = 1;
+    const char *key;
+    size_t key_len;
+    while (result == 0 && (result = nextMember(s, &first, &key, &key_len)) == 1) {
+        int field = CHART_OPEN;
+        while (field < CHART_FIELD_COUNT && !keyIs(key, key_len, NAMES[field])) field++;
+        result = field < CHART_FIELD_COUNT ? parseNumberArray(s, &fields[field]) : skipValue(s);
+    }
+    return result;
+}
+
+// chart.result[0]: {timestamp: [...], indicators: {quote: [{...}]}, ...}
+static int parseResult(Scanner *s, NumberArray fields[CHART_FIELD_COUNT]) {
+    int result = expectObject(s);
+    int first = 1;
+    const char *key;
+    size_t key_len;
+    while (result == 0 && (result = nextMember(s, &first, &key, &key_len)) == 1) {
+        if (keyIs(key, key_len, "timestamp")) {
+            result = parseNumberArray(s, &fields[CHART_TIMESTAMP]);
+        } else if (keyIs(key, key_len, "indicators")) {
+            result = expectObject(s);
+            int inner_first = 1;
+            while (result == 0 && (result = nextMember(s, &inner_first, &key, &key_len)) == 1) {
+                if (!keyIs(key, key_len, "quote")) {
+                    result = skipValue(s);
+                    continue;
+                }
+                result = enterFirstElement(s);
+                if (result == 1) {
+                    result = parseQuote(s, fields);
+                    if (result == 0) result = leaveArray(s);
+                }
+            }
+        } else {
+            result = skipValue(s);
+        }
+    }
+    return result;
+}
+
+// {chart: {result: [{...}], error: ...}}; *found set if a result was parsed
+static int parseRoot(Scanner *s, NumberArray fields[CHART_FIELD_COUNT], int *found) {
+    int result = expectObject(s);
+    int first = 1;
+    const char *key;
+    size_t key_len;
+    while (result == 0 && (result = nextMember(s, &first, &key, &key_len)) == 1) {
+        if (!keyIs(key, key_len, "chart")) {
+            result = skipValue(s);
+            continue;
+        }
+
+        result = expectObject(s);
+        int chart_first = 1;
+        while (result == 0 && (result = nextMember(s, &chart_first, &key, &key_len)) == 1) {
+            if (!keyIs(key, key_len, "result") || s->p >= s->end || *s->p != '[') {
+                result = skipValue(s);  // Includes "result": null
+                continue;
+            }
+            result = enterFirstElement(s);
+            if (result == 1) {
+                *found = 1;
+                result = parseResult(s, fields);
+                if (result == 0) result = leaveArray(s);
+            }
+        }
+    }
+    if (result != 0) return result;
+
+    skipSpace(s);
+    return s->p == s->end ? 0 : syntaxError(s, "Trailing characters");
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+static int parseChart(const char *json, size_t length, ChartColumns **out_chart,
+                      char *err_buf, size_t err_buf_len) {
+    if (!out_chart || (!json && length > 0)) {
+        setError(err_buf, err_buf_len, "NULL pointer argument");
+        return -1;
+    }
+    *out_chart = NULL;
+
+    Scanner s = {json, json, json + length, 0, err_buf, err_buf_len};
+    NumberArray fields[CHART_FIELD_COUNT];
+    memset(fields, 0, sizeof(fields));
+    int found = 0;
+    int result = parseRoot(&s, fields, &found);
+
+    if (result == 0 && (!found || !fields[CHART_TIMESTAMP].present)) {
+        setError(err_buf, err_buf_len, "No chart result with timestamps");
+        result = -4;
+    }
+    size_t rows = fields[CHART_TIMESTAMP].count;
+    for (int f = CHART_OPEN; result == 0 && f < CHART_FIELD_COUNT; f++) {
+        if (fields[f].count > rows) {
+            setError(err_buf, err_buf_len, "Quote array longer than timestamp array");
+            result = -4;
+        }
+    }
+
+    ChartColumns *chart = NULL;
+    if (result == 0) {
+        chart = calloc(1, sizeof(ChartColumns));
+        unsigned char *nulls = chart ? calloc(rows ? rows : 1, 1) : NULL;
+        if (!nulls) {
+            free(chart);
+            chart = NULL;
+            setError(err_buf, err_buf_len, "Memory allocation failed");
+            result = -3;
+        } else {
+            chart->rows = rows;
+            chart->nulls = nulls;
+        }
+    }
+
+    // Columns take over the arrays, padded with nulls to the row count
+    for (int f = 0; f < CHART_FIELD_COUNT; f++) {
+        NumberArray *array = &fields[f];
+        if (result == 0 && array->cap < rows) {
+            double *grown = realloc(array->values, (rows ? rows : 1) * sizeof(double));
+            if (!grown) {
+                setError(err_buf, err_buf_len, "Memory allocation failed");
+                result = -3;
+            } else {
+                array->values = grown;
+                array->cap = rows;
+            }
+        }
+        if (result != 0) {
+            free(array->values);
+            continue;
+        }
+
+        for (size_t i = array->count; i < rows; i++) array->values[i] = NAN;
+        for (size_t i = 0; i < rows; i++) {
+            if (isnan(array->values[i])) chart->nulls[i] |= (unsigned char)(1u << f);
+        }
+        chart->values[f] = array->values;
+    }
+
+    if (result != 0) {
+        freeChartColumns(chart);
+        return result;
+    }
+    *out_chart = chart;
+    return 0;
+}
+
+int parseChartColumns(const char *json, size_t length, ChartColumns **out_chart,
+                      char *err_buf, size_t err_buf_len) {
+    uint64_t started = statsStart();
+    int rc = parseChart(json, length, out_chart, err_buf, err_buf_len);
+    size_t bytes = 0;
+    if (rc == 0 && started) {
+        size_t rows = (*out_chart)->rows;
+        bytes = sizeof(ChartColumns) + rows + rows * CHART_FIELD_COUNT * sizeof(double);
+    }
+    statsRecord(DSA_STAT_CHART_PARSE, started, length, bytes, rc);
+    return rc;
+}
+
+size_t compactChartRows(ChartColumns *chart) {
+    if (!chart) return 0;
+
+    const unsigned char required = (1u << CHART_TIMESTAMP) | (1u << CHART_CLOSE);
+    double **v = chart->values;
+    size_t kept = 0;
+    for (size_t i = 0; i < chart->rows; i++) {
+        unsigned char nulls = chart->nulls[i];
+        if (nulls & required) continue;
+
+        double close = v[CHART_CLOSE][i];
+        for (int f = 0; f < CHART_FIELD_COUNT; f++) {
+            double value = v[f][i];
+            if (nulls & (1u << f)) value = f == CHART_VOLUME ? 0.0 : close;
+            v[f][kept] = value;
+        }
+        chart->nulls[kept] = nulls;
+        kept++;
+    }
+
+    chart->rows = kept;
+    return kept;
+}
+
+void freeChartColumns(ChartColumns *chart) {
+    if (!chart) return;
+    for (int f = 0; f < CHART_FIELD_COUNT; f++) free(chart->values[f]);
+    free(chart->nulls);
+    free(chart);
+}
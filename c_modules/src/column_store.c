@@ -0,0 +1,545 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "column_store.h"
+#include "price_validation.h"
+#include "stats_internal.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#ifdef _WIN32
+#  include <direct.h>
+#  include <io.h>
+#  define makeDirectory(path) _mkdir(path)
+#  define syncDescriptor(fd) _commit(fd)
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  define makeDirectory(path) mkdir(path, 0755)
+#  define syncDescriptor(fd) fsync(fd)
+#endif
+
+#define MAX_ARRAY_SIZE 10000000
+#define INDEX_STRIDE 256
+#define STORE_MAGIC 0x43415344u  // "DSAC"
+#define STORE_FORMAT 1u
+
+static const char *const COLUMN_FILES[COLUMN_COUNT] = {
+    "date.f64", "open.f64", "high.f64", "low.f64", "close.f64", "volume.f64",
+};
+
+// Contents of the "header" file
+typedef struct {
+    uint32_t magic;
+    uint32_t format;
+    uint64_t rows;
+    double covered_start;   // covered_start > covered_end: nothing covered yet
+    double covered_end;
+} StoreHeader;
+
+// Read-only view of the first `rows` values of a column file
+typedef struct {
+    atomic_size_t refs;
+    void *addr;
+    size_t bytes;
+    int mapped;             // 1: mmap, 0: heap copy
+} ColumnMapping;
+
+typedef struct {
+    char *dir;
+    StoreHeader header;
+    double last_date;       // Date of the last committed row
+    double *index;          // index[k] = date of row k * INDEX_STRIDE
+    size_t index_len;
+    size_t index_cap;
+    ColumnMapping *maps[COLUMN_COUNT];
+    size_t map_rows[COLUMN_COUNT];
+} ColumnStore;
+
+static void setError(char *err_buf, size_t err_buf_len, const char *msg) {
+    if (err_buf && err_buf_len > 0) {
+        strncpy(err_buf, msg, err_buf_len - 1);
+        err_buf[err_buf_len - 1] = '\0';
+    }
+}
+
+static void setIoError(char *err_buf, size_t err_buf_len, const char *what, const char *path) {
+    if (err_buf && err_buf_len > 0) {
+        snprintf(err_buf, err_buf_len, "%s %s: %s", what, path, strerror(errno));
+    }
+}
+
+// dir + "/" + name in a caller-sized buffer
+static void joinPath(char *out, size_t out_len, const char *dir, const char *name) {
+    snprintf(out, out_len, "%s/%s", dir, name);
+}
+
+// Close a file written through `fp` once its data has reached the disk
+static int closeSynced(FILE *fp, int ok) {
+    ok = ok && fflush(fp) == 0 && syncDescriptor(fileno(fp)) == 0;
+    ok = (fclose(fp) == 0) && ok;
+    return ok ? 0 : -1;
+}
+
+// Write count doubles at element offset `offset`, creating the file if
+// needed; returns once they are on disk
+static int writeAt(const char *path, size_t offset, const double *values, size_t count) {
+    FILE *fp = fopen(path, "r+b");
+    if (!fp) fp = fopen(path, "w+b");
+    if (!fp) return -1;
+
+    int ok = fseek(fp, (long)(offset * sizeof(double)), SEEK_SET) == 0 &&
+             fwrite(values, sizeof(double), count, fp) == count;
+    return closeSynced(fp, ok);
+}
+
+// Read count doubles at element offset `offset`; returns values read
+static size_t readAt(const char *path, size_t offset, double *values, size_t count) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return 0;
+
+    size_t got = 0;
+    if (fseek(fp, (long)(offset * sizeof(double)), SEEK_SET) == 0) {
+        got = fread(values, sizeof(double), count, fp);
+    }
+    fclose(fp);
+    return got;
+}
+
+static int writeHeader(const ColumnStore *store) {
+    char path[4096];
+    joinPath(path, sizeof(path), store->dir, "header");
+
+    FILE *fp = fopen(path, "r+b");
+    if (!fp) fp = fopen(path, "w+b");
+    if (!fp) return -1;
+
+    int ok = fwrite(&store->header, sizeof(StoreHeader), 1, fp) == 1;
+    return closeSynced(fp, ok);
+}
+
+// ============================================================================
+// Mappings
+// ============================================================================
+
+static ColumnMapping *createMapping(const char *path, size_t rows) {
+    ColumnMapping *mapping = malloc(sizeof(ColumnMapping));
+    if (!mapping) return NULL;
+    atomic_init(&mapping->refs, 1);
+    mapping->bytes = rows * sizeof(double);
+
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        // Private and writable: a stray write through the mapping copies
+        // the page instead of faulting or reaching the file
+        void *addr = mmap(NULL, mapping->bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (addr != MAP_FAILED) {
+            mapping->addr = addr;
+            mapping->mapped = 1;
+            return mapping;
+        }
+    }
+#endif
+
+    // No mmap: private heap copy
+    mapping->addr = malloc(mapping->bytes);
+    mapping->mapped = 0;
+    if (!mapping->addr || readAt(path, 0, mapping->addr, rows) != rows) {
+        free(mapping->addr);
+        free(mapping);
+        return NULL;
+    }
+    return mapping;
+}
+
+void releaseColumnMapping(void *mapping_handle) {
+    ColumnMapping *mapping = mapping_handle;
+    if (!mapping) return;
+    if (atomic_fetch_sub(&mapping->refs, 1) != 1) return;
+
+#ifndef _WIN32
+    if (mapping->mapped) {
+        munmap(mapping->addr, mapping->bytes);
+        free(mapping);
+        return;
+    }
+#endif
+    free(mapping->addr);
+    free(mapping);
+}
+
+// Make the store's mapping of `column` cover every committed row
+static int ensureMapping(ColumnStore *store, ColumnId column, char *err_buf, size_t err_buf_len) {
+    size_t rows = (size_t)store->header.rows;
+    if (store->maps[column] && store->map_rows[column] >= rows) return 0;
+
+    char path[4096];
+    joinPath(path, sizeof(path), store->dir, COLUMN_FILES[column]);
+    ColumnMapping *mapping = createMapping(path, rows);
+    if (!mapping) {
+        setIoError(err_buf, err_buf_len, "Cannot map", path);
+        return -5;
+    }
+
+    // Readers of the old mapping keep their own references
+    releaseColumnMapping(store->maps[column]);
+    store->maps[column] = mapping;
+    store->map_rows[column] = rows;
+    return 0;
+}
+
+// ============================================================================
+// Sparse date index
+// ============================================================================
+
+static int reserveIndex(ColumnStore *store, size_t entries) {
+    if (entries <= store->index_cap) return 0;
+
+    size_t cap = store->index_cap ? store->index_cap * 2 : 64;
+    while (cap < entries) cap *= 2;
+    double *grown = realloc(store->index, cap * sizeof(double));
+    if (!grown) return -3;
+    store->index = grown;
+    store->index_cap = cap;
+    return 0;
+}
+
+// Load the index, rebuilding any entries lost to a torn append
+static int loadIndex(ColumnStore *store, char *err_buf, size_t err_buf_len) {
+    size_t rows = (size_t)store->header.rows;
+    size_t expected = (rows + INDEX_STRIDE - 1) / INDEX_STRIDE;
+    if (reserveIndex(store, expected) != 0) {
+        setError(err_buf, err_buf_len, "Memory allocation failed");
+        return -3;
+    }
+
+    char path[4096];
+    joinPath(path, sizeof(path), store->dir, "date.idx");
+    size_t have = expected > 0 ? readAt(path, 0, store->index, expected) : 0;
+
+    char date_path[4096];
+    joinPath(date_path, sizeof(date_path), store->dir, COLUMN_FILES[COLUMN_DATE]);
+    for (size_t k = have; k < expected; k++) {
+        if (readAt(date_path, k * INDEX_STRIDE, &store->index[k], 1) != 1) {
+            setIoError(err_buf, err_buf_len, "Cannot read", date_path);
+            return -5;
+        }
+    }
+    if (have < expected && writeAt(path, have, store->index + have, expected - have) != 0) {
+        setIoError(err_buf, err_buf_len, "Cannot write", path);
+        return -5;
+    }
+    store->index_len = expected;
+
+    store->last_date = -INFINITY;
+    if (rows > 0 && readAt(date_path, rows - 1, &store->last_date, 1) != 1) {
+        setIoError(err_buf, err_buf_len, "Cannot read", date_path);
+        return -5;
+    }
+    return 0;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+int openColumnStore(const char *dir, void **out_store, char *err_buf, size_t err_buf_len) {
+    if (!dir || !out_store) {
+        setError(err_buf, err_buf_len, "NULL pointer argument");
+        return -1;
+    }
+
+    if (makeDirectory(dir) != 0 && errno != EEXIST) {
+        setIoError(err_buf, err_buf_len, "Cannot create", dir);
+        return -5;
+    }
+
+    ColumnStore *store = calloc(1, sizeof(ColumnStore));
+    char *dir_copy = malloc(strlen(dir) + 1);
+    if (!store || !dir_copy) {
+        free(store);
+        free(dir_copy);
+        setError(err_buf, err_buf_len, "Memory allocation failed");
+        return -3;
+    }
+    strcpy(dir_copy, dir);
+    store->dir = dir_copy;
+
+    char path[4096];
+    joinPath(path, sizeof(path), dir, "header");
+    FILE *fp = fopen(path, "rb");
+    if (fp) {
+        int ok = fread(&store->header, sizeof(StoreHeader), 1, fp) == 1 &&
+                 store->header.magic == STORE_MAGIC &&
+                 store->header.format == STORE_FORMAT &&
+                 store->header.rows <= MAX_ARRAY_SIZE;
+        fclose(fp);
+        if (!ok) {
+            if (err_buf && err_buf_len > 0) {
+                snprintf(err_buf, err_buf_len, "Corrupt store header %s", path);
+            }
+            closeColumnStore(store);
+            return -5;
+        }
+    } else {
+        store->header.magic = STORE_MAGIC;
+        store->header.format = STORE_FORMAT;
+        store->header.rows = 0;
+        store->header.covered_start = 1;
+        store->header.covered_end = 0;
+        if (writeHeader(store) != 0) {
+            setIoError(err_buf, err_buf_len, "Cannot write", path);
+            closeColumnStore(store);
+            return -5;
+        }
+    }
+
+    int result = loadIndex(store, err_buf, err_buf_len);
+    if (result != 0) {
+        closeColumnStore(store);
+        return result;
+    }
+
+    *out_store = store;
+    return 0;
+}
+
+static int appendRows(void *store_handle, const double *const columns[COLUMN_COUNT], size_t rows,
+                      double range_start, double range_end, size_t *out_appended,
+                      char *err_buf, size_t err_buf_len) {
+    ColumnStore *store = store_handle;
+    if (out_appended) *out_appended = 0;
+
+    if (!store || !columns) {
+        setError(err_buf, err_buf_len, "NULL pointer argument");
+        return -1;
+    }
+    for (int c = 0; c < COLUMN_COUNT; c++) {
+        if (!columns[c] && rows > 0) {
+            setError(err_buf, err_buf_len, "NULL pointer argument");
+            return -1;
+        }
+    }
+
+    StoreHeader *header = &store->header;
+    int covered = header->covered_start <= header->covered_end;
+    if (!isfinite(range_start) || !isfinite(range_end) || range_start > range_end) {
+        setError(err_buf, err_buf_len, "Invalid date range");
+        return -2;
+    }
+    if (covered && range_start > header->covered_end) {
+        setError(err_buf, err_buf_len, "Range leaves a gap after the stored coverage");
+        return -2;
+    }
+
+    for (int c = 0; c < COLUMN_COUNT; c++) {
+        if (validatePrices(columns[c], rows, NULL) != 0) {
+            setError(err_buf, err_buf_len, "Invalid value");
+            return -4;
+        }
+    }
+    const double *dates = columns[COLUMN_DATE];
+    for (size_t i = 1; i < rows; i++) {
+        if (dates[i] <= dates[i - 1]) {
+            setError(err_buf, err_buf_len, "Dates not strictly increasing");
+            return -4;
+        }
+    }
+
+    // New rows: after the last stored date, within the range
+    size_t first = 0;
+    while (first < rows && dates[first] <= store->last_date) first++;
+    size_t end = first;
+    while (end < rows && dates[end] <= range_end) end++;
+    size_t count = end - first;
+
+    size_t old_rows = (size_t)header->rows;
+    if (old_rows + count > MAX_ARRAY_SIZE) {
+        setError(err_buf, err_buf_len, "Store is full");
+        return -2;
+    }
+
+    // Index entries for new rows landing on a stride boundary
+    size_t new_rows = old_rows + count;
+    size_t index_len = (new_rows + INDEX_STRIDE - 1) / INDEX_STRIDE;
+    if (reserveIndex(store, index_len) != 0) {
+        setError(err_buf, err_buf_len, "Memory allocation failed");
+        return -3;
+    }
+
+    // Columns and index first, synced, so the header never commits rows a
+    // crash could lose
+    char path[4096];
+    if (count > 0) {
+        for (int c = 0; c < COLUMN_COUNT; c++) {
+            joinPath(path, sizeof(path), store->dir, COLUMN_FILES[c]);
+            if (writeAt(path, old_rows, columns[c] + first, count) != 0) {
+                setIoError(err_buf, err_buf_len, "Cannot write", path);
+                return -5;
+            }
+        }
+
+        for (size_t k = store->index_len; k < index_len; k++) {
+            store->index[k] = dates[first + (k * INDEX_STRIDE - old_rows)];
+        }
+        joinPath(path, sizeof(path), store->dir, "date.idx");
+        if (index_len > store->index_len &&
+            writeAt(path, store->index_len, store->index + store->index_len,
+                    index_len - store->index_len) != 0) {
+            setIoError(err_buf, err_buf_len, "Cannot write", path);
+            return -5;
+        }
+    }
+
+    StoreHeader previous = *header;
+    header->rows = new_rows;
+    // Rows can't be prepended, so only the first append sets the start
+    if (!covered) {
+        header->covered_start = range_start;
+        header->covered_end = range_end;
+    } else if (range_end > header->covered_end) {
+        header->covered_end = range_end;
+    }
+    if (writeHeader(store) != 0) {
+        *header = previous;
+        joinPath(path, sizeof(path), store->dir, "header");
+        setIoError(err_buf, err_buf_len, "Cannot write", path);
+        return -5;
+    }
+
+    store->index_len = index_len;
+    if (count > 0) store->last_date = dates[end - 1];
+    if (out_appended) *out_appended = count;
+    return 0;
+}
+
+int appendColumnRows(void *store_handle, const double *const columns[COLUMN_COUNT], size_t rows,
+                     double range_start, double range_end, size_t *out_appended,
+                     char *err_buf, size_t err_buf_len) {
+    uint64_t started = statsStart();
+    int rc = appendRows(store_handle, columns, rows, range_start, range_end, out_appended,
+                        err_buf, err_buf_len);
+    statsRecord(DSA_STAT_COLUMN_APPEND, started, rows, 0, rc);
+    return rc;
+}
+
+size_t getColumnStoreRows(const void *store_handle) {
+    const ColumnStore *store = store_handle;
+    return store ? (size_t)store->header.rows : 0;
+}
+
+int getColumnStoreCoverage(const void *store_handle, double *out_start, double *out_end) {
+    const ColumnStore *store = store_handle;
+    if (!store || store->header.covered_start > store->header.covered_end) return 0;
+    if (out_start) *out_start = store->header.covered_start;
+    if (out_end) *out_end = store->header.covered_end;
+    return 1;
+}
+
+// First row dated >= value (or after every row if `after`, first row > value)
+static size_t boundRow(const ColumnStore *store, const double *dates, double value, int after) {
+    size_t rows = (size_t)store->header.rows;
+
+    // Last index block starting before the bound
+    size_t lo = 0, hi = store->index_len;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int before = after ? store->index[mid] <= value : store->index[mid] < value;
+        if (before) lo = mid + 1;
+        else hi = mid;
+    }
+    size_t block = lo == 0 ? 0 : lo - 1;
+
+    size_t left = block * INDEX_STRIDE;
+    size_t right = left + INDEX_STRIDE < rows ? left + INDEX_STRIDE : rows;
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+        int before = after ? dates[mid] <= value : dates[mid] < value;
+        if (before) left = mid + 1;
+        else right = mid;
+    }
+    return left;
+}
+
+int findColumnDateRange(void *store_handle, double start_date, double end_date,
+                        size_t *out_first, size_t *out_count,
+                        char *err_buf, size_t err_buf_len) {
+    ColumnStore *store = store_handle;
+    if (!store || !out_first || !out_count) {
+        setError(err_buf, err_buf_len, "NULL pointer argument");
+        return -1;
+    }
+
+    *out_first = 0;
+    *out_count = 0;
+    if (store->header.rows == 0 || !(start_date <= end_date)) return 0;
+
+    int result = ensureMapping(store, COLUMN_DATE, err_buf, err_buf_len);
+    if (result != 0) return result;
+
+    const double *dates = store->maps[COLUMN_DATE]->addr;
+    size_t first = boundRow(store, dates, start_date, 0);
+    size_t end = boundRow(store, dates, end_date, 1);
+    *out_first = first;
+    *out_count = end > first ? end - first : 0;
+    return 0;
+}
+
+static int mapRange(void *store_handle, ColumnId column, size_t first, size_t count,
+                    const double **out_values, void **out_mapping,
+                    char *err_buf, size_t err_buf_len) {
+    ColumnStore *store = store_handle;
+    if (!store || !out_values || !out_mapping) {
+        setError(err_buf, err_buf_len, "NULL pointer argument");
+        return -1;
+    }
+
+    *out_values = NULL;
+    *out_mapping = NULL;
+    if ((int)column < 0 || column >= COLUMN_COUNT ||
+        first > store->header.rows || count > store->header.rows - first) {
+        setError(err_buf, err_buf_len, "Invalid column or row range");
+        return -2;
+    }
+    if (count == 0) return 0;
+
+    int result = ensureMapping(store, column, err_buf, err_buf_len);
+    if (result != 0) return result;
+
+    ColumnMapping *mapping = store->maps[column];
+    atomic_fetch_add(&mapping->refs, 1);
+    *out_values = (const double *)mapping->addr + first;
+    *out_mapping = mapping;
+    return 0;
+}
+
+// Mappings are shared and file-backed, so nothing counts as allocated
+int mapColumnRange(void *store_handle, ColumnId column, size_t first, size_t count,
+                   const double **out_values, void **out_mapping,
+                   char *err_buf, size_t err_buf_len) {
+    uint64_t started = statsStart();
+    int rc = mapRange(store_handle, column, first, count, out_values, out_mapping,
+                      err_buf, err_buf_len);
+    statsRecord(DSA_STAT_COLUMN_MAP, started, rc == 0 ? count : 0, 0, rc);
+    return rc;
+}
+
+void closeColumnStore(void *store_handle) {
+    ColumnStore *store = store_handle;
+    if (!store) return;
+
+    for (int c = 0; c < COLUMN_COUNT; c++) {
+        releaseColumnMapping(store->maps[c]);
+    }
+    free(store->index);
+    free(store->dir);
+    free(store);
+}
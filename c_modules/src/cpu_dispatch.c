@@ -0,0 +1,88 @@
+#include "cpu_dispatch.h"
+#include "kernels.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Per-ISA kernels are only built for x86-64 with GCC/Clang (see Makefile)
+#if defined(DSA_ISA_VARIANTS) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define HAVE_ISA_VARIANTS 1
+#endif
+
+static const KernelTable *active = NULL;
+
+#ifdef HAVE_ISA_VARIANTS
+// __builtin_cpu_supports also checks that the OS saves the wider registers
+static int cpuSupports(const KernelTable *table) {
+    __builtin_cpu_init();
+    if (table == &kernels_avx512) {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+               __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+               __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512bw") &&
+               __builtin_cpu_supports("avx512cd");
+    }
+    if (table == &kernels_avx2) {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+    return 1;
+}
+
+// Best first
+static const KernelTable *const TABLES[] = {&kernels_avx512, &kernels_avx2, &kernels_generic};
+#else
+static int cpuSupports(const KernelTable *table) {
+    (void)table;
+    return 1;
+}
+
+static const KernelTable *const TABLES[] = {&kernels_generic};
+#endif
+
+#define TABLE_COUNT (sizeof(TABLES) / sizeof(TABLES[0]))
+
+static const KernelTable *findSupported(const char *isa) {
+    for (size_t i = 0; i < TABLE_COUNT; i++) {
+        if (strcmp(TABLES[i]->isa, isa) == 0) {
+            return cpuSupports(TABLES[i]) ? TABLES[i] : NULL;
+        }
+    }
+    return NULL;
+}
+
+// Runs when the library is loaded; activeKernels() covers other compilers
+#ifdef __GNUC__
+__attribute__((constructor))
+#endif
+static void selectKernels(void) {
+    const char *forced = getenv("DSA_ISA");
+    const KernelTable *table = forced ? findSupported(forced) : NULL;
+
+    for (size_t i = 0; !table && i < TABLE_COUNT; i++) {
+        if (cpuSupports(TABLES[i])) table = TABLES[i];
+    }
+
+    active = table;
+}
+
+const KernelTable *activeKernels(void) {
+    if (!active) selectKernels();
+    return active;
+}
+
+const char *getActiveIsa(void) {
+    return activeKernels()->isa;
+}
+
+int isIsaSupported(const char *isa) {
+    return isa && findSupported(isa) != NULL;
+}
+
+int setActiveIsa(const char *isa) {
+    if (!isa) return -1;
+
+    const KernelTable *table = findSupported(isa);
+    if (!table) return -2;
+
+    active = table;
+    return 0;
+}
@@ -0,0 +1,138 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "dsa_stats.h"
+#include "stats_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <time.h>
+#endif
+
+#define MIN_SHIFT 6    // Bucket 0 ends at 2^6 ns
+#define MAX_SHIFT 36   // Last split power of two: [2^36, 2^37) ns
+#define SUB_BITS 2     // 4 buckets per power of two
+
+static const char *const STAT_NAMES[DSA_STAT_COUNT] = {
+    "stock_span", "segment_tree_build", "segment_tree_query", "sliding_window",
+    "series_analysis", "chart_parse", "column_append", "column_map",
+};
+
+// One cache line apart, so threads in different functions do not contend
+typedef struct {
+    _Alignas(64) atomic_uint_least64_t calls;
+    atomic_uint_least64_t errors;
+    atomic_uint_least64_t elements;
+    atomic_uint_least64_t bytes_allocated;
+    atomic_uint_least64_t total_ns;
+    atomic_uint_least64_t histogram[DSA_STAT_BUCKETS];
+} FunctionCounters;
+
+static FunctionCounters counters[DSA_STAT_COUNT];
+
+atomic_int dsaStatsEnabled = 0;
+
+// Runs when the library is loaded
+#ifdef __GNUC__
+__attribute__((constructor))
+#endif
+static void readStatsEnvironment(void) {
+    const char *env = getenv("DSA_STATS");
+    if (env && env[0] && strcmp(env, "0") != 0) {
+        atomic_store(&dsaStatsEnabled, 1);
+    }
+}
+
+uint64_t statsNow(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)frequency.QuadPart) + 1;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec + 1;
+#endif
+}
+
+static size_t bucketFor(uint64_t ns) {
+    if (ns < (1u << MIN_SHIFT)) return 0;
+
+    unsigned shift = 63;
+    while (!(ns >> shift)) shift--;
+    if (shift > MAX_SHIFT) return DSA_STAT_BUCKETS - 1;
+
+    size_t sub = (size_t)(ns >> (shift - SUB_BITS)) & ((1u << SUB_BITS) - 1);
+    return 1 + ((size_t)(shift - MIN_SHIFT) << SUB_BITS) + sub;
+}
+
+void statsRecord(DsaStatFunction fn, uint64_t started, size_t elements, size_t bytes, int rc) {
+    if (!started || (unsigned)fn >= DSA_STAT_COUNT) return;
+
+    uint64_t elapsed = statsNow() - started;
+    FunctionCounters *c = &counters[fn];
+    atomic_fetch_add_explicit(&c->calls, 1, memory_order_relaxed);
+    if (rc != 0) atomic_fetch_add_explicit(&c->errors, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->elements, elements, memory_order_relaxed);
+    if (bytes) atomic_fetch_add_explicit(&c->bytes_allocated, bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->total_ns, elapsed, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->histogram[bucketFor(elapsed)], 1, memory_order_relaxed);
+}
+
+void setDsaStatsEnabled(int enabled) {
+    atomic_store(&dsaStatsEnabled, enabled ? 1 : 0);
+}
+
+int isDsaStatsEnabled(void) {
+    return atomic_load(&dsaStatsEnabled);
+}
+
+int getDsaStats(DsaStats *out) {
+    if (!out) return -1;
+
+    out->enabled = isDsaStatsEnabled();
+    for (size_t f = 0; f < DSA_STAT_COUNT; f++) {
+        FunctionCounters *c = &counters[f];
+        DsaFunctionStats *s = &out->functions[f];
+        s->calls = atomic_load_explicit(&c->calls, memory_order_relaxed);
+        s->errors = atomic_load_explicit(&c->errors, memory_order_relaxed);
+        s->elements = atomic_load_explicit(&c->elements, memory_order_relaxed);
+        s->bytes_allocated = atomic_load_explicit(&c->bytes_allocated, memory_order_relaxed);
+        s->total_ns = atomic_load_explicit(&c->total_ns, memory_order_relaxed);
+        for (size_t b = 0; b < DSA_STAT_BUCKETS; b++) {
+            s->histogram[b] = atomic_load_explicit(&c->histogram[b], memory_order_relaxed);
+        }
+    }
+    return 0;
+}
+
+void resetDsaStats(void) {
+    for (size_t f = 0; f < DSA_STAT_COUNT; f++) {
+        FunctionCounters *c = &counters[f];
+        atomic_store_explicit(&c->calls, 0, memory_order_relaxed);
+        atomic_store_explicit(&c->errors, 0, memory_order_relaxed);
+        atomic_store_explicit(&c->elements, 0, memory_order_relaxed);
+        atomic_store_explicit(&c->bytes_allocated, 0, memory_order_relaxed);
+        atomic_store_explicit(&c->total_ns, 0, memory_order_relaxed);
+        for (size_t b = 0; b < DSA_STAT_BUCKETS; b++) {
+            atomic_store_explicit(&c->histogram[b], 0, memory_order_relaxed);
+        }
+    }
+}
+
+const char *getDsaStatName(int fn) {
+    return fn >= 0 && fn < DSA_STAT_COUNT ? STAT_NAMES[fn] : NULL;
+}
+
+uint64_t getDsaStatBucketBound(size_t bucket) {
+    if (bucket == 0) return (uint64_t)1 << MIN_SHIFT;
+    if (bucket >= DSA_STAT_BUCKETS - 1) return UINT64_MAX;
+
+    size_t shift = MIN_SHIFT + ((bucket - 1) >> SUB_BITS);
+    uint64_t sub = (bucket - 1) & ((1u << SUB_BITS) - 1);
+    return ((1u << SUB_BITS) + sub + 1) << (shift - SUB_BITS);
+}
@@ -0,0 +1,184 @@
+/*
+ * Kernel bodies, compiled once per ISA variant.
+ *
+ * Built with -DKERNEL_VARIANT=<name> plus that ISA's -m flags to define
+ * kernels_<name>; without KERNEL_VARIANT this is the baseline build
+ * (kernels_generic). Everything else is static so the variants do not
+ * clash. All builds use -ffp-contract=off: no FMA contraction, so every
+ * variant returns bit-identical results.
+ */
+
+#include "kernels.h"
+#include "window_internal.h"
+
+#ifndef KERNEL_VARIANT
+#define KERNEL_VARIANT generic
+#endif
+
+#define KERNEL_CAT_(a, b) a##b
+#define KERNEL_CAT(a, b) KERNEL_CAT_(a, b)
+#define KERNEL_STR_(a) #a
+#define KERNEL_STR(a) KERNEL_STR_(a)
+
+// ============================================================================
+// Shared helpers
+// ============================================================================
+
+// Monotonic index deque in a ring of windowSize + 1 slots (wrapped with a
+// compare, not a division)
+typedef struct {
+    size_t *indices;
+    size_t front;
+    size_t back;
+    size_t capacity;
+} Deque;
+
+static inline int dequeEmpty(const Deque *dq) {
+    return dq->front == dq->back;
+}
+
+static inline void pushBack(Deque *dq, size_t idx) {
+    dq->indices[dq->back] = idx;
+    if (++dq->back == dq->capacity) dq->back = 0;
+}
+
+static inline void popBack(Deque *dq) {
+    dq->back = (dq->back == 0 ? dq->capacity : dq->back) - 1;
+}
+
+static inline void popFront(Deque *dq) {
+    if (++dq->front == dq->capacity) dq->front = 0;
+}
+
+static inline size_t front(const Deque *dq) {
+    return dq->indices[dq->front];
+}
+
+static inline size_t back(const Deque *dq) {
+    return dq->indices[(dq->back == 0 ? dq->capacity : dq->back) - 1];
+}
+
+// Drop indices up to and including `idx` (they left the window)
+static inline void expireThrough(Deque *dq, size_t idx) {
+    while (!dequeEmpty(dq) && front(dq) <= idx) {
+        popFront(dq);
+    }
+}
+
+// ============================================================================
+// Kernels, instantiated for double and float input
+// ============================================================================
+
+#define PRICE_T double
+#define TREE_NODE_T TreeNode
+#define WINDOW_STATS_T WindowStats
+#define KERNEL_FN(name) name
+#include "kernels_template.h"
+
+#define PRICE_T float
+#define TREE_NODE_T TreeNodeF32
+#define WINDOW_STATS_T WindowStatsF32
+#define KERNEL_FN(name) name##F32
+#include "kernels_template.h"
+
+// ============================================================================
+// Fused series pass
+// ============================================================================
+
+// Same span and window updates, in the same order, as stockSpan and
+// scanWindows, so results are bit-identical to theirs. Double only: no
+// float32 caller needs the fused pass.
+static void seriesPass(const double *prices, size_t length, size_t windowSize,
+                       const SeriesOutputs *out, size_t *stack,
+                       size_t *max_ring, size_t *min_ring) {
+    int want_windows = windowSize > 0;
+    Deque max_dq = {max_ring, 0, 0, windowSize + 1};
+    Deque min_dq = {min_ring, 0, 0, windowSize + 1};
+    size_t top = 0;
+
+    double min = prices[0];
+    double max = prices[0];
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    double win_sum = 0.0;
+    double win_sum_sq = 0.0;
+
+    for (size_t i = 0; i < length; i++) {
+        double price = prices[i];
+
+        // Whole-series statistics
+        if (price < min) min = price;
+        if (price > max) max = price;
+        sum += price;
+        sum_sq += price * price;
+
+        if (out->spans) {
+            out->spans[i] = spanStep(prices, i, stack, &top);
+        }
+
+        if (!want_windows) continue;
+
+        if (i < windowSize) {
+            win_sum += price;
+            win_sum_sq += price * price;
+        } else {
+            size_t out_idx = i - windowSize;
+            double leaving = prices[out_idx];
+            win_sum = win_sum - leaving + price;
+            win_sum_sq = win_sum_sq - (leaving * leaving) + (price * price);
+            expireThrough(&max_dq, out_idx);
+            expireThrough(&min_dq, out_idx);
+        }
+        admitIndex(prices, i, &max_dq, &min_dq);
+
+        if (i + 1 >= windowSize) {
+            size_t w = i + 1 - windowSize;
+            double avg = win_sum / windowSize;
+            if (out->win_max) out->win_max[w] = prices[front(&max_dq)];
+            if (out->win_min) out->win_min[w] = prices[front(&min_dq)];
+            if (out->win_avg) out->win_avg[w] = avg;
+            if (out->win_pattern) {
+                double variance = (win_sum_sq / windowSize) - (avg * avg);
+                out->win_pattern[w] = classifyWindowPattern(prices[w], price, variance, avg);
+            }
+        }
+    }
+
+    if (out->stats) {
+        double mean = sum / length;
+        out->stats->min = min;
+        out->stats->max = max;
+        out->stats->avg = mean;
+        out->stats->variance = (sum_sq / length) - (mean * mean);
+    }
+}
+
+// ============================================================================
+// Table
+// ============================================================================
+
+// The baseline build is SSE2 on x86-64 (part of the ABI)
+#if !defined(KERNEL_ISA_NAME)
+#  if defined(__AVX512F__)
+#    define KERNEL_ISA_NAME "avx512"
+#  elif defined(__AVX2__)
+#    define KERNEL_ISA_NAME "avx2"
+#  elif defined(__x86_64__) || defined(_M_X64)
+#    define KERNEL_ISA_NAME "sse2"
+#  else
+#    define KERNEL_ISA_NAME KERNEL_STR(KERNEL_VARIANT)
+#  endif
+#endif
+
+const KernelTable KERNEL_CAT(kernels_, KERNEL_VARIANT) = {
+    KERNEL_ISA_NAME,
+    findNonFinite,
+    stockSpan,
+    buildTree,
+    scanWindows,
+    findNonFiniteF32,
+    stockSpanF32,
+    buildTreeF32,
+    scanWindowsF32,
+    seriesPass,
+};
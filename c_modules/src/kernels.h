@@ -0,0 +1,103 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+/*
+ * Hot loops of the analysis functions, built once per instruction set.
+ *
+ * kernels.c is compiled several times with different -m flags (see the
+ * Makefile); each build defines one KernelTable. cpu_dispatch.c picks the
+ * best table the CPU supports when the library is loaded, and the public
+ * functions call through activeKernels(). Callers validate arguments and
+ * allocate; kernels only compute. Not installed; not part of the public API.
+ */
+
+#include <stddef.h>
+#include "series_analysis.h"
+
+// Segment tree node: aggregate statistics for a range
+typedef struct {
+    double min;
+    double max;
+    double sum;      // For average calculation
+    double sum_sq;   // For variance calculation
+    size_t count;
+} TreeNode;
+
+// Float32 storage: min/max as float, sums in double (32 bytes vs 40)
+typedef struct {
+    float min;
+    float max;
+    double sum;
+    double sum_sq;
+    size_t count;
+} TreeNodeF32;
+
+// Result for one sliding window
+typedef struct {
+    double max;
+    double min;
+    double avg;
+    unsigned char pattern;  // WindowPattern code
+} WindowStats;
+
+// Float32 storage: min/max as float, average in double (24 bytes vs 32)
+typedef struct {
+    float max;
+    float min;
+    double avg;
+    unsigned char pattern;
+} WindowStatsF32;
+
+// Outputs of a fused series pass; NULL members are not computed
+typedef struct {
+    int *spans;
+    SeriesStats *stats;
+    double *win_max;
+    double *win_min;
+    double *win_avg;
+    unsigned char *win_pattern;
+} SeriesOutputs;
+
+typedef struct {
+    const char *isa;
+
+    // Index of the first non-finite price, or length if all are finite
+    size_t (*findNonFinite)(const double *prices, size_t length);
+
+    // Spans into out_spans; stack needs room for length indices
+    void (*stockSpan)(const double *prices, size_t length, int *out_spans,
+                      size_t *stack);
+
+    // Fills nodes[1 .. 2*length) of a bottom-up segment tree
+    void (*buildTree)(const double *prices, size_t length, TreeNode *nodes);
+
+    // Fills out[0 .. length-windowSize]; each ring needs windowSize + 1 slots
+    void (*scanWindows)(const double *prices, size_t length, size_t windowSize,
+                        WindowStats *out, size_t *max_ring, size_t *min_ring);
+
+    // Float32 input: same contracts, sums accumulated in double
+    size_t (*findNonFiniteF32)(const float *prices, size_t length);
+    void (*stockSpanF32)(const float *prices, size_t length, int *out_spans,
+                         size_t *stack);
+    void (*buildTreeF32)(const float *prices, size_t length, TreeNodeF32 *nodes);
+    void (*scanWindowsF32)(const float *prices, size_t length, size_t windowSize,
+                           WindowStatsF32 *out, size_t *max_ring, size_t *min_ring);
+
+    // stockSpan, whole-series stats and scanWindows in one pass; stack is
+    // used if out->spans is set, the rings (windowSize + 1 slots each) if
+    // windowSize > 0
+    void (*seriesPass)(const double *prices, size_t length, size_t windowSize,
+                       const SeriesOutputs *out, size_t *stack,
+                       size_t *max_ring, size_t *min_ring);
+} KernelTable;
+
+extern const KernelTable kernels_generic;
+#ifdef DSA_ISA_VARIANTS
+extern const KernelTable kernels_avx2;
+extern const KernelTable kernels_avx512;
+#endif
+
+// Table selected at load time (cpu_dispatch.c)
+const KernelTable *activeKernels(void);
+
+#endif // KERNELS_H
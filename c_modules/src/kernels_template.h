@@ -0,0 +1,175 @@
+/*
+ * Kernel bodies for one input precision. Included by kernels.c once per
+ * precision (no include guard) with these defined:
+ *
+ *   PRICE_T         element type of the price array (double or float)
+ *   TREE_NODE_T     segment tree node type (TreeNode or TreeNodeF32)
+ *   WINDOW_STATS_T  sliding window result type (WindowStats or WindowStatsF32)
+ *   KERNEL_FN(name) function name for this precision
+ *
+ * Prices are widened to double wherever they are summed, so the float
+ * kernels give the same results as the double kernels on the same
+ * (float-representable) values. The macros are undefined at the end.
+ */
+
+#define VALIDATE_BLOCK 64
+
+// ============================================================================
+// Validation
+// ============================================================================
+
+// x - x is 0 for finite x and NaN for NaN/infinity (exact under IEEE-754;
+// do not build with -ffast-math)
+static size_t KERNEL_FN(findNonFinite)(const PRICE_T *prices, size_t length) {
+    size_t i = 0;
+
+    // Branch-free reduction per block, one test per block. Written as a
+    // NaN-propagating select because that is the form GCC/Clang vectorize
+    // without -ffast-math; an integer OR of comparisons is left scalar.
+    for (; i + VALIDATE_BLOCK <= length; i += VALIDATE_BLOCK) {
+        PRICE_T acc = 0;
+        for (size_t j = 0; j < VALIDATE_BLOCK; j++) {
+            PRICE_T diff = prices[i + j] - prices[i + j];
+            acc = diff != diff ? diff : acc;
+        }
+        if (acc != acc) break;
+    }
+
+    // Rescan the failing block (or the tail) for the first bad index
+    for (; i < length; i++) {
+        if (prices[i] - prices[i] != 0) return i;
+    }
+    return length;
+}
+
+// ============================================================================
+// Stock span
+// ============================================================================
+
+// Span of price i given the stack of earlier indices; pushes i
+static inline int KERNEL_FN(spanStep)(const PRICE_T *prices, size_t i, size_t *stack,
+                                      size_t *top) {
+    // Pop while the top's price is <= the current price
+    size_t t = *top;
+    while (t > 0 && prices[stack[t - 1]] <= prices[i]) {
+        t--;
+    }
+
+    // Empty stack: span covers every previous element
+    int span = t == 0 ? (int)(i + 1) : (int)(i - stack[t - 1]);
+
+    stack[t] = i;
+    *top = t + 1;
+    return span;
+}
+
+static void KERNEL_FN(stockSpan)(const PRICE_T *prices, size_t length, int *out_spans,
+                                 size_t *stack) {
+    size_t top = 0;
+
+    // Each index is pushed and popped at most once - O(n)
+    for (size_t i = 0; i < length; i++) {
+        out_spans[i] = KERNEL_FN(spanStep)(prices, i, stack, &top);
+    }
+}
+
+// ============================================================================
+// Segment tree
+// ============================================================================
+
+static void KERNEL_FN(buildTree)(const PRICE_T *prices, size_t length, TREE_NODE_T *nodes) {
+    // Leaf nodes start at index 'length'
+    TREE_NODE_T *leaves = nodes + length;
+    for (size_t i = 0; i < length; i++) {
+        double value = prices[i];
+        leaves[i].min = prices[i];
+        leaves[i].max = prices[i];
+        leaves[i].sum = value;
+        leaves[i].sum_sq = value * value;
+        leaves[i].count = 1;
+    }
+
+    // Internal nodes merge their children, bottom-up - O(n)
+    for (size_t i = length - 1; i > 0; i--) {
+        const TREE_NODE_T *left = &nodes[2 * i];
+        const TREE_NODE_T *right = &nodes[2 * i + 1];
+        nodes[i].min = (left->min < right->min) ? left->min : right->min;
+        nodes[i].max = (left->max > right->max) ? left->max : right->max;
+        nodes[i].sum = left->sum + right->sum;
+        nodes[i].sum_sq = left->sum_sq + right->sum_sq;
+        nodes[i].count = left->count + right->count;
+    }
+}
+
+// ============================================================================
+// Sliding window
+// ============================================================================
+
+// Append index i to the max deque (decreasing prices) and the min deque
+// (increasing prices)
+static inline void KERNEL_FN(admitIndex)(const PRICE_T *prices, size_t i, Deque *max_dq,
+                                         Deque *min_dq) {
+    while (!dequeEmpty(max_dq) && prices[back(max_dq)] <= prices[i]) {
+        popBack(max_dq);
+    }
+    pushBack(max_dq, i);
+
+    while (!dequeEmpty(min_dq) && prices[back(min_dq)] >= prices[i]) {
+        popBack(min_dq);
+    }
+    pushBack(min_dq, i);
+}
+
+static void KERNEL_FN(scanWindows)(const PRICE_T *prices, size_t length, size_t windowSize,
+                                   WINDOW_STATS_T *out, size_t *max_ring, size_t *min_ring) {
+    size_t num_windows = length - windowSize + 1;
+    Deque max_dq = {max_ring, 0, 0, windowSize + 1};
+    Deque min_dq = {min_ring, 0, 0, windowSize + 1};
+
+    // Process first window
+    double sum = 0.0;
+    double sum_sq = 0.0;
+
+    for (size_t i = 0; i < windowSize; i++) {
+        double value = prices[i];
+        sum += value;
+        sum_sq += value * value;
+        KERNEL_FN(admitIndex)(prices, i, &max_dq, &min_dq);
+    }
+
+    double avg = sum / windowSize;
+    double variance = (sum_sq / windowSize) - (avg * avg);
+    out[0].max = prices[front(&max_dq)];
+    out[0].min = prices[front(&min_dq)];
+    out[0].avg = avg;
+    out[0].pattern = classifyWindowPattern(prices[0], prices[windowSize - 1], variance, avg);
+
+    // Slide window - O(n) total time
+    for (size_t i = 1; i < num_windows; i++) {
+        size_t out_idx = i - 1;
+        size_t in_idx = i + windowSize - 1;
+        double leaving = prices[out_idx];
+        double entering = prices[in_idx];
+
+        sum = sum - leaving + entering;
+        sum_sq = sum_sq - (leaving * leaving) + (entering * entering);
+
+        // Remove elements outside window from deques, then add the new one
+        expireThrough(&max_dq, out_idx);
+        expireThrough(&min_dq, out_idx);
+        KERNEL_FN(admitIndex)(prices, in_idx, &max_dq, &min_dq);
+
+        avg = sum / windowSize;
+        variance = (sum_sq / windowSize) - (avg * avg);
+        out[i].max = prices[front(&max_dq)];
+        out[i].min = prices[front(&min_dq)];
+        out[i].avg = avg;
+        out[i].pattern = classifyWindowPattern(prices[i], prices[in_idx], variance, avg);
+    }
+}
+
+#undef VALIDATE_BLOCK
+#undef PRICE_T
+#undef TREE_NODE_T
+#undef WINDOW_STATS_T
+#undef KERNEL_FN
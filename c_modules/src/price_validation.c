@@ -0,0 +1,30 @@
+#include "price_validation.h"
+#include "kernels.h"
+
+int validatePrices(const double *prices, size_t length, size_t *out_bad_index) {
+    if (!prices) {
+        return length == 0 ? 0 : -1;
+    }
+    
+    size_t bad_idx = activeKernels()->findNonFinite(prices, length);
+    if (bad_idx < length) {
+        if (out_bad_index) *out_bad_index = bad_idx;
+        return -4;
+    }
+    
+    return 0;
+}
+
+int validatePricesF32(const float *prices, size_t length, size_t *out_bad_index) {
+    if (!prices) {
+        return length == 0 ? 0 : -1;
+    }
+    
+    size_t bad_idx = activeKernels()->findNonFiniteF32(prices, length);
+    if (bad_idx < length) {
+        if (out_bad_index) *out_bad_index = bad_idx;
+        return -4;
+    }
+    
+    return 0;
+}
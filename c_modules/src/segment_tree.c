@@ -1,4 +1,7 @@
 #include "segment_tree.h"
+#include "price_validation.h"
+#include "kernels.h"
+#include "stats_internal.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -7,17 +10,10 @@
 
 #define MAX_ARRAY_SIZE 10000000
 
-// Node stores aggregate statistics for a range
-typedef struct {
-    double min;
-    double max;
-    double sum;      // For average calculation
-    double sum_sq;   // For variance calculation
-    size_t count;
-} TreeNode;
-
+// Exactly one of nodes / nodes_f32 is allocated, by input precision
 typedef struct {
     TreeNode *nodes;
+    TreeNodeF32 *nodes_f32;
     size_t length;      // Original array length
     size_t tree_size;   // Total nodes in tree (2 * length)
 } SegmentTree;
@@ -40,10 +36,25 @@ static TreeNode mergeNodes(const TreeNode *left, const TreeNode *right) {
     return result;
 }
 
-int buildSegmentTree(const double *prices, size_t length, void **out_tree_handle,
-                     char *err_buf, size_t err_buf_len) {
+// Node statistics widened to double (float min/max convert exactly)
+static TreeNode loadNode(const SegmentTree *tree, size_t idx) {
+    if (tree->nodes) return tree->nodes[idx];
+    
+    const TreeNodeF32 *node = &tree->nodes_f32[idx];
+    TreeNode result;
+    result.min = node->min;
+    result.max = node->max;
+    result.sum = node->sum;
+    result.sum_sq = node->sum_sq;
+    result.count = node->count;
+    return result;
+}
+
+// Shared by both precisions: exactly one of prices / prices_f32 is used
+static int buildTreeHandle(const double *prices, const float *prices_f32, size_t length,
+                           void **out_tree_handle, char *err_buf, size_t err_buf_len) {
     // Validate inputs
-    if (!prices || !out_tree_handle) {
+    if ((!prices && !prices_f32) || !out_tree_handle) {
         setError(err_buf, err_buf_len, "NULL pointer argument");
         return -1;
     }
@@ -54,11 +65,11 @@ int buildSegmentTree(const double *prices, size_t length, void **out_tree_handle
     }
     
     // Validate prices
-    for (size_t i = 0; i < length; i++) {
-        if (isnan(prices[i]) || isinf(prices[i])) {
-            setError(err_buf, err_buf_len, "Invalid price value");
-            return -4;
-        }
+    int invalid = prices ? validatePrices(prices, length, NULL)
+                         : validatePricesF32(prices_f32, length, NULL);
+    if (invalid != 0) {
+        setError(err_buf, err_buf_len, "Invalid price value");
+        return -4;
     }
     
     // Allocate tree structure
@@ -71,34 +82,60 @@ int buildSegmentTree(const double *prices, size_t length, void **out_tree_handle
     tree->length = length;
     tree->tree_size = 2 * length;  // Bottom-up tree uses 2n nodes
     
-    tree->nodes = malloc(tree->tree_size * sizeof(TreeNode));
-    if (!tree->nodes) {
+    tree->nodes = NULL;
+    tree->nodes_f32 = NULL;
+    if (prices) {
+        tree->nodes = malloc(tree->tree_size * sizeof(TreeNode));
+    } else {
+        tree->nodes_f32 = malloc(tree->tree_size * sizeof(TreeNodeF32));
+    }
+    if (!tree->nodes && !tree->nodes_f32) {
         free(tree);
         setError(err_buf, err_buf_len, "Memory allocation failed for tree nodes");
         return -3;
     }
     
-    // Build tree bottom-up: O(n) construction
-    // Leaf nodes start at index 'length'
-    for (size_t i = 0; i < length; i++) {
-        size_t idx = length + i;
-        tree->nodes[idx].min = prices[i];
-        tree->nodes[idx].max = prices[i];
-        tree->nodes[idx].sum = prices[i];
-        tree->nodes[idx].sum_sq = prices[i] * prices[i];
-        tree->nodes[idx].count = 1;
-    }
-    
-    // Build internal nodes by merging children
-    for (size_t i = length - 1; i > 0; i--) {
-        tree->nodes[i] = mergeNodes(&tree->nodes[2*i], &tree->nodes[2*i + 1]);
+    // Build tree bottom-up: O(n) construction, built per ISA (see kernels.c)
+    if (prices) {
+        activeKernels()->buildTree(prices, length, tree->nodes);
+    } else {
+        activeKernels()->buildTreeF32(prices_f32, length, tree->nodes_f32);
     }
     
     *out_tree_handle = tree;
     return 0;
 }
 
-int querySegmentTree(void *tree_handle, size_t ql, size_t qr,
+// Counts a build; the tree's memory is what the caller receives
+static int recordBuild(uint64_t started, size_t length, void **out_tree_handle, int rc) {
+    size_t bytes = rc == 0 ? getSegmentTreeMemoryUsage(*out_tree_handle) : 0;
+    statsRecord(DSA_STAT_TREE_BUILD, started, length, bytes, rc);
+    return rc;
+}
+
+int buildSegmentTree(const double *prices, size_t length, void **out_tree_handle,
+                     char *err_buf, size_t err_buf_len) {
+    uint64_t started = statsStart();
+    if (!prices) {
+        setError(err_buf, err_buf_len, "NULL pointer argument");
+        return recordBuild(started, length, out_tree_handle, -1);
+    }
+    int rc = buildTreeHandle(prices, NULL, length, out_tree_handle, err_buf, err_buf_len);
+    return recordBuild(started, length, out_tree_handle, rc);
+}
+
+int buildSegmentTreeF32(const float *prices, size_t length, void **out_tree_handle,
+                        char *err_buf, size_t err_buf_len) {
+    uint64_t started = statsStart();
+    if (!prices) {
+        setError(err_buf, err_buf_len, "NULL pointer argument");
+        return recordBuild(started, length, out_tree_handle, -1);
+    }
+    int rc = buildTreeHandle(NULL, prices, length, out_tree_handle, err_buf, err_buf_len);
+    return recordBuild(started, length, out_tree_handle, rc);
+}
+
+static int queryTree(void *tree_handle, size_t ql, size_t qr,
                      double *out_min, double *out_max, double *out_avg,
                      double *out_variance, char *err_buf, size_t err_buf_len) {
     if (!tree_handle) {
@@ -132,22 +169,24 @@ int querySegmentTree(void *tree_handle, size_t ql, size_t qr,
     while (left <= right) {
         // If left is odd (right child), include it
         if (left % 2 == 1) {
+            TreeNode node = loadNode(tree, left);
             if (first) {
-                result = tree->nodes[left];
+                result = node;
                 first = 0;
             } else {
-                result = mergeNodes(&result, &tree->nodes[left]);
+                result = mergeNodes(&result, &node);
             }
             left++;
         }
         
         // If right is even (left child), include it
         if (right % 2 == 0) {
+            TreeNode node = loadNode(tree, right);
             if (first) {
-                result = tree->nodes[right];
+                result = node;
                 first = 0;
             } else {
-                result = mergeNodes(&result, &tree->nodes[right]);
+                result = mergeNodes(&result, &node);
             }
             right--;
         }
@@ -175,10 +214,33 @@ int querySegmentTree(void *tree_handle, size_t ql, size_t qr,
     return 0;
 }
 
+int querySegmentTree(void *tree_handle, size_t ql, size_t qr,
+                     double *out_min, double *out_max, double *out_avg,
+                     double *out_variance, char *err_buf, size_t err_buf_len) {
+    uint64_t started = statsStart();
+    int rc = queryTree(tree_handle, ql, qr, out_min, out_max, out_avg, out_variance,
+                       err_buf, err_buf_len);
+    statsRecord(DSA_STAT_TREE_QUERY, started, rc == 0 ? qr - ql + 1 : 0, 0, rc);
+    return rc;
+}
+
+size_t getSegmentTreeLength(const void *tree_handle) {
+    if (!tree_handle) return 0;
+    return ((const SegmentTree*)tree_handle)->length;
+}
+
+size_t getSegmentTreeMemoryUsage(const void *tree_handle) {
+    if (!tree_handle) return 0;
+    const SegmentTree *tree = (const SegmentTree*)tree_handle;
+    size_t node_size = tree->nodes ? sizeof(TreeNode) : sizeof(TreeNodeF32);
+    return sizeof(SegmentTree) + tree->tree_size * node_size;
+}
+
 void freeSegmentTree(void *tree_handle) {
     if (tree_handle) {
         SegmentTree *tree = (SegmentTree*)tree_handle;
         free(tree->nodes);
+        free(tree->nodes_f32);
         free(tree);
     }
 }
@@ -0,0 +1,77 @@
+#include "series_analysis.h"
+#include "kernels.h"
+#include "price_validation.h"
+#include "stats_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_ARRAY_SIZE 10000000
+
+static void setError(char *err_buf, size_t err_buf_len, const char *msg) {
+    if (err_buf && err_buf_len > 0) {
+        strncpy(err_buf, msg, err_buf_len - 1);
+        err_buf[err_buf_len - 1] = '\0';
+    }
+}
+
+static int analyzeFused(const double *prices, size_t length, size_t windowSize,
+                        int *out_spans, SeriesStats *out_stats,
+                        double *out_win_max, double *out_win_min, double *out_win_avg,
+                        unsigned char *out_win_pattern,
+                        char *err_buf, size_t err_buf_len) {
+    // Validate inputs
+    if (!prices) {
+        setError(err_buf, err_buf_len, "NULL pointer argument");
+        return -1;
+    }
+    
+    if (length == 0 || length > MAX_ARRAY_SIZE || windowSize > length) {
+        setError(err_buf, err_buf_len, "Invalid length or window size");
+        return -2;
+    }
+    
+    if (validatePrices(prices, length, NULL) != 0) {
+        setError(err_buf, err_buf_len, "Invalid price value (NaN or infinite)");
+        return -4;
+    }
+    
+    int want_spans = out_spans != NULL;
+    int want_windows = windowSize > 0 &&
+        (out_win_max || out_win_min || out_win_avg || out_win_pattern);
+    
+    // One scratch block: span stack, then max and min window deques
+    size_t stack_len = want_spans ? length : 0;
+    size_t ring_len = want_windows ? windowSize + 1 : 0;
+    size_t *scratch = NULL;
+    if (stack_len + ring_len > 0) {
+        scratch = malloc((stack_len + 2 * ring_len) * sizeof(size_t));
+        if (!scratch) {
+            setError(err_buf, err_buf_len, "Memory allocation failed for scratch buffer");
+            return -3;
+        }
+    }
+    
+    size_t *max_ring = want_windows ? scratch + stack_len : NULL;
+    size_t *min_ring = want_windows ? max_ring + ring_len : NULL;
+    SeriesOutputs out = {out_spans, out_stats, out_win_max, out_win_min, out_win_avg,
+                         out_win_pattern};
+    activeKernels()->seriesPass(prices, length, want_windows ? windowSize : 0, &out,
+                                want_spans ? scratch : NULL, max_ring, min_ring);
+    
+    free(scratch);
+    
+    return 0;
+}
+
+// Outputs are caller-allocated, so nothing counts as allocated
+int analyzeSeries(const double *prices, size_t length, size_t windowSize,
+                  int *out_spans, SeriesStats *out_stats,
+                  double *out_win_max, double *out_win_min, double *out_win_avg,
+                  unsigned char *out_win_pattern,
+                  char *err_buf, size_t err_buf_len) {
+    uint64_t started = statsStart();
+    int rc = analyzeFused(prices, length, windowSize, out_spans, out_stats, out_win_max,
+                          out_win_min, out_win_avg, out_win_pattern, err_buf, err_buf_len);
+    statsRecord(DSA_STAT_SERIES, started, length, 0, rc);
+    return rc;
+}
@@ -0,0 +1,36 @@
+/**
+ * Recording side of dsa_stats.h, for the instrumented entry points
+ *
+ * Usage:
+ *   uint64_t started = statsStart();
+ *   int rc = ...;
+ *   statsRecord(DSA_STAT_STOCK_SPAN, started, length, rc == 0 ? bytes : 0, rc);
+ */
+
+#ifndef STATS_INTERNAL_H
+#define STATS_INTERNAL_H
+
+#include "dsa_stats.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+extern atomic_int dsaStatsEnabled;
+
+/**
+ * Monotonic clock in nanoseconds (never 0)
+ */
+uint64_t statsNow(void);
+
+/**
+ * Start timing a call; 0 while collection is off
+ */
+static inline uint64_t statsStart(void) {
+    return atomic_load_explicit(&dsaStatsEnabled, memory_order_relaxed) ? statsNow() : 0;
+}
+
+/**
+ * Count a finished call; no-op if `started` is 0
+ */
+void statsRecord(DsaStatFunction fn, uint64_t started, size_t elements, size_t bytes, int rc);
+
+#endif // STATS_INTERNAL_H
@@ -1,4 +1,7 @@
 #include "stock_span.h"
+#include "price_validation.h"
+#include "kernels.h"
+#include "stats_internal.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -6,51 +9,6 @@
 
 #define MAX_ARRAY_SIZE 10000000  // 10M elements max
 
-// Stack node for tracking indices
-typedef struct {
-    size_t *data;
-    size_t top;
-    size_t capacity;
-} IndexStack;
-
-static IndexStack* createStack(size_t capacity) {
-    IndexStack *stack = malloc(sizeof(IndexStack));
-    if (!stack) return NULL;
-    
-    stack->data = malloc(capacity * sizeof(size_t));
-    if (!stack->data) {
-        free(stack);
-        return NULL;
-    }
-    
-    stack->top = 0;
-    stack->capacity = capacity;
-    return stack;
-}
-
-static void freeStack(IndexStack *stack) {
-    if (stack) {
-        free(stack->data);
-        free(stack);
-    }
-}
-
-static inline int isEmpty(const IndexStack *stack) {
-    return stack->top == 0;
-}
-
-static inline void push(IndexStack *stack, size_t value) {
-    stack->data[stack->top++] = value;
-}
-
-static inline size_t pop(IndexStack *stack) {
-    return stack->data[--stack->top];
-}
-
-static inline size_t peek(const IndexStack *stack) {
-    return stack->data[stack->top - 1];
-}
-
 static void setError(char *err_buf, size_t err_buf_len, const char *msg) {
     if (err_buf && err_buf_len > 0) {
         strncpy(err_buf, msg, err_buf_len - 1);
@@ -58,10 +16,11 @@ static void setError(char *err_buf, size_t err_buf_len, const char *msg) {
     }
 }
 
-int calculateStockSpan(const double *prices, size_t length, int **out_spans,
-                       char *err_buf, size_t err_buf_len) {
+// Shared by both precisions: exactly one of prices / prices_f32 is used
+static int computeSpans(const double *prices, const float *prices_f32, size_t length,
+                        int **out_spans, char *err_buf, size_t err_buf_len) {
     // Validate inputs
-    if (!prices || !out_spans) {
+    if (!out_spans) {
         setError(err_buf, err_buf_len, "NULL pointer argument");
         return -1;
     }
@@ -72,11 +31,11 @@ int calculateStockSpan(const double *prices, size_t length, int **out_spans,
     }
     
     // Validate price values
-    for (size_t i = 0; i < length; i++) {
-        if (isnan(prices[i]) || isinf(prices[i])) {
-            setError(err_buf, err_buf_len, "Invalid price value (NaN or infinite)");
-            return -4;
-        }
+    int invalid = prices ? validatePrices(prices, length, NULL)
+                         : validatePricesF32(prices_f32, length, NULL);
+    if (invalid != 0) {
+        setError(err_buf, err_buf_len, "Invalid price value (NaN or infinite)");
+        return -4;
     }
     
     // Allocate output array
@@ -86,8 +45,8 @@ int calculateStockSpan(const double *prices, size_t length, int **out_spans,
         return -3;
     }
     
-    // Create stack for indices
-    IndexStack *stack = createStack(length);
+    // Index stack for the scan; each element is pushed and popped at most once
+    size_t *stack = malloc(length * sizeof(size_t));
     if (!stack) {
         free(*out_spans);
         *out_spans = NULL;
@@ -95,23 +54,39 @@ int calculateStockSpan(const double *prices, size_t length, int **out_spans,
         return -3;
     }
     
-    // Calculate spans using stack-based algorithm - O(n) complexity
-    // Each element is pushed and popped at most once
-    for (size_t i = 0; i < length; i++) {
-        // Pop elements while stack is not empty and top element's price
-        // is less than or equal to current price
-        while (!isEmpty(stack) && prices[peek(stack)] <= prices[i]) {
-            pop(stack);
-        }
-        
-        // If stack is empty, span is i+1 (all previous elements)
-        // Otherwise, span is distance from current to top of stack
-        (*out_spans)[i] = isEmpty(stack) ? (int)(i + 1) : (int)(i - peek(stack));
-        
-        // Push current index
-        push(stack, i);
+    // Stack-based scan - O(n), built per ISA (see kernels.c)
+    if (prices) {
+        activeKernels()->stockSpan(prices, length, *out_spans, stack);
+    } else {
+        activeKernels()->stockSpanF32(prices_f32, length, *out_spans, stack);
     }
     
-    freeStack(stack);
+    free(stack);
     return 0;
 }
+
+int calculateStockSpan(const double *prices, size_t length, int **out_spans,
+                       char *err_buf, size_t err_buf_len) {
+    uint64_t started = statsStart();
+    int rc = -1;
+    if (!prices) {
+        setError(err_buf, err_buf_len, "NULL pointer argument");
+    } else {
+        rc = computeSpans(prices, NULL, length, out_spans, err_buf, err_buf_len);
+    }
+    statsRecord(DSA_STAT_STOCK_SPAN, started, length, rc == 0 ? length * sizeof(int) : 0, rc);
+    return rc;
+}
+
+int calculateStockSpanF32(const float *prices, size_t length, int **out_spans,
+                          char *err_buf, size_t err_buf_len) {
+    uint64_t started = statsStart();
+    int rc = -1;
+    if (!prices) {
+        setError(err_buf, err_buf_len, "NULL pointer argument");
+    } else {
+        rc = computeSpans(NULL, prices, length, out_spans, err_buf, err_buf_len);
+    }
+    statsRecord(DSA_STAT_STOCK_SPAN, started, length, rc == 0 ? length * sizeof(int) : 0, rc);
+    return rc;
+}
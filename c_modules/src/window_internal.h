@@ -0,0 +1,28 @@
+#ifndef WINDOW_INTERNAL_H
+#define WINDOW_INTERNAL_H
+
+/*
+ * Private helpers shared by the window kernels (kernels.c) and series_analysis.c.
+ * Not installed; not part of the public API.
+ */
+
+#include "sliding_window.h"
+#include <math.h>
+
+// Classify pattern based on statistics
+static inline unsigned char classifyWindowPattern(double first, double last,
+                                                  double variance, double mean) {
+    double change_pct = fabs((last - first) / first);
+    double cv = sqrt(variance) / fabs(mean);  // Coefficient of variation
+    
+    if (change_pct > 0.05 && last > first) {
+        return WINDOW_PATTERN_BULLISH;
+    } else if (change_pct > 0.05 && last < first) {
+        return WINDOW_PATTERN_BEARISH;
+    } else if (cv > 0.1) {
+        return WINDOW_PATTERN_VOLATILE;
+    }
+    return WINDOW_PATTERN_STABLE;
+}
+
+#endif // WINDOW_INTERNAL_H
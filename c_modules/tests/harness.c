@@ -5,7 +5,7 @@
  * NO HARDCODED DATA - all inputs must be provided via files.
  * 
  * Usage:
- *   ./harness <prices.csv>
+ *   ./harness <prices.csv> [chart-response.json ...]
  * 
  * CSV Format (one price per line or comma-separated):
  *   100.5
@@ -20,15 +20,41 @@
  *   - Stock span: Verify spans are positive and <= position+1
  *   - Segment tree: Verify query results match brute-force calculations
  *   - Sliding window: Verify min/max/avg are within bounds of input
+ *   - Fused series analysis: Verify it agrees with the three algorithms above
+ *   - Price validation: Verify non-finite values are found at any position
+ *   - Kernel variants: Verify every supported ISA variant gives identical results
+ *   - Float32 input: Verify the F32 entry points match the double ones on
+ *     the same (float-rounded) values
+ *   - Column store: Verify prices stored as a column survive a reopen, and
+ *     that overlapping appends, gaps and date lookups behave
+ *   - Chart parser: Verify a chart response built from the prices (with
+ *     nulls, skipped members and several number formats) parses to the
+ *     same values strtod() gives, and that malformed input is rejected
+ *   - Recorded chart responses (optional, any further arguments): Verify
+ *     provider responses saved with tests/record_chart.sh parse, compact to
+ *     complete rows and are rejected when truncated
+ *   - Statistics: Verify calls, errors, elements, bytes and histograms are
+ *     counted only while enabled, and that reset clears them
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "stock_span.h"
 #include "segment_tree.h"
 #include "sliding_window.h"
+#include "series_analysis.h"
+#include "price_validation.h"
+#include "cpu_dispatch.h"
+#include "column_store.h"
+#include "chart_parser.h"
+#include "dsa_stats.h"
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+#include <unistd.h>
 
 #define MAX_PRICES 1000000
 #define BUFFER_SIZE 4096
@@ -237,6 +263,28 @@ static int testSlidingWindow(const double *prices, size_t length) {
         }
     }
     
+    // Bulk columnar copy must agree with per-index reads
+    size_t copy_count = num_windows < 100 ? num_windows : 100;
+    double col_max[100], col_min[100], col_avg[100];
+    unsigned char col_pattern[100];
+    if (copyWindowResults(result, 0, copy_count, col_max, col_min, col_avg, col_pattern,
+                          err, sizeof(err)) != 0) {
+        fprintf(stderr, "ERROR: copyWindowResults failed: %s\n", err);
+        errors++;
+    } else {
+        for (size_t i = 0; i < copy_count; i++) {
+            double max, min, avg;
+            char pattern[64];
+            getWindowResult(result, i, &max, &min, &avg, pattern, sizeof(pattern), NULL, 0);
+            if (col_max[i] != max || col_min[i] != min || col_avg[i] != avg ||
+                strcmp(windowPatternName(col_pattern[i]), pattern) != 0) {
+                fprintf(stderr, "ERROR: Columnar copy mismatch at window %zu\n", i);
+                errors++;
+                break;
+            }
+        }
+    }
+    
     freeWindowResult(result);
     
     if (errors == 0) {
@@ -248,9 +296,997 @@ static int testSlidingWindow(const double *prices, size_t length) {
     }
 }
 
+// Test fused series analysis against the individual algorithms
+static int testSeriesAnalysis(const double *prices, size_t length) {
+    printf("\n=== Testing Fused Series Analysis ===\n");
+    
+    size_t window_size = length < 20 ? length / 2 : 10;
+    if (window_size == 0) window_size = 1;
+    size_t num_windows = length - window_size + 1;
+    char err[256];
+    
+    int *fused_spans = malloc(length * sizeof(int));
+    double *win_max = malloc(num_windows * sizeof(double));
+    double *win_min = malloc(num_windows * sizeof(double));
+    double *win_avg = malloc(num_windows * sizeof(double));
+    unsigned char *win_pattern = malloc(num_windows);
+    int *spans = NULL;
+    void *tree = NULL;
+    void *windows = NULL;
+    int errors = 0;
+    
+    if (!fused_spans || !win_max || !win_min || !win_avg || !win_pattern) {
+        fprintf(stderr, "ERROR: Allocation failed\n");
+        errors++;
+        goto cleanup;
+    }
+    
+    SeriesStats stats;
+    if (analyzeSeries(prices, length, window_size, fused_spans, &stats,
+                      win_max, win_min, win_avg, win_pattern, err, sizeof(err)) != 0) {
+        fprintf(stderr, "ERROR: analyzeSeries failed: %s\n", err);
+        errors++;
+        goto cleanup;
+    }
+    
+    if (calculateStockSpan(prices, length, &spans, err, sizeof(err)) != 0 ||
+        buildSegmentTree(prices, length, &tree, err, sizeof(err)) != 0 ||
+        analyzeSlidingWindow(prices, length, window_size, &windows, err, sizeof(err)) != 0) {
+        fprintf(stderr, "ERROR: Reference computation failed: %s\n", err);
+        errors++;
+        goto cleanup;
+    }
+    
+    // Spans must match exactly
+    for (size_t i = 0; i < length; i++) {
+        if (fused_spans[i] != spans[i]) {
+            fprintf(stderr, "ERROR: Span mismatch at %zu: %d vs %d\n", i, fused_spans[i], spans[i]);
+            errors++;
+            break;
+        }
+    }
+    
+    // Stats match the full-range tree query up to summation order
+    double t_min, t_max, t_avg, t_var;
+    querySegmentTree(tree, 0, length - 1, &t_min, &t_max, &t_avg, &t_var, err, sizeof(err));
+    if (stats.min != t_min || stats.max != t_max ||
+        fabs(stats.avg - t_avg) > 1e-6 * fabs(t_avg) ||
+        fabs(stats.variance - t_var) > 1e-6 * (fabs(t_var) + 1.0)) {
+        fprintf(stderr, "ERROR: Stats mismatch: fused avg=%.6f var=%.6f, tree avg=%.6f var=%.6f\n",
+                stats.avg, stats.variance, t_avg, t_var);
+        errors++;
+    }
+    
+    // Windows must be bit-identical to analyzeSlidingWindow
+    for (size_t i = 0; i < num_windows; i++) {
+        double max, min, avg;
+        unsigned char pattern;
+        copyWindowResults(windows, i, 1, &max, &min, &avg, &pattern, NULL, 0);
+        if (win_max[i] != max || win_min[i] != min || win_avg[i] != avg ||
+            win_pattern[i] != pattern) {
+            fprintf(stderr, "ERROR: Window mismatch at %zu\n", i);
+            errors++;
+            break;
+        }
+    }
+    
+cleanup:
+    free(fused_spans);
+    free(win_max);
+    free(win_min);
+    free(win_avg);
+    free(win_pattern);
+    free(spans);
+    freeSegmentTree(tree);
+    freeWindowResult(windows);
+    
+    if (errors == 0) {
+        printf("✓ Fused series analysis validation passed\n");
+        return 0;
+    } else {
+        printf("✗ Fused series analysis validation failed\n");
+        return -1;
+    }
+}
+
+// Test finite-price validation (block scan + tail)
+static int testPriceValidation(const double *prices, size_t length) {
+    printf("\n=== Testing Price Validation ===\n");
+    
+    int errors = 0;
+    size_t bad = 0;
+    
+    if (validatePrices(prices, length, &bad) != 0) {
+        fprintf(stderr, "ERROR: Input prices rejected at index %zu\n", bad);
+        return -1;
+    }
+    
+    double *copy = malloc(length * sizeof(double));
+    if (!copy) {
+        fprintf(stderr, "ERROR: Allocation failed\n");
+        return -1;
+    }
+    
+    // Poison one position at a time: first, inside a block, last
+    size_t positions[3] = {0, length / 2, length - 1};
+    double poison[2] = {NAN, INFINITY};
+    for (size_t p = 0; p < 3; p++) {
+        for (size_t k = 0; k < 2; k++) {
+            memcpy(copy, prices, length * sizeof(double));
+            copy[positions[p]] = k == 0 ? poison[k] : -poison[k];
+            if (validatePrices(copy, length, &bad) != -4 || bad != positions[p]) {
+                fprintf(stderr, "ERROR: Non-finite value at %zu not reported\n", positions[p]);
+                errors++;
+            }
+        }
+    }
+    
+    free(copy);
+    
+    if (errors == 0) {
+        printf("✓ Price validation passed\n");
+        return 0;
+    } else {
+        printf("✗ Price validation failed\n");
+        return -1;
+    }
+}
+
+// Outputs of every kernel for one ISA variant
+typedef struct {
+    int *spans;
+    double tree_stats[4];
+    double *win_max;
+    double *win_min;
+    double *win_avg;
+    unsigned char *win_pattern;
+} KernelOutputs;
+
+static void freeKernelOutputs(KernelOutputs *out) {
+    free(out->spans);
+    free(out->win_max);
+    free(out->win_min);
+    free(out->win_avg);
+    free(out->win_pattern);
+}
+
+static int runKernels(const double *prices, size_t length, size_t window_size,
+                      size_t num_windows, KernelOutputs *out) {
+    char err_buf[256];
+    void *tree = NULL;
+    void *windows = NULL;
+    
+    memset(out, 0, sizeof(*out));
+    out->win_max = malloc(num_windows * sizeof(double));
+    out->win_min = malloc(num_windows * sizeof(double));
+    out->win_avg = malloc(num_windows * sizeof(double));
+    out->win_pattern = malloc(num_windows);
+    if (!out->win_max || !out->win_min || !out->win_avg || !out->win_pattern) {
+        fprintf(stderr, "ERROR: Allocation failed\n");
+        return -1;
+    }
+    
+    if (calculateStockSpan(prices, length, &out->spans, err_buf, sizeof(err_buf)) != 0 ||
+        buildSegmentTree(prices, length, &tree, err_buf, sizeof(err_buf)) != 0) {
+        fprintf(stderr, "ERROR: %s\n", err_buf);
+        return -1;
+    }
+    
+    int ret = querySegmentTree(tree, 0, length - 1, &out->tree_stats[0], &out->tree_stats[1],
+                               &out->tree_stats[2], &out->tree_stats[3], err_buf, sizeof(err_buf));
+    freeSegmentTree(tree);
+    
+    if (ret == 0) ret = analyzeSlidingWindow(prices, length, window_size, &windows,
+                                             err_buf, sizeof(err_buf));
+    if (ret == 0) {
+        ret = copyWindowResults(windows, 0, num_windows, out->win_max, out->win_min,
+                                out->win_avg, out->win_pattern, err_buf, sizeof(err_buf));
+        freeWindowResult(windows);
+    }
+    if (ret != 0) {
+        fprintf(stderr, "ERROR: %s\n", err_buf);
+        return -1;
+    }
+    return 0;
+}
+
+static int testKernelVariants(const double *prices, size_t length) {
+    printf("\n=== Testing Kernel Variants ===\n");
+    
+    const char *variants[] = {"avx512", "avx2", "sse2", "generic"};
+    const char *initial = getActiveIsa();
+    size_t window_size = length < 20 ? length / 2 : 20;
+    if (window_size == 0) window_size = 1;
+    size_t num_windows = length - window_size + 1;
+    
+    printf("Active ISA: %s\n", initial);
+    
+    KernelOutputs ref;
+    if (runKernels(prices, length, window_size, num_windows, &ref) != 0) {
+        freeKernelOutputs(&ref);
+        return -1;
+    }
+    
+    int errors = 0;
+    for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); v++) {
+        if (!isIsaSupported(variants[v])) continue;
+        if (setActiveIsa(variants[v]) != 0) {
+            fprintf(stderr, "ERROR: Cannot select supported ISA %s\n", variants[v]);
+            errors++;
+            continue;
+        }
+        
+        KernelOutputs out;
+        if (runKernels(prices, length, window_size, num_windows, &out) != 0) {
+            errors++;
+        } else if (memcmp(out.spans, ref.spans, length * sizeof(int)) != 0 ||
+                   memcmp(out.tree_stats, ref.tree_stats, sizeof(ref.tree_stats)) != 0 ||
+                   memcmp(out.win_max, ref.win_max, num_windows * sizeof(double)) != 0 ||
+                   memcmp(out.win_min, ref.win_min, num_windows * sizeof(double)) != 0 ||
+                   memcmp(out.win_avg, ref.win_avg, num_windows * sizeof(double)) != 0 ||
+                   memcmp(out.win_pattern, ref.win_pattern, num_windows) != 0) {
+            fprintf(stderr, "ERROR: %s results differ from %s\n", variants[v], initial);
+            errors++;
+        } else {
+            printf("  %s: identical\n", variants[v]);
+        }
+        freeKernelOutputs(&out);
+    }
+    
+    if (setActiveIsa("no-such-isa") != -2) {
+        fprintf(stderr, "ERROR: Unknown ISA accepted\n");
+        errors++;
+    }
+    
+    setActiveIsa(initial);
+    freeKernelOutputs(&ref);
+    
+    if (errors == 0) {
+        printf("✓ Kernel variants passed\n");
+        return 0;
+    } else {
+        printf("✗ Kernel variants failed\n");
+        return -1;
+    }
+}
+
+static int testFloat32(const double *prices, size_t length) {
+    printf("\n=== Testing Float32 Input ===\n");
+    
+    char err_buf[256];
+    int errors = 0;
+    float *prices_f32 = malloc(length * sizeof(float));
+    double *widened = malloc(length * sizeof(double));
+    if (!prices_f32 || !widened) {
+        fprintf(stderr, "ERROR: Allocation failed\n");
+        free(prices_f32);
+        free(widened);
+        return -1;
+    }
+    
+    // Results must equal the double path on the rounded values
+    for (size_t i = 0; i < length; i++) {
+        prices_f32[i] = (float)prices[i];
+        widened[i] = prices_f32[i];
+    }
+    
+    if (validatePricesF32(prices_f32, length, NULL) != 0) {
+        fprintf(stderr, "ERROR: Float32 prices rejected\n");
+        errors++;
+    }
+    
+    // Spans
+    int *spans = NULL;
+    int *spans_f32 = NULL;
+    if (calculateStockSpan(widened, length, &spans, err_buf, sizeof(err_buf)) != 0 ||
+        calculateStockSpanF32(prices_f32, length, &spans_f32, err_buf, sizeof(err_buf)) != 0) {
+        fprintf(stderr, "ERROR: %s\n", err_buf);
+        errors++;
+    } else if (memcmp(spans, spans_f32, length * sizeof(int)) != 0) {
+        fprintf(stderr, "ERROR: Float32 spans differ\n");
+        errors++;
+    }
+    free(spans);
+    free(spans_f32);
+    
+    // Segment tree: whole range and a few subranges
+    void *tree = NULL;
+    void *tree_f32 = NULL;
+    if (buildSegmentTree(widened, length, &tree, err_buf, sizeof(err_buf)) != 0 ||
+        buildSegmentTreeF32(prices_f32, length, &tree_f32, err_buf, sizeof(err_buf)) != 0) {
+        fprintf(stderr, "ERROR: %s\n", err_buf);
+        errors++;
+    } else {
+        for (size_t start = 0; start < length; start += length / 4 + 1) {
+            double a[4], b[4];
+            querySegmentTree(tree, start, length - 1, &a[0], &a[1], &a[2], &a[3], NULL, 0);
+            querySegmentTree(tree_f32, start, length - 1, &b[0], &b[1], &b[2], &b[3], NULL, 0);
+            if (memcmp(a, b, sizeof(a)) != 0) {
+                fprintf(stderr, "ERROR: Float32 tree query [%zu, %zu] differs\n", start, length - 1);
+                errors++;
+            }
+        }
+        if (getSegmentTreeMemoryUsage(tree_f32) >= getSegmentTreeMemoryUsage(tree)) {
+            fprintf(stderr, "ERROR: Float32 tree is not smaller\n");
+            errors++;
+        }
+    }
+    freeSegmentTree(tree);
+    freeSegmentTree(tree_f32);
+    
+    // Sliding window
+    size_t window_size = length < 20 ? length / 2 : 20;
+    if (window_size == 0) window_size = 1;
+    size_t num_windows = length - window_size + 1;
+    double *stats = malloc(num_windows * 6 * sizeof(double));
+    unsigned char *patterns = malloc(num_windows * 2);
+    void *windows = NULL;
+    void *windows_f32 = NULL;
+    if (!stats || !patterns) {
+        fprintf(stderr, "ERROR: Allocation failed\n");
+        errors++;
+    } else if (analyzeSlidingWindow(widened, length, window_size, &windows,
+                                    err_buf, sizeof(err_buf)) != 0 ||
+               analyzeSlidingWindowF32(prices_f32, length, window_size, &windows_f32,
+                                       err_buf, sizeof(err_buf)) != 0) {
+        fprintf(stderr, "ERROR: %s\n", err_buf);
+        errors++;
+    } else {
+        double *a = stats;
+        double *b = stats + num_windows * 3;
+        copyWindowResults(windows, 0, num_windows, a, a + num_windows, a + 2 * num_windows,
+                          patterns, NULL, 0);
+        copyWindowResults(windows_f32, 0, num_windows, b, b + num_windows, b + 2 * num_windows,
+                          patterns + num_windows, NULL, 0);
+        if (memcmp(a, b, num_windows * 3 * sizeof(double)) != 0 ||
+            memcmp(patterns, patterns + num_windows, num_windows) != 0) {
+            fprintf(stderr, "ERROR: Float32 windows differ\n");
+            errors++;
+        }
+    }
+    freeWindowResult(windows);
+    freeWindowResult(windows_f32);
+    free(stats);
+    free(patterns);
+    
+    free(prices_f32);
+    free(widened);
+    
+    if (errors == 0) {
+        printf("✓ Float32 input passed\n");
+        return 0;
+    } else {
+        printf("✗ Float32 input failed\n");
+        return -1;
+    }
+}
+
+// Append rows [first, first + count) of the price series as a store range
+static int appendPriceRows(void *store, const double *dates, const double *prices,
+                           size_t first, size_t count, size_t *out_appended,
+                           char *err, size_t err_len) {
+    const double *columns[COLUMN_COUNT] = {
+        dates + first, prices + first, prices + first,
+        prices + first, prices + first, prices + first,
+    };
+    return appendColumnRows(store, columns, count, dates[first], dates[first + count - 1],
+                            out_appended, err, err_len);
+}
+
+static int testColumnStore(const double *prices, size_t length) {
+    printf("\n=== Testing Column Store ===\n");
+    
+    char dir[] = "/tmp/dsa_column_store_XXXXXX";
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "ERROR: Cannot create temporary directory\n");
+        return -1;
+    }
+    char store_dir[sizeof(dir) + 8];
+    snprintf(store_dir, sizeof(store_dir), "%s/store", dir);
+    
+    char err[256];
+    int errors = 0;
+    double *dates = malloc(length * sizeof(double));
+    if (!dates) {
+        fprintf(stderr, "ERROR: Allocation failed\n");
+        rmdir(dir);
+        return -1;
+    }
+    for (size_t i = 0; i < length; i++) {
+        dates[i] = (double)i * 86400000.0;  // Daily, epoch milliseconds
+    }
+    
+    // First half, then the rest with an overlapping prefix
+    size_t half = length / 2 + 1;
+    size_t overlap = half < 10 ? half : 10;
+    size_t appended = 0;
+    void *store = NULL;
+    if (openColumnStore(store_dir, &store, err, sizeof(err)) != 0 ||
+        appendPriceRows(store, dates, prices, 0, half, &appended, err, sizeof(err)) != 0) {
+        fprintf(stderr, "ERROR: %s\n", err);
+        errors++;
+    } else if (appended != half) {
+        fprintf(stderr, "ERROR: Appended %zu rows, expected %zu\n", appended, half);
+        errors++;
+    } else if (half < length &&
+               (appendPriceRows(store, dates, prices, half - overlap, length - half + overlap,
+                                &appended, err, sizeof(err)) != 0 ||
+                appended != length - half)) {
+        fprintf(stderr, "ERROR: Overlapping append wrote %zu rows, expected %zu\n",
+                appended, length - half);
+        errors++;
+    }
+    
+    // A range starting after the coverage would leave a gap
+    double gap_date = dates[length - 1] + 2 * 86400000.0;
+    const double *gap_columns[COLUMN_COUNT] = {
+        &gap_date, prices, prices, prices, prices, prices,
+    };
+    if (store && appendColumnRows(store, gap_columns, 1, gap_date, gap_date,
+                                  NULL, NULL, 0) != -2) {
+        fprintf(stderr, "ERROR: Append leaving a gap was accepted\n");
+        errors++;
+    }
+    closeColumnStore(store);
+    store = NULL;
+    
+    // Reopen and read everything back
+    const double *values = NULL;
+    void *mapping = NULL;
+    size_t first = 0, count = 0;
+    double start = 0, end = 0;
+    if (openColumnStore(store_dir, &store, err, sizeof(err)) != 0) {
+        fprintf(stderr, "ERROR: Reopen failed: %s\n", err);
+        errors++;
+    } else if (getColumnStoreRows(store) != length ||
+               getColumnStoreCoverage(store, &start, &end) != 1 ||
+               start != dates[0] || end != dates[length - 1]) {
+        fprintf(stderr, "ERROR: Reopened store has %zu rows, coverage [%.0f, %.0f]\n",
+                getColumnStoreRows(store), start, end);
+        errors++;
+    } else if (mapColumnRange(store, COLUMN_CLOSE, 0, length, &values, &mapping,
+                              err, sizeof(err)) != 0) {
+        fprintf(stderr, "ERROR: %s\n", err);
+        errors++;
+    } else if (memcmp(values, prices, length * sizeof(double)) != 0) {
+        fprintf(stderr, "ERROR: Stored prices differ\n");
+        errors++;
+    }
+    
+    // Date lookups, including bounds between rows and past either end
+    for (size_t i = 0; store && i < length; i += length / 7 + 1) {
+        size_t j = i + (length - i) / 3;
+        if (findColumnDateRange(store, dates[i] - 1, dates[j] + 1, &first, &count,
+                                err, sizeof(err)) != 0 ||
+            first != i || count != j - i + 1) {
+            fprintf(stderr, "ERROR: Date range for rows [%zu, %zu] gave first %zu, count %zu\n",
+                    i, j, first, count);
+            errors++;
+        }
+    }
+    if (store && (findColumnDateRange(store, gap_date, gap_date + 1, &first, &count,
+                                      NULL, 0) != 0 || count != 0)) {
+        fprintf(stderr, "ERROR: Date range past the end matched %zu rows\n", count);
+        errors++;
+    }
+    
+    // The mapping outlives the store
+    closeColumnStore(store);
+    if (values && memcmp(values, prices, length * sizeof(double)) != 0) {
+        fprintf(stderr, "ERROR: Mapping changed after close\n");
+        errors++;
+    }
+    releaseColumnMapping(mapping);
+    
+    static const char *const files[] = {
+        "header", "date.idx", "date.f64", "open.f64", "high.f64", "low.f64",
+        "close.f64", "volume.f64",
+    };
+    char path[sizeof(store_dir) + 16];
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        snprintf(path, sizeof(path), "%s/%s", store_dir, files[i]);
+        remove(path);
+    }
+    rmdir(store_dir);
+    rmdir(dir);
+    free(dates);
+    
+    if (errors == 0) {
+        printf("✓ Column store passed\n");
+        return 0;
+    } else {
+        printf("✗ Column store failed\n");
+        return -1;
+    }
+}
+
+// Growable text buffer for building a chart response
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+} TextBuffer;
+
+static int appendText(TextBuffer *buf, const char *fmt, ...) {
+    for (;;) {
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(buf->data + buf->len, buf->cap - buf->len, fmt, args);
+        va_end(args);
+        if (n < 0) return -1;
+        if ((size_t)n < buf->cap - buf->len) {
+            buf->len += (size_t)n;
+            return 0;
+        }
+        size_t cap = (buf->cap + (size_t)n + 1) * 2;
+        char *grown = realloc(buf->data, cap);
+        if (!grown) return -1;
+        buf->data = grown;
+        buf->cap = cap;
+    }
+}
+
+// Row policy of the generated response
+static int closeIsNull(size_t i) { return i % 11 == 5; }
+static int openIsNull(size_t i) { return i % 13 == 3; }
+
+// Text of field f for row i (NULL for null); volumes in several notations
+static const char *chartValueText(const double *prices, size_t length, size_t i, int f,
+                                  char *text, size_t text_len) {
+    double price = prices[i];
+    switch (f) {
+        case CHART_TIMESTAMP:
+            snprintf(text, text_len, "%zu", 52200 + i * 86400);
+            break;
+        case CHART_OPEN:
+            if (openIsNull(i)) return NULL;
+            snprintf(text, text_len, "%.6g", price);
+            break;
+        case CHART_HIGH:
+            snprintf(text, text_len, "%.17g", price * 1.01);
+            break;
+        case CHART_LOW:
+            snprintf(text, text_len, "%.2f", price * 0.99);
+            break;
+        case CHART_CLOSE:
+            if (closeIsNull(i)) return NULL;
+            snprintf(text, text_len, "%.17g", price);
+            break;
+        default:
+            if (i == length - 1) return NULL;  // Volume array is one short
+            snprintf(text, text_len, i % 5 == 0 ? "%.3e" : "%.0f", floor(fabs(price) * 1000));
+            break;
+    }
+    return text;
+}
+
+static int buildChartResponse(const double *prices, size_t length, TextBuffer *buf) {
+    static const char *const names[CHART_FIELD_COUNT] = {
+        "timestamp", "open", "high", "low", "close", "volume",
+    };
+    // Members the parser must skip: escapes, nesting, literals, a decoy key
+    int ok = appendText(buf, "{\"chart\": {\"result\": [{\"meta\": {\"symbol\": \"T\\\"\\\\X\", "
+                             "\"validRanges\": [\"1d\", [{\"close\": [1]}], true, null, -2.5e-3], "
+                             "\"timestamp\": {}}, \"timestamp\": [") == 0;
+    char text[64];
+    for (size_t i = 0; ok && i < length; i++) {
+        chartValueText(prices, length, i, CHART_TIMESTAMP, text, sizeof(text));
+        ok = appendText(buf, i ? ",%s" : "%s", text) == 0;
+    }
+    ok = ok && appendText(buf, "],\n \"indicators\": {\"quote\": [{") == 0;
+    for (int f = CHART_OPEN; ok && f < CHART_FIELD_COUNT; f++) {
+        ok = appendText(buf, "%s\"%s\": [", f == CHART_OPEN ? "" : ", ", names[f]) == 0;
+        size_t rows = f == CHART_VOLUME ? length - 1 : length;
+        for (size_t i = 0; ok && i < rows; i++) {
+            const char *value = chartValueText(prices, length, i, f, text, sizeof(text));
+            ok = appendText(buf, "%s%s", i ? ", " : "", value ? value : "null") == 0;
+        }
+        ok = ok && appendText(buf, "]") == 0;
+    }
+    ok = ok && appendText(buf, "}, {\"close\": [0]}], \"adjclose\": [{\"adjclose\": [1]}]}}, "
+                               "{\"timestamp\": [1]}], \"error\": null}}\n") == 0;
+    return ok ? 0 : -1;
+}
+
+static int testChartParser(const double *prices, size_t length) {
+    printf("\n=== Testing Chart Parser ===\n");
+    
+    TextBuffer buf = {NULL, 0, 0};
+    if (buildChartResponse(prices, length, &buf) != 0) {
+        fprintf(stderr, "ERROR: Allocation failed\n");
+        free(buf.data);
+        return -1;
+    }
+    
+    char err[256];
+    char text[64];
+    int errors = 0;
+    ChartColumns *chart = NULL;
+    clock_t begin = clock();
+    int result = parseChartColumns(buf.data, buf.len, &chart, err, sizeof(err));
+    double ms = (double)(clock() - begin) * 1000.0 / CLOCKS_PER_SEC;
+    
+    if (result != 0) {
+        fprintf(stderr, "ERROR: Parse failed (%d): %s\n", result, err);
+        errors++;
+    } else if (chart->rows != length) {
+        fprintf(stderr, "ERROR: Parsed %zu rows, expected %zu\n", chart->rows, length);
+        errors++;
+    } else {
+        printf("  Parsed %zu rows (%zu bytes) in %.3f ms\n", length, buf.len, ms);
+    }
+    
+    // Every value as strtod() reads the same text; nulls as NaN plus mask
+    for (size_t i = 0; errors == 0 && i < length; i++) {
+        for (int f = 0; f < CHART_FIELD_COUNT; f++) {
+            const char *value = chartValueText(prices, length, i, f, text, sizeof(text));
+            double got = chart->values[f][i];
+            int masked = (chart->nulls[i] >> f) & 1;
+            if (value ? (masked || got != strtod(value, NULL)) : (!masked || !isnan(got))) {
+                fprintf(stderr, "ERROR: Row %zu field %d: got %.17g (null mask %d), text %s\n",
+                        i, f, got, masked, value ? value : "null");
+                errors++;
+                break;
+            }
+        }
+    }
+    
+    // Rows without a close go; gaps take the close (open) or 0 (volume)
+    size_t expected_rows = 0;
+    for (size_t i = 0; i < length; i++) expected_rows += !closeIsNull(i);
+    if (errors == 0 && compactChartRows(chart) != expected_rows) {
+        fprintf(stderr, "ERROR: Compacted to %zu rows, expected %zu\n", chart->rows,
+                expected_rows);
+        errors++;
+    }
+    for (size_t i = 0, row = 0; errors == 0 && i < length; i++) {
+        if (closeIsNull(i)) continue;
+        double close = chart->values[CHART_CLOSE][row];
+        double open = chart->values[CHART_OPEN][row];
+        double volume = chart->values[CHART_VOLUME][row];
+        if (chart->values[CHART_TIMESTAMP][row] != (double)(52200 + i * 86400) ||
+            (openIsNull(i) && open != close) || (i == length - 1 && volume != 0.0)) {
+            fprintf(stderr, "ERROR: Compacted row %zu (input row %zu) not filled\n", row, i);
+            errors++;
+        }
+        row++;
+    }
+    freeChartColumns(chart);
+    
+    // Truncated responses are rejected wherever they end
+    size_t step = buf.len / 97 + 1;
+    for (size_t cut = 0; cut < buf.len - 1; cut += cut < 400 ? 1 : step) {
+        chart = NULL;
+        if (parseChartColumns(buf.data, cut, &chart, NULL, 0) != -4 || chart) {
+            fprintf(stderr, "ERROR: Response truncated to %zu bytes was accepted\n", cut);
+            freeChartColumns(chart);
+            errors++;
+            break;
+        }
+    }
+    
+    // Input ending right after a backslash ends inside a string (exact-size
+    // copies, so reading past the end shows up under SANITIZE=address)
+    static const char *const cut_escapes[] = {
+        "{\"chart\":{\"result\":[{\"x\":\"abc\\",
+        "{\"chart\":{\"result\":[{\"x\":\"abc\\\\\\",
+        "{\"chart\":{\"result\":[{\"x\":\"\\",
+    };
+    for (size_t i = 0; i < sizeof(cut_escapes) / sizeof(cut_escapes[0]); i++) {
+        size_t cut_len = strlen(cut_escapes[i]);
+        char *cut = malloc(cut_len);
+        if (!cut) {
+            errors++;
+            break;
+        }
+        memcpy(cut, cut_escapes[i], cut_len);
+        chart = NULL;
+        err[0] = '\0';
+        if (parseChartColumns(cut, cut_len, &chart, err, sizeof(err)) != -4 ||
+            !strstr(err, "Unterminated string")) {
+            fprintf(stderr, "ERROR: Input ending in an escape: %s\n", err);
+            freeChartColumns(chart);
+            errors++;
+        }
+        free(cut);
+    }
+    
+    // Rounding edge cases: ties, subnormals, extremes, long digit strings
+    static const char *const edge_values[] = {
+        "9007199254740993", "1.00000000000000011102230246251565404236316680908203125",
+        "5e-324", "1.7976931348623157e308", "-0.0", "123456789012345678901234567890",
+        "0.1", "2.2250738585072011e-308", "1e23", "8.589973e9",
+    };
+    const size_t edge_count = sizeof(edge_values) / sizeof(edge_values[0]);
+    TextBuffer edge = {NULL, 0, 0};
+    int ok = appendText(&edge, "{\"chart\":{\"result\":[{\"timestamp\":[") == 0;
+    for (size_t i = 0; ok && i < edge_count; i++) {
+        ok = appendText(&edge, i ? ",%s" : "%s", edge_values[i]) == 0;
+    }
+    ok = ok && appendText(&edge, "]}]}}") == 0;
+    chart = NULL;
+    if (!ok || parseChartColumns(edge.data, edge.len, &chart, err, sizeof(err)) != 0 ||
+        chart->rows != edge_count) {
+        fprintf(stderr, "ERROR: Edge case response failed: %s\n", err);
+        errors++;
+    }
+    for (size_t i = 0; chart && i < chart->rows; i++) {
+        double expected = strtod(edge_values[i], NULL);
+        double got = chart->values[CHART_TIMESTAMP][i];
+        if (memcmp(&got, &expected, sizeof(double)) != 0 || chart->nulls[i] != 0x3E) {
+            fprintf(stderr, "ERROR: %s parsed as %.17g\n", edge_values[i], got);
+            errors++;
+        }
+    }
+    freeChartColumns(chart);
+    free(edge.data);
+    
+    // An error response has no result
+    static const char error_response[] =
+        "{\"chart\":{\"result\":null,\"error\":{\"code\":\"Not Found\"}}}";
+    if (parseChartColumns(error_response, sizeof(error_response) - 1, &chart, err,
+                          sizeof(err)) != -4) {
+        fprintf(stderr, "ERROR: Error response was accepted\n");
+        freeChartColumns(chart);
+        errors++;
+    }
+    if (parseChartColumns(NULL, 1, &chart, NULL, 0) != -1) {
+        fprintf(stderr, "ERROR: NULL input was accepted\n");
+        errors++;
+    }
+    free(buf.data);
+    
+    if (errors == 0) {
+        printf("✓ Chart parser passed\n");
+        return 0;
+    } else {
+        printf("✗ Chart parser failed\n");
+        return -1;
+    }
+}
+
+// Read a whole file; NULL on failure
+static char *readWholeFile(const char *filename, size_t *out_len) {
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) return NULL;
+    
+    char *data = NULL;
+    size_t len = 0, cap = 0;
+    for (;;) {
+        if (len == cap) {
+            cap = cap ? cap * 2 : 65536;
+            char *grown = realloc(data, cap);
+            if (!grown) {
+                free(data);
+                fclose(fp);
+                return NULL;
+            }
+            data = grown;
+        }
+        size_t n = fread(data + len, 1, cap - len, fp);
+        if (n == 0) break;
+        len += n;
+    }
+    int failed = ferror(fp);
+    fclose(fp);
+    if (failed) {
+        free(data);
+        return NULL;
+    }
+    *out_len = len;
+    return data;
+}
+
+// Test recorded provider responses: they parse, timestamps increase, rows
+// are complete after compaction, and every truncation is rejected
+static int testRecordedCharts(char *const files[], int count) {
+    printf("\n=== Testing Recorded Chart Responses ===\n");
+    
+    int errors = 0;
+    char err[256];
+    for (int n = 0; n < count; n++) {
+        size_t len = 0;
+        char *data = readWholeFile(files[n], &len);
+        if (!data) {
+            fprintf(stderr, "ERROR: Cannot read file: %s\n", files[n]);
+            errors++;
+            continue;
+        }
+        
+        ChartColumns *chart = NULL;
+        if (parseChartColumns(data, len, &chart, err, sizeof(err)) != 0) {
+            fprintf(stderr, "ERROR: %s: %s\n", files[n], err);
+            free(data);
+            errors++;
+            continue;
+        }
+        
+        size_t parsed = chart->rows;
+        const double *ts = chart->values[CHART_TIMESTAMP];
+        for (size_t i = 1; i < parsed; i++) {
+            if (!(ts[i] > ts[i - 1])) {
+                fprintf(stderr, "ERROR: %s: timestamp %zu not increasing\n", files[n], i);
+                errors++;
+                break;
+            }
+        }
+        
+        size_t rows = compactChartRows(chart);
+        for (size_t i = 0; i < rows; i++) {
+            int complete = 1;
+            for (int f = 0; f < CHART_FIELD_COUNT; f++) {
+                complete = complete && isfinite(chart->values[f][i]);
+            }
+            if (!complete) {
+                fprintf(stderr, "ERROR: %s: compacted row %zu has a gap\n", files[n], i);
+                errors++;
+                break;
+            }
+        }
+        freeChartColumns(chart);
+        
+        // Trailing whitespace is not part of the document
+        size_t end = len;
+        while (end > 0 && (data[end - 1] == '\n' || data[end - 1] == '\r' ||
+                           data[end - 1] == ' ' || data[end - 1] == '\t')) {
+            end--;
+        }
+        size_t step = end / 97 + 1;
+        for (size_t cut = 0; cut < end; cut += cut < 400 ? 1 : step) {
+            chart = NULL;
+            if (parseChartColumns(data, cut, &chart, NULL, 0) != -4 || chart) {
+                fprintf(stderr, "ERROR: %s truncated to %zu bytes was accepted\n",
+                        files[n], cut);
+                freeChartColumns(chart);
+                errors++;
+                break;
+            }
+        }
+        
+        printf("  %s: %zu rows, %zu after compaction\n", files[n], parsed, rows);
+        free(data);
+    }
+    
+    if (errors == 0) {
+        printf("✓ Recorded chart responses passed\n");
+        return 0;
+    } else {
+        printf("✗ Recorded chart responses failed\n");
+        return -1;
+    }
+}
+
+static uint64_t histogramTotal(const DsaFunctionStats *f) {
+    uint64_t total = 0;
+    for (size_t b = 0; b < DSA_STAT_BUCKETS; b++) total += f->histogram[b];
+    return total;
+}
+
+static int testStats(const double *prices, size_t length) {
+    printf("\n=== Testing Statistics ===\n");
+    
+    int errors = 0;
+    int was_enabled = isDsaStatsEnabled();
+    char err[256];
+    DsaStats *stats = malloc(sizeof(DsaStats));
+    if (!stats) {
+        fprintf(stderr, "ERROR: Allocation failed\n");
+        return -1;
+    }
+    
+    // Nothing is counted while disabled
+    setDsaStatsEnabled(0);
+    resetDsaStats();
+    int *spans = NULL;
+    calculateStockSpan(prices, length, &spans, err, sizeof(err));
+    free(spans);
+    getDsaStats(stats);
+    if (stats->enabled || stats->functions[DSA_STAT_STOCK_SPAN].calls != 0) {
+        fprintf(stderr, "ERROR: Call counted while statistics were disabled\n");
+        errors++;
+    }
+    
+    setDsaStatsEnabled(1);
+    
+    // One success, one failure
+    spans = NULL;
+    calculateStockSpan(prices, length, &spans, err, sizeof(err));
+    free(spans);
+    calculateStockSpan(NULL, length, &spans, err, sizeof(err));
+    
+    void *tree = NULL;
+    size_t query_elements = 0;
+    if (buildSegmentTree(prices, length, &tree, err, sizeof(err)) == 0) {
+        double min, max, avg;
+        querySegmentTree(tree, 0, length - 1, &min, &max, &avg, NULL, err, sizeof(err));
+        querySegmentTree(tree, length / 2, length / 2, &min, &max, &avg, NULL, err, sizeof(err));
+        querySegmentTree(tree, length, length, &min, &max, &avg, NULL, err, sizeof(err));
+        query_elements = length + 1;
+    }
+    size_t tree_bytes = getSegmentTreeMemoryUsage(tree);
+    freeSegmentTree(tree);
+    
+    void *windows = NULL;
+    size_t window_bytes = 0;
+    if (analyzeSlidingWindow(prices, length, 1, &windows, err, sizeof(err)) == 0) {
+        window_bytes = getWindowResultMemoryUsage(windows);
+        freeWindowResult(windows);
+    }
+    
+    getDsaStats(stats);
+    const DsaFunctionStats *span = &stats->functions[DSA_STAT_STOCK_SPAN];
+    const DsaFunctionStats *build = &stats->functions[DSA_STAT_TREE_BUILD];
+    const DsaFunctionStats *query = &stats->functions[DSA_STAT_TREE_QUERY];
+    const DsaFunctionStats *window = &stats->functions[DSA_STAT_SLIDING_WINDOW];
+    
+    if (!stats->enabled || span->calls != 2 || span->errors != 1 ||
+        span->elements != 2 * length || span->bytes_allocated != length * sizeof(int) ||
+        histogramTotal(span) != 2) {
+        fprintf(stderr, "ERROR: Stock span counters wrong (calls %llu, errors %llu)\n",
+                (unsigned long long)span->calls, (unsigned long long)span->errors);
+        errors++;
+    }
+    if (build->calls != 1 || build->bytes_allocated != tree_bytes ||
+        query->calls != 3 || query->errors != 1 || query->elements != query_elements ||
+        histogramTotal(query) != 3) {
+        fprintf(stderr, "ERROR: Segment tree counters wrong (queries %llu, elements %llu)\n",
+                (unsigned long long)query->calls, (unsigned long long)query->elements);
+        errors++;
+    }
+    if (window->calls != 1 || window->bytes_allocated != window_bytes) {
+        fprintf(stderr, "ERROR: Sliding window counters wrong\n");
+        errors++;
+    }
+    if (stats->functions[DSA_STAT_SERIES].calls != 0) {
+        fprintf(stderr, "ERROR: Uncalled function has counts\n");
+        errors++;
+    }
+    
+    // Bucket bounds increase; every function has a name
+    for (size_t b = 1; b < DSA_STAT_BUCKETS; b++) {
+        if (getDsaStatBucketBound(b) <= getDsaStatBucketBound(b - 1)) {
+            fprintf(stderr, "ERROR: Histogram bucket %zu bound not increasing\n", b);
+            errors++;
+            break;
+        }
+    }
+    if (getDsaStatBucketBound(DSA_STAT_BUCKETS - 1) != UINT64_MAX) {
+        fprintf(stderr, "ERROR: Last histogram bucket is bounded\n");
+        errors++;
+    }
+    for (int f = 0; f < DSA_STAT_COUNT; f++) {
+        if (!getDsaStatName(f)) {
+            fprintf(stderr, "ERROR: Function %d has no name\n", f);
+            errors++;
+        }
+    }
+    if (getDsaStatName(DSA_STAT_COUNT) != NULL) {
+        fprintf(stderr, "ERROR: Out-of-range function has a name\n");
+        errors++;
+    }
+    
+    resetDsaStats();
+    getDsaStats(stats);
+    if (stats->functions[DSA_STAT_STOCK_SPAN].calls != 0 || histogramTotal(span) != 0) {
+        fprintf(stderr, "ERROR: Reset left counts behind\n");
+        errors++;
+    }
+    
+    setDsaStatsEnabled(was_enabled);
+    free(stats);
+    
+    if (errors == 0) {
+        printf("✓ Statistics passed\n");
+        return 0;
+    } else {
+        printf("✗ Statistics failed\n");
+        return -1;
+    }
+}
+
 int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <prices.csv>\n", argv[0]);
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <prices.csv> [chart-response.json ...]\n", argv[0]);
         fprintf(stderr, "\nCSV format: one price per line or comma-separated\n");
         fprintf(stderr, "Example: 100.5,102.3,99.8,103.1\n");
         return 1;
@@ -276,6 +1312,14 @@ int main(int argc, char *argv[]) {
     if (testStockSpan(prices, length) != 0) failures++;
     if (testSegmentTree(prices, length) != 0) failures++;
     if (testSlidingWindow(prices, length) != 0) failures++;
+    if (testSeriesAnalysis(prices, length) != 0) failures++;
+    if (testPriceValidation(prices, length) != 0) failures++;
+    if (testKernelVariants(prices, length) != 0) failures++;
+    if (testFloat32(prices, length) != 0) failures++;
+    if (testColumnStore(prices, length) != 0) failures++;
+    if (testChartParser(prices, length) != 0) failures++;
+    if (testStats(prices, length) != 0) failures++;
+    if (argc > 2 && testRecordedCharts(argv + 2, argc - 2) != 0) failures++;
     
     free(prices);
     
@@ -0,0 +1,26 @@
+#!/bin/bash
+
+# record_chart.sh
+# Saves a raw Yahoo Finance v8 chart response for the harness's recorded
+# response tests. Requires curl and GNU date.
+#
+# Usage: tests/record_chart.sh <symbol> <start YYYY-MM-DD> <end YYYY-MM-DD> [out.json]
+# Then:  LD_LIBRARY_PATH=./lib ./tests/harness prices.csv out.json
+
+set -e
+
+if [ $# -lt 3 ]; then
+    echo "Usage: $0 <symbol> <start YYYY-MM-DD> <end YYYY-MM-DD> [out.json]" >&2
+    exit 1
+fi
+
+symbol="$1"
+period1=$(date -u -d "$2" +%s)
+# period2 is exclusive: add a day so the end date's bar is included
+period2=$(( $(date -u -d "$3" +%s) + 86400 ))
+out="${4:-tests/responses/${symbol}_$2_$3.json}"
+
+mkdir -p "$(dirname "$out")"
+curl -sSf -A "DSA-Backend/1.0" -o "$out" \
+    "https://query1.finance.yahoo.com/v8/finance/chart/${symbol}?period1=${period1}&period2=${period2}&interval=1d&events=history"
+echo "Saved $out ($(wc -c < "$out") bytes)"